@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "bench_corpus.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace oceanbase {
+namespace thai {
+
+static const char CORPUS_MAGIC[8] = {'T', 'H', 'C', 'O', 'R', 'P', 'U', 'S'};
+static const uint32_t CORPUS_VERSION = 1;
+static const int64_t RECENT_DOCS = 1024;      // 重复文档从最近的这些文档中挑选
+
+// rank 从 1 开始，权重 1/rank^s 的累积分布
+static void build_zipf_cdf(int64_t n, double s, std::vector<double> &cdf)
+{
+  cdf.resize(n);
+  double sum = 0;
+  for (int64_t i = 0; i < n; i++) {
+    sum += 1.0 / pow((double)(i + 1), s);
+    cdf[i] = sum;
+  }
+  for (int64_t i = 0; i < n; i++) {
+    cdf[i] /= sum;
+  }
+}
+
+ObBenchCorpusWriter::ObBenchCorpusWriter(const ObBenchCorpusOptions &opts, const std::vector<std::string> *words)
+  : opts_(opts), gen_(opts.seed_)
+{
+  if (nullptr != words) {
+    for (size_t i = 0; i < words->size(); i++) {
+      const std::string &word = (*words)[i];
+      if (!word.empty()) {
+        ((unsigned char)word[0] >= 0x80 ? thai_words_ : latin_words_).push_back(word);
+      }
+    }
+  }
+  const char *const *builtin = nullptr;
+  int64_t count = 0;
+  if (thai_words_.empty()) {
+    get_bench_words(OB_BENCH_SCRIPT_THAI, builtin, count);
+    thai_words_.assign(builtin, builtin + count);
+  }
+  if (latin_words_.empty()) {
+    get_bench_words(OB_BENCH_SCRIPT_ENGLISH, builtin, count);
+    latin_words_.assign(builtin, builtin + count);
+  }
+  build_zipf_cdf((int64_t)thai_words_.size(), opts_.zipf_s_, thai_cdf_);
+  build_zipf_cdf((int64_t)latin_words_.size(), opts_.zipf_s_, latin_cdf_);
+}
+
+const std::string &ObBenchCorpusWriter::pick_word(const std::vector<std::string> &words,
+                                                  const std::vector<double> &cdf)
+{
+  const size_t idx = std::lower_bound(cdf.begin(), cdf.end(), uniform01()) - cdf.begin();
+  return words[idx < words.size() ? idx : words.size() - 1];
+}
+
+int64_t ObBenchCorpusWriter::pick_size()
+{
+  // Box-Muller 得到标准正态分布，再换成对数正态
+  const double u1 = 1.0 - uniform01();
+  const double u2 = uniform01();
+  const double z = sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+  const double bytes = exp(log((double)opts_.median_bytes_) + opts_.size_sigma_ * z);
+  int64_t size = (int64_t)bytes;
+  size = size < opts_.min_bytes_ ? opts_.min_bytes_ : size;
+  return size > opts_.max_bytes_ ? opts_.max_bytes_ : size;
+}
+
+void ObBenchCorpusWriter::generate(std::string &doc, std::string *gold)
+{
+  const int64_t target = pick_size();
+  const int64_t span = opts_.phrase_max_words_ - opts_.phrase_min_words_ + 1;
+  doc.clear();
+  if (nullptr != gold) {
+    gold->clear();
+  }
+  std::string phrase;
+  std::string phrase_gold;
+  while ((int64_t)doc.size() < target) {
+    // 泰文短语内的词连写，拉丁文短语内的词用空格分隔，短语之间用空格
+    const bool latin = uniform01() < opts_.latin_ratio_;
+    const int64_t words = opts_.phrase_min_words_ + (span > 0 ? (int64_t)gen_.uniform(span) : 0);
+    phrase.clear();
+    phrase_gold.clear();
+    for (int64_t i = 0; i < words; i++) {
+      const std::string &word = latin ? pick_word(latin_words_, latin_cdf_) : pick_word(thai_words_, thai_cdf_);
+      if (i > 0) {
+        phrase += latin ? " " : "";
+        phrase_gold += latin ? "| |" : "|";
+      }
+      phrase += word;
+      phrase_gold += word;
+    }
+    if (uniform01() < opts_.digit_ratio_) {
+      const std::string number = std::to_string(gen_.uniform(100000));
+      phrase += " " + number;
+      phrase_gold += "| |" + number;
+    }
+    if (!doc.empty() && (int64_t)(doc.size() + 1 + phrase.size()) > target) {
+      break;
+    }
+    if (!doc.empty()) {
+      doc.push_back(' ');
+      if (nullptr != gold) {
+        *gold += "| |";
+      }
+    }
+    doc += phrase;
+    if (nullptr != gold) {
+      *gold += phrase_gold;
+    }
+  }
+}
+
+bool ObBenchCorpusWriter::write(const char *path, const char *gold_path)
+{
+  FILE *fp = fopen(path, "wb");
+  FILE *gold_fp = nullptr;
+  if (nullptr != fp && nullptr != gold_path && nullptr == (gold_fp = fopen(gold_path, "w"))) {
+    fclose(fp);
+    fp = nullptr;
+  }
+  if (nullptr == fp) {
+    return false;
+  }
+  ObBenchCorpusHeader header;
+  memset(&header, 0, sizeof(header));
+  bool ok = 1 == fwrite(&header, sizeof(header), 1, fp);
+
+  std::vector<uint64_t> offsets;
+  offsets.reserve(opts_.doc_count_ + 1);
+  std::vector<std::string> recent(RECENT_DOCS);
+  std::vector<std::string> recent_gold(nullptr != gold_fp ? RECENT_DOCS : 0);
+  int64_t recent_count = 0;
+  uint64_t offset = sizeof(header);
+  std::string doc;
+  std::string gold;
+  for (int64_t i = 0; ok && i < opts_.doc_count_; i++) {
+    if (recent_count > 0 && uniform01() < opts_.duplicate_ratio_) {
+      const int64_t n = recent_count < RECENT_DOCS ? recent_count : RECENT_DOCS;
+      const int64_t idx = (int64_t)gen_.uniform(n);
+      doc = recent[idx];
+      if (nullptr != gold_fp) {
+        gold = recent_gold[idx];
+      }
+    } else {
+      generate(doc, nullptr != gold_fp ? &gold : nullptr);
+    }
+    if (nullptr != gold_fp) {
+      recent_gold[recent_count % RECENT_DOCS] = gold;
+      ok = gold.size() == fwrite(gold.data(), 1, gold.size(), gold_fp) && EOF != fputc('\n', gold_fp);
+    }
+    recent[recent_count++ % RECENT_DOCS] = doc;
+    offsets.push_back(offset);
+    ok = ok && doc.size() == fwrite(doc.data(), 1, doc.size(), fp);
+    offset += doc.size();
+  }
+  offsets.push_back(offset);
+
+  // 索引按 8 字节对齐，映射后可以直接当数组用
+  const uint64_t padding = (8 - offset % 8) % 8;
+  const char zeros[8] = {0};
+  ok = ok && padding == fwrite(zeros, 1, padding, fp);
+  memcpy(header.magic_, CORPUS_MAGIC, sizeof(CORPUS_MAGIC));
+  header.version_ = CORPUS_VERSION;
+  header.doc_count_ = (uint64_t)opts_.doc_count_;
+  header.data_bytes_ = offset - sizeof(header);
+  header.index_offset_ = offset + padding;
+  header.seed_ = opts_.seed_;
+  ok = ok && offsets.size() == fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), fp);
+  ok = ok && 0 == fseek(fp, 0, SEEK_SET) && 1 == fwrite(&header, sizeof(header), 1, fp);
+  ok = (0 == fclose(fp)) && ok;
+  if (nullptr != gold_fp) {
+    ok = (0 == fclose(gold_fp)) && ok;
+  }
+  return ok;
+}
+
+bool ObBenchCorpus::open(const char *path, std::string &err)
+{
+  close();
+  const int fd = ::open(path, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || 0 != fstat(fd, &st)) {
+    err = "cannot open file";
+  } else if ((uint64_t)st.st_size < sizeof(ObBenchCorpusHeader)) {
+    err = "file too small";
+  } else {
+    void *addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == addr) {
+      err = "mmap failed";
+    } else {
+      base_ = (const char *)addr;
+      size_ = (uint64_t)st.st_size;
+      madvise(addr, (size_t)size_, MADV_SEQUENTIAL);
+      const ObBenchCorpusHeader *header = (const ObBenchCorpusHeader *)base_;
+      const uint64_t index_bytes = (header->doc_count_ + 1) * sizeof(uint64_t);
+      if (0 != memcmp(header->magic_, CORPUS_MAGIC, sizeof(CORPUS_MAGIC))) {
+        err = "not a corpus file";
+      } else if (CORPUS_VERSION != header->version_) {
+        err = "unsupported corpus version";
+      } else if (0 != header->index_offset_ % 8 || header->index_offset_ > size_
+                 || index_bytes > size_ - header->index_offset_ || header->doc_count_ > size_) {
+        err = "corrupt corpus index";
+      } else {
+        header_ = header;
+        offsets_ = (const uint64_t *)(base_ + header->index_offset_);
+        // 偏移必须单调且落在数据区内，之后 doc() 不再检查
+        for (uint64_t i = 0; i <= header->doc_count_ && nullptr != header_; i++) {
+          if (offsets_[i] < sizeof(ObBenchCorpusHeader) || offsets_[i] > header->index_offset_
+              || (i > 0 && offsets_[i] < offsets_[i - 1])) {
+            err = "corrupt corpus index";
+            header_ = nullptr;
+          }
+        }
+      }
+    }
+  }
+  if (fd >= 0) {
+    ::close(fd);
+  }
+  if (nullptr == header_) {
+    close();
+  }
+  return nullptr != header_;
+}
+
+void ObBenchCorpus::close()
+{
+  if (nullptr != base_) {
+    munmap((void *)base_, (size_t)size_);
+  }
+  base_ = nullptr;
+  size_ = 0;
+  header_ = nullptr;
+  offsets_ = nullptr;
+}
+
+bool bench_read_word_list(const char *path, std::vector<std::string> &words)
+{
+  FILE *fp = fopen(path, "r");
+  if (nullptr == fp) {
+    return false;
+  }
+  char line[1024];
+  while (nullptr != fgets(line, sizeof(line), fp)) {
+    size_t len = strlen(line);
+    while (len > 0 && ('\n' == line[len - 1] || '\r' == line[len - 1] || ' ' == line[len - 1])) {
+      len--;
+    }
+    if (len > 0 && '#' != line[0]) {
+      words.push_back(std::string(line, len));
+    }
+  }
+  fclose(fp);
+  return true;
+}
+
+} // namespace thai
+} // namespace oceanbase
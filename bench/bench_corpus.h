@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_BENCH_CORPUS_H_
+#define OB_THAI_BENCH_CORPUS_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "bench_text.h"
+
+/**
+ * @defgroup ObBenchCorpus Synthetic benchmark corpus
+ * @brief Seeded generator of realistic Thai/mixed corpora and the file
+ * format benchmarks read them from.
+ * @details File layout, integers in host byte order:
+ *   header (64 bytes) | documents back to back | padding to 8 |
+ *   uint64 offsets[doc_count + 1]
+ * Document i is [offsets[i], offsets[i + 1]) counted from the file start.
+ * The reader maps the file and hands out pointers into the mapping, so
+ * streaming a corpus costs no parsing and no copies.
+ * @{
+ */
+
+namespace oceanbase {
+namespace thai {
+
+struct ObBenchCorpusHeader
+{
+  char     magic_[8];          // "THCORPUS"
+  uint32_t version_;
+  uint32_t flags_;
+  uint64_t doc_count_;
+  uint64_t data_bytes_;
+  uint64_t index_offset_;
+  uint64_t seed_;
+  uint64_t reserved_[2];
+};
+
+static_assert(64 == sizeof(ObBenchCorpusHeader), "corpus header must stay 64 bytes");
+
+/// 生成参数，默认值接近线上商品标题和描述的分布
+struct ObBenchCorpusOptions
+{
+  uint64_t seed_ = 42;
+  int64_t  doc_count_ = 10000;
+  double   zipf_s_ = 1.0;             // 词频的 Zipf 指数，0 为均匀分布
+  int64_t  phrase_min_words_ = 1;
+  int64_t  phrase_max_words_ = 6;
+  double   latin_ratio_ = 0.2;        // 拉丁文短语占比
+  double   digit_ratio_ = 0.05;       // 每个短语后插入数字的概率
+  double   duplicate_ratio_ = 0.05;   // 复制近期文档的概率
+  int64_t  median_bytes_ = 400;       // 文档长度服从对数正态分布
+  double   size_sigma_ = 1.0;
+  int64_t  min_bytes_ = 8;
+  int64_t  max_bytes_ = 64 * 1024;
+};
+
+/**
+ * @brief Writes a corpus file from options and a word list.
+ * @details Words are ranked by their order in the list, the first being
+ * the most frequent. Words starting with a non ASCII byte are Thai, the
+ * others Latin.
+ */
+class ObBenchCorpusWriter final
+{
+public:
+  /// @param words nullptr uses the built-in word lists of bench_text
+  ObBenchCorpusWriter(const ObBenchCorpusOptions &opts, const std::vector<std::string> *words);
+
+  /**
+   * 生成语料并写入 path，返回是否成功
+   * @param gold_path 非空时同时写出标注：每行一篇文档，词之间用 '|' 分隔
+   */
+  bool write(const char *path, const char *gold_path = nullptr);
+
+  /// 生成单篇文档，gold 非空时输出带 '|' 分隔的标注
+  void generate(std::string &doc, std::string *gold = nullptr);
+
+private:
+  int64_t pick_size();
+  const std::string &pick_word(const std::vector<std::string> &words, const std::vector<double> &cdf);
+  double uniform01() { return (double)(gen_.next() >> 11) * (1.0 / 9007199254740992.0); }
+
+  ObBenchCorpusOptions     opts_;
+  ObBenchTextGen           gen_;
+  std::vector<std::string> thai_words_;
+  std::vector<std::string> latin_words_;
+  std::vector<double>      thai_cdf_;
+  std::vector<double>      latin_cdf_;
+};
+
+/**
+ * @brief Read only view of a corpus file.
+ * @details Not copyable. Pointers returned by doc() stay valid until
+ * close(); documents are not NUL terminated.
+ */
+class ObBenchCorpus final
+{
+public:
+  ObBenchCorpus() = default;
+  ~ObBenchCorpus() { close(); }
+  ObBenchCorpus(const ObBenchCorpus &) = delete;
+  ObBenchCorpus &operator=(const ObBenchCorpus &) = delete;
+
+  /// mmap 并校验文件，失败时 err 给出原因
+  bool open(const char *path, std::string &err);
+  void close();
+
+  int64_t count() const { return nullptr == header_ ? 0 : (int64_t)header_->doc_count_; }
+  int64_t data_bytes() const { return nullptr == header_ ? 0 : (int64_t)header_->data_bytes_; }
+  uint64_t seed() const { return nullptr == header_ ? 0 : header_->seed_; }
+  const char *doc(int64_t idx, int64_t &len) const
+  {
+    len = (int64_t)(offsets_[idx + 1] - offsets_[idx]);
+    return base_ + offsets_[idx];
+  }
+
+private:
+  const char *                base_ = nullptr;
+  uint64_t                    size_ = 0;
+  const ObBenchCorpusHeader * header_ = nullptr;
+  const uint64_t *            offsets_ = nullptr;
+};
+
+/// 读取词表文件，每行一个词，跳过空行和 # 开头的行
+bool bench_read_word_list(const char *path, std::vector<std::string> &words);
+
+} // namespace thai
+} // namespace oceanbase
+
+/** @} */
+
+#endif // OB_THAI_BENCH_CORPUS_H_
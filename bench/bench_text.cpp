@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "bench_text.h"
+
+#include <string.h>
+
+namespace oceanbase {
+namespace thai {
+
+static const char *SCRIPT_NAMES[OB_BENCH_SCRIPT_MAX] = {
+  "thai",
+  "english",
+  "mixed",
+};
+
+const ObBenchShape BENCH_SHAPES[] = {
+  {"query", 20},
+  {"title", 200},
+  {"description", 5 * 1024},
+  {"article", 1024 * 1024},
+};
+const int64_t BENCH_SHAPE_COUNT = sizeof(BENCH_SHAPES) / sizeof(BENCH_SHAPES[0]);
+
+// 常用泰文词
+static const char *THAI_WORDS[] = {
+  "การ", "ที่", "และ", "ของ", "ใน", "ได้", "เป็น", "มี", "ไม่", "ให้",
+  "จะ", "ว่า", "กับ", "คน", "นี้", "แล้ว", "ไป", "มา", "อยู่", "ต้อง",
+  "ประเทศ", "ไทย", "ภาษา", "ข้อมูล", "ระบบ", "ฐานข้อมูล", "ค้นหา", "เอกสาร", "ผู้ใช้", "บริษัท",
+  "ราคา", "สินค้า", "บริการ", "ลูกค้า", "โรงเรียน", "มหาวิทยาลัย", "กรุงเทพ", "รัฐบาล", "เศรษฐกิจ", "การศึกษา",
+  "สวัสดี", "ขอบคุณ", "ความ", "สำคัญ", "พัฒนา", "เทคโนโลยี", "คอมพิวเตอร์", "โปรแกรม", "ตัวอย่าง", "ทดสอบ",
+  "วันนี้", "พรุ่งนี้", "อากาศ", "ร้อน", "น้ำ", "อาหาร", "อร่อย", "เดินทาง", "ท่องเที่ยว", "ประชุม",
+};
+
+static const char *ENGLISH_WORDS[] = {
+  "the", "of", "and", "to", "in", "is", "for", "on", "with", "as",
+  "database", "index", "search", "query", "document", "token", "parser", "plugin", "server", "thread",
+  "thailand", "bangkok", "language", "system", "product", "price", "customer", "service", "report", "update",
+  "performance", "memory", "latency", "throughput", "release", "version", "feature", "support", "install", "config",
+};
+
+static const int64_t THAI_WORD_COUNT = sizeof(THAI_WORDS) / sizeof(THAI_WORDS[0]);
+static const int64_t ENGLISH_WORD_COUNT = sizeof(ENGLISH_WORDS) / sizeof(ENGLISH_WORDS[0]);
+
+const char *get_bench_script_name(ObBenchScript script)
+{
+  return (script >= 0 && script < OB_BENCH_SCRIPT_MAX) ? SCRIPT_NAMES[script] : "unknown";
+}
+
+void get_bench_words(ObBenchScript script, const char *const *&words, int64_t &count)
+{
+  if (OB_BENCH_SCRIPT_THAI == script) {
+    words = THAI_WORDS;
+    count = THAI_WORD_COUNT;
+  } else {
+    words = ENGLISH_WORDS;
+    count = ENGLISH_WORD_COUNT;
+  }
+}
+
+ObBenchScript get_bench_script(const char *name)
+{
+  ObBenchScript script = OB_BENCH_SCRIPT_MAX;
+  for (int i = 0; i < OB_BENCH_SCRIPT_MAX && OB_BENCH_SCRIPT_MAX == script; i++) {
+    if (0 == strcmp(name, SCRIPT_NAMES[i])) {
+      script = (ObBenchScript)i;
+    }
+  }
+  return script;
+}
+
+void ObBenchTextGen::generate(ObBenchScript script, int64_t bytes, std::string &out)
+{
+  out.clear();
+  out.reserve(bytes);
+  bool thai_phrase = OB_BENCH_SCRIPT_ENGLISH != script;
+  int64_t phrase_left = 2 + uniform(6);
+  std::string word;
+  while (true) {
+    word.clear();
+    if (phrase_left <= 0) {
+      // 短语结束：泰文用空格分隔短语，混合文本在此切换文字
+      phrase_left = 2 + uniform(6);
+      if (OB_BENCH_SCRIPT_MIXED == script) {
+        thai_phrase = !thai_phrase;
+      }
+      if (!out.empty()) {
+        word.push_back(' ');
+      }
+    }
+    if (OB_BENCH_SCRIPT_MIXED == script && 0 == uniform(16)) {
+      word += std::to_string(uniform(10000));
+      word.push_back(' ');
+    } else if (thai_phrase) {
+      word += THAI_WORDS[uniform(THAI_WORD_COUNT)];
+    } else {
+      word += ENGLISH_WORDS[uniform(ENGLISH_WORD_COUNT)];
+      word.push_back(' ');
+    }
+    phrase_left--;
+    if ((int64_t)(out.size() + word.size()) > bytes) {
+      break;
+    }
+    out += word;
+  }
+  while (!out.empty() && ' ' == out[out.size() - 1]) {
+    out.resize(out.size() - 1);
+  }
+  if (out.empty()) {
+    // 目标长度比任何词都短时至少给出一个词
+    out = thai_phrase ? THAI_WORDS[0] : ENGLISH_WORDS[0];
+  }
+}
+
+} // namespace thai
+} // namespace oceanbase
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_BENCH_TEXT_H_
+#define OB_THAI_BENCH_TEXT_H_
+
+#include <stdint.h>
+#include <string>
+
+namespace oceanbase {
+namespace thai {
+
+/// 生成文档的文字组成
+enum ObBenchScript
+{
+  OB_BENCH_SCRIPT_THAI = 0,
+  OB_BENCH_SCRIPT_ENGLISH,
+  OB_BENCH_SCRIPT_MIXED,
+  OB_BENCH_SCRIPT_MAX
+};
+
+const char *get_bench_script_name(ObBenchScript script);
+/// @return OB_BENCH_SCRIPT_MAX if the name is unknown
+ObBenchScript get_bench_script(const char *name);
+
+/// 内置词表，THAI 和 ENGLISH 有效，按常用程度排序
+void get_bench_words(ObBenchScript script, const char *const *&words, int64_t &count);
+
+/// 文档形态：名称和目标字节数
+struct ObBenchShape
+{
+  const char *name_;
+  int64_t     bytes_;
+};
+
+/// query 20B, title 200B, description 5KB, article 1MB
+extern const ObBenchShape BENCH_SHAPES[];
+extern const int64_t BENCH_SHAPE_COUNT;
+
+/**
+ * @brief Deterministic generator of benchmark documents.
+ * @details Thai text is written the Thai way: words run together and
+ * spaces only separate phrases. Mixed text alternates Thai and English
+ * phrases with some numbers. The same seed always yields the same text.
+ */
+class ObBenchTextGen final
+{
+public:
+  explicit ObBenchTextGen(uint64_t seed) : state_(seed * 2 + 1) {}
+
+  /// 生成不超过 bytes 字节、以完整词结尾的文档
+  void generate(ObBenchScript script, int64_t bytes, std::string &out);
+
+  uint64_t next()
+  {
+    // xorshift64*
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+    return state_ * 2685821657736338717ULL;
+  }
+  uint64_t uniform(uint64_t n) { return next() % n; }
+
+private:
+  uint64_t state_;
+};
+
+} // namespace thai
+} // namespace oceanbase
+
+#endif // OB_THAI_BENCH_TEXT_H_
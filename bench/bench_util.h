@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_BENCH_UTIL_H_
+#define OB_THAI_BENCH_UTIL_H_
+
+#include <errno.h>
+#include <functional>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace oceanbase {
+namespace thai {
+
+inline int64_t bench_now_ns()
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/// 追加 JSON 字符串字面量(含引号)
+inline void json_append_string(std::string &out, const char *str)
+{
+  out.push_back('"');
+  for (const char *p = str; '\0' != *p; p++) {
+    const unsigned char c = (unsigned char)*p;
+    if ('"' == c || '\\' == c) {
+      out.push_back('\\');
+      out.push_back((char)c);
+    } else if ('\n' == c) {
+      out += "\\n";
+    } else if (c < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", c);
+      out += buf;
+    } else {
+      out.push_back((char)c);
+    }
+  }
+  out.push_back('"');
+}
+
+inline void json_appendf(std::string &out, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+inline void json_appendf(std::string &out, const char *fmt, ...)
+{
+  char buf[1024];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n > 0) {
+    out.append(buf, n < (int)sizeof(buf) ? n : (int)sizeof(buf) - 1);
+  }
+}
+
+/// 写入文件，path 为空或 "-" 时写标准输出
+inline bool bench_write_output(const char *path, const std::string &content)
+{
+  bool ok = false;
+  const bool to_stdout = nullptr == path || '\0' == *path || 0 == strcmp(path, "-");
+  FILE *fp = to_stdout ? stdout : fopen(path, "w");
+  if (nullptr != fp) {
+    ok = content.size() == fwrite(content.data(), 1, content.size(), fp);
+    ok = (to_stdout ? 0 == fflush(fp) : 0 == fclose(fp)) && ok;
+  }
+  return ok;
+}
+
+/**
+ * 在 fork 出的子进程中运行 fn，通过管道取回 fn 写入的结果。
+ * 插件每个进程只读一次配置，换引擎或环境变量时用它隔离。
+ * @return false 表示 fork 失败或子进程异常退出，status 为 waitpid 状态
+ */
+inline bool bench_run_in_child(const std::function<void(std::string &)> &fn, std::string &out, int &status)
+{
+  status = 0;
+  int fds[2];
+  if (0 != pipe(fds)) {
+    fprintf(stderr, "pipe failed, errno=%d\n", errno);
+    return false;
+  }
+  fflush(stdout);
+  fflush(stderr);
+  const pid_t pid = fork();
+  if (pid < 0) {
+    fprintf(stderr, "fork failed, errno=%d\n", errno);
+    close(fds[0]);
+    close(fds[1]);
+    return false;
+  }
+  if (0 == pid) {
+    close(fds[0]);
+    std::string result;
+    fn(result);
+    const char *p = result.data();
+    size_t left = result.size();
+    while (left > 0) {
+      const ssize_t n = write(fds[1], p, left);
+      if (n <= 0) {
+        _exit(1);
+      }
+      p += n;
+      left -= (size_t)n;
+    }
+    close(fds[1]);
+    _exit(0);
+  }
+  close(fds[1]);
+  char buf[65536];
+  ssize_t n = 0;
+  while ((n = read(fds[0], buf, sizeof(buf))) > 0 || (n < 0 && EINTR == errno)) {
+    if (n > 0) {
+      out.append(buf, n);
+    }
+  }
+  close(fds[0]);
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) && 0 == WEXITSTATUS(status);
+}
+
+} // namespace thai
+} // namespace oceanbase
+
+#endif // OB_THAI_BENCH_UTIL_H_
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Writes a synthetic Thai/mixed corpus, or describes an existing one.
+ *
+ *   thai_corpus_gen [options] -o out.corpus [-G gold.txt]
+ *   thai_corpus_gen -i in.corpus [-x]
+ *
+ * The same seed, word list and options always produce the same file, so a
+ * corpus can be regenerated anywhere instead of being shipped. -G also
+ * writes the gold segmentation the generator knows by construction, as
+ * used by thai_ftparser_accuracy.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench_corpus.h"
+
+using namespace oceanbase::thai;
+
+namespace {
+
+bool parse_range(const char *arg, int64_t &lo, int64_t &hi)
+{
+  char *end = nullptr;
+  lo = strtoll(arg, &end, 10);
+  if (',' != *end) {
+    return false;
+  }
+  hi = strtoll(end + 1, &end, 10);
+  return '\0' == *end && lo > 0 && hi >= lo;
+}
+
+int describe(const char *path, bool dump)
+{
+  ObBenchCorpus corpus;
+  std::string err;
+  if (!corpus.open(path, err)) {
+    fprintf(stderr, "%s: %s\n", path, err.c_str());
+    return 1;
+  }
+  int64_t min_len = INT64_MAX;
+  int64_t max_len = 0;
+  for (int64_t i = 0; i < corpus.count(); i++) {
+    int64_t len = 0;
+    const char *doc = corpus.doc(i, len);
+    min_len = len < min_len ? len : min_len;
+    max_len = len > max_len ? len : max_len;
+    if (dump) {
+      // 文档内没有换行，按行输出可直接交给 thai_ftparser_host
+      fwrite(doc, 1, len, stdout);
+      fputc('\n', stdout);
+    }
+  }
+  fprintf(stderr, "%s: docs=%ld, bytes=%ld, avg=%.1f, min=%ld, max=%ld, seed=%lu\n",
+          path, corpus.count(), corpus.data_bytes(),
+          corpus.count() > 0 ? (double)corpus.data_bytes() / (double)corpus.count() : 0.0,
+          corpus.count() > 0 ? min_len : 0, max_len, corpus.seed());
+  return 0;
+}
+
+void usage(const char *prog)
+{
+  ObBenchCorpusOptions def;
+  fprintf(stderr,
+          "usage: %s [options] -o out.corpus [-G gold.txt]\n"
+          "       %s -i in.corpus [-x]\n"
+          "  -S seed      random seed, default %lu\n"
+          "  -n docs      number of documents, default %ld\n"
+          "  -w file      word list, one word per line, most frequent first\n"
+          "  -z s         Zipf exponent of word frequencies, default %.1f\n"
+          "  -l min,max   words per phrase, default %ld,%ld\n"
+          "  -L ratio     share of Latin phrases, default %.2f\n"
+          "  -D ratio     chance of a number after a phrase, default %.2f\n"
+          "  -u ratio     chance of duplicating a recent document, default %.2f\n"
+          "  -m bytes     median document size (log-normal), default %ld\n"
+          "  -g sigma     sigma of the log-normal size, default %.1f\n"
+          "  -b min,max   clamp of target document sizes, default %ld,%ld\n"
+          "  -G file      also write the gold segmentation, words separated by '|'\n"
+          "  -i file      print statistics of a corpus file\n"
+          "  -x           with -i, also dump the documents one per line\n",
+          prog, prog, def.seed_, def.doc_count_, def.zipf_s_, def.phrase_min_words_, def.phrase_max_words_,
+          def.latin_ratio_, def.digit_ratio_, def.duplicate_ratio_, def.median_bytes_, def.size_sigma_,
+          def.min_bytes_, def.max_bytes_);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  ObBenchCorpusOptions opts;
+  const char *output = nullptr;
+  const char *input = nullptr;
+  const char *word_file = nullptr;
+  const char *gold_file = nullptr;
+  bool dump = false;
+  bool valid = true;
+  int opt = 0;
+  while (-1 != (opt = getopt(argc, argv, "S:n:w:z:l:L:D:u:m:g:b:o:G:i:xh"))) {
+    switch (opt) {
+      case 'S': opts.seed_ = strtoull(optarg, nullptr, 10); break;
+      case 'n': opts.doc_count_ = atoll(optarg); break;
+      case 'w': word_file = optarg; break;
+      case 'z': opts.zipf_s_ = atof(optarg); break;
+      case 'l': valid = parse_range(optarg, opts.phrase_min_words_, opts.phrase_max_words_) && valid; break;
+      case 'L': opts.latin_ratio_ = atof(optarg); break;
+      case 'D': opts.digit_ratio_ = atof(optarg); break;
+      case 'u': opts.duplicate_ratio_ = atof(optarg); break;
+      case 'm': opts.median_bytes_ = atoll(optarg); break;
+      case 'g': opts.size_sigma_ = atof(optarg); break;
+      case 'b': valid = parse_range(optarg, opts.min_bytes_, opts.max_bytes_) && valid; break;
+      case 'o': output = optarg; break;
+      case 'G': gold_file = optarg; break;
+      case 'i': input = optarg; break;
+      case 'x': dump = true; break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  if (nullptr != input) {
+    return describe(input, dump);
+  }
+  if (!valid || nullptr == output || opts.doc_count_ <= 0 || opts.median_bytes_ <= 0 || opts.zipf_s_ < 0) {
+    usage(argv[0]);
+    return 2;
+  }
+  std::vector<std::string> words;
+  if (nullptr != word_file && !bench_read_word_list(word_file, words)) {
+    fprintf(stderr, "failed to read word list %s\n", word_file);
+    return 1;
+  }
+  ObBenchCorpusWriter writer(opts, nullptr != word_file ? &words : nullptr);
+  if (!writer.write(output, gold_file)) {
+    fprintf(stderr, "failed to write %s\n", output);
+    return 1;
+  }
+  return describe(output, false);
+}
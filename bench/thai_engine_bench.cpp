@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Single-thread throughput of the native engines, in process.
+ *
+ *   thai_engine_bench [-e engines] [-s shapes] [-t scripts] [-c corpus]
+ *                     [-w words] [-d seconds] [-S seed] [-o out.json]
+ *
+ * Links the core library directly, so it needs neither the plugin SDK nor
+ * Python, and measures the engines without the plugin's scan_begin and
+ * next_token overhead. The dict engine uses the word list given with -w,
+ * default the built-in Thai benchmark words.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "bench_corpus.h"
+#include "bench_text.h"
+#include "bench_util.h"
+#include "thai_ftparser_dict.h"
+#include "thai_ftparser_tcc.h"
+
+using namespace oceanbase::thai;
+
+namespace {
+
+typedef std::vector<std::pair<const char *, int64_t>> DocList;
+
+const int64_t POOL_BYTES = 4 * 1024 * 1024;    // 每个用例生成的文档总量
+const int64_t POOL_MAX_DOCS = 256;
+
+struct CaseResult
+{
+  int64_t docs_ = 0;
+  int64_t bytes_ = 0;
+  int64_t tokens_ = 0;
+  double  seconds_ = 0;
+};
+
+bool in_list(const std::string &list, const char *name)
+{
+  const std::string padded = "," + list + ",";
+  return std::string::npos != padded.find("," + std::string(name) + ",");
+}
+
+template <typename Tokenizer, typename Reset>
+CaseResult run_case(Tokenizer &tokenizer, Reset reset, const DocList &docs, double min_seconds)
+{
+  CaseResult result;
+  const int64_t begin_ns = bench_now_ns();
+  const int64_t min_ns = (int64_t)(min_seconds * 1e9);
+  const char *word = nullptr;
+  int64_t word_len = 0;
+  do {
+    for (size_t i = 0; i < docs.size(); i++) {
+      reset(tokenizer, docs[i].first, docs[i].first + docs[i].second);
+      while (tokenizer.next(word, word_len)) {
+        result.tokens_++;
+      }
+      result.bytes_ += docs[i].second;
+    }
+    result.docs_ += (int64_t)docs.size();
+  } while (bench_now_ns() - begin_ns < min_ns);
+  result.seconds_ = (double)(bench_now_ns() - begin_ns) / 1e9;
+  return result;
+}
+
+void append_case(std::string &report, bool &first, const char *engine, const char *shape,
+                 const char *script, const CaseResult &r)
+{
+  report += first ? "\n  " : ",\n  ";
+  first = false;
+  json_appendf(report, "{\"engine\":\"%s\",\"shape\":\"%s\",\"script\":\"%s\",\"docs\":%ld,\"bytes\":%ld,"
+               "\"tokens\":%ld,\"seconds\":%.6f,\"mb_per_s\":%.3f,\"tokens_per_s\":%.1f,\"ns_per_byte\":%.3f}",
+               engine, shape, script, r.docs_, r.bytes_, r.tokens_, r.seconds_,
+               (double)r.bytes_ / r.seconds_ / 1e6, (double)r.tokens_ / r.seconds_,
+               r.bytes_ > 0 ? r.seconds_ * 1e9 / (double)r.bytes_ : 0.0);
+  fprintf(stderr, "%-5s %-12s %-8s %10.2f MB/s %8.3f ns/byte\n", engine, shape, script,
+          (double)r.bytes_ / r.seconds_ / 1e6, r.bytes_ > 0 ? r.seconds_ * 1e9 / (double)r.bytes_ : 0.0);
+}
+
+void usage(const char *prog)
+{
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  -e list     engines, default tcc,dict,viterbi\n"
+          "  -s list     shapes, default query,title,description,article\n"
+          "  -t list     scripts, default thai,english,mixed\n"
+          "  -c file     benchmark the documents of a corpus file instead of -s/-t\n"
+          "  -w file     word list of the dict engine, one word per line\n"
+          "  -d seconds  minimum run time of each case, default 1\n"
+          "  -S seed     seed of the generated documents, default 42\n"
+          "  -o file     write the JSON report to file instead of stdout\n",
+          prog);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  std::string engines = "tcc,dict,viterbi";
+  std::string shapes = "query,title,description,article";
+  std::string scripts = "thai,english,mixed";
+  const char *corpus_path = nullptr;
+  const char *words_path = nullptr;
+  const char *output = nullptr;
+  double min_seconds = 1.0;
+  uint64_t seed = 42;
+  int opt = 0;
+  while (-1 != (opt = getopt(argc, argv, "e:s:t:c:w:d:S:o:h"))) {
+    switch (opt) {
+      case 'e': engines = optarg; break;
+      case 's': shapes = optarg; break;
+      case 't': scripts = optarg; break;
+      case 'c': corpus_path = optarg; break;
+      case 'w': words_path = optarg; break;
+      case 'd': min_seconds = atof(optarg); break;
+      case 'S': seed = strtoull(optarg, nullptr, 10); break;
+      case 'o': output = optarg; break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+
+  ObThaiDictionary dict;
+  if (nullptr != words_path) {
+    if (!dict.load(words_path)) {
+      fprintf(stderr, "failed to load %s\n", words_path);
+      return 1;
+    }
+  } else {
+    const char *const *words = nullptr;
+    int64_t count = 0;
+    get_bench_words(OB_BENCH_SCRIPT_THAI, words, count);
+    std::string list;
+    for (int64_t i = 0; i < count; i++) {
+      list.append(words[i]).push_back('\n');
+    }
+    dict.build(list.data(), (int64_t)list.size());
+  }
+
+  ObThaiTccTokenizer tcc;
+  ObThaiDictTokenizer dict_tokenizer;
+  auto reset_tcc = [](ObThaiTccTokenizer &t, const char *b, const char *e) { t.reset(b, e); };
+  auto reset_dict = [&dict](ObThaiDictTokenizer &t, const char *b, const char *e) { t.reset(&dict, b, e); };
+  auto reset_viterbi = [&dict](ObThaiDictTokenizer &t, const char *b, const char *e) {
+    t.reset(&dict, b, e, OB_THAI_DICT_VITERBI);
+  };
+
+  std::string report = "{\"benchmark\":\"thai_engine_bench\",\"corpus\":";
+  json_append_string(report, nullptr != corpus_path ? corpus_path : "");
+  json_appendf(report, ",\"dict_words\":%ld,\"seed\":%lu,\"min_seconds\":%.3f,\"cases\":[",
+               dict.word_count(), seed, min_seconds);
+  bool first = true;
+
+  // 一个用例：给定文档集合依次跑各个引擎
+  auto run_engines = [&](const DocList &docs, const char *shape, const char *script) {
+    if (in_list(engines, "tcc")) {
+      append_case(report, first, "tcc", shape, script, run_case(tcc, reset_tcc, docs, min_seconds));
+    }
+    if (in_list(engines, "dict")) {
+      append_case(report, first, "dict", shape, script, run_case(dict_tokenizer, reset_dict, docs, min_seconds));
+    }
+    if (in_list(engines, "viterbi")) {
+      append_case(report, first, "viterbi", shape, script, run_case(dict_tokenizer, reset_viterbi, docs, min_seconds));
+    }
+  };
+
+  if (nullptr != corpus_path) {
+    ObBenchCorpus corpus;
+    std::string err;
+    if (!corpus.open(corpus_path, err) || 0 == corpus.count()) {
+      fprintf(stderr, "%s: %s\n", corpus_path, err.empty() ? "empty corpus" : err.c_str());
+      return 1;
+    }
+    DocList docs(corpus.count());
+    for (int64_t i = 0; i < corpus.count(); i++) {
+      docs[i].first = corpus.doc(i, docs[i].second);
+    }
+    run_engines(docs, "corpus", "corpus");
+  } else {
+    for (int64_t s = 0; s < BENCH_SHAPE_COUNT; s++) {
+      const ObBenchShape &shape = BENCH_SHAPES[s];
+      for (int t = 0; t < OB_BENCH_SCRIPT_MAX && in_list(shapes, shape.name_); t++) {
+        const ObBenchScript script = (ObBenchScript)t;
+        if (!in_list(scripts, get_bench_script_name(script))) {
+          continue;
+        }
+        int64_t count = POOL_BYTES / shape.bytes_;
+        count = count < 1 ? 1 : (count > POOL_MAX_DOCS ? POOL_MAX_DOCS : count);
+        std::vector<std::string> texts(count);
+        DocList docs(count);
+        ObBenchTextGen gen(seed);
+        for (int64_t i = 0; i < count; i++) {
+          gen.generate(script, shape.bytes_, texts[i]);
+          docs[i] = std::make_pair(texts[i].data(), (int64_t)texts[i].size());
+        }
+        run_engines(docs, shape.name_, get_bench_script_name(script));
+      }
+    }
+  }
+  report += "\n]}\n";
+  if (!bench_write_output(output, report)) {
+    fprintf(stderr, "failed to write %s\n", output);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,473 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Accuracy versus speed gate of the plugin's engines.
+ *
+ *   thai_ftparser_accuracy -g gold.txt [-e engines] [-r reference] [-f min_f1]
+ *                          [-F min_ref_f1] [-b baseline.json] [-R max_slowdown_pct]
+ *                          [-d seconds] [-o out.json] plugin.so
+ *
+ * The gold file has one document per line, words separated by '|'
+ * (thai_corpus_gen -G writes one). Every engine runs in its own process
+ * with OB_THAI_FTPARSER_ENGINE set. Reported per engine: boundary
+ * precision, recall and F1 against the gold data and against the
+ * reference engine (python by default), next to throughput.
+ *
+ * Boundaries are the cut positions strictly inside a document implied by
+ * the start and end of every token. The gate fails (exit 1) when an
+ * engine's F1 drops below -f/-F, or its MB/s falls more than -R percent
+ * below the same engine in a previous report given with -b.
+ */
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "bench_util.h"
+#include "ob_plugin_host.h"
+
+using namespace oceanbase::thai;
+
+namespace {
+
+typedef std::vector<uint32_t> Boundaries;
+
+struct GoldDoc
+{
+  std::string text_;
+  Boundaries  bounds_;
+};
+
+struct EngineRun
+{
+  double                  seconds_ = 0;
+  int64_t                 docs_ = 0;
+  int64_t                 bytes_ = 0;
+  int64_t                 tokens_ = 0;
+  int64_t                 unaligned_ = 0;   // 无法在原文中定位的 token
+  std::string             stats_;
+  std::vector<Boundaries> bounds_;
+};
+
+struct Score
+{
+  int64_t matched_ = 0;
+  int64_t predicted_ = 0;
+  int64_t expected_ = 0;
+
+  double precision() const { return predicted_ > 0 ? (double)matched_ / (double)predicted_ : 0; }
+  double recall() const { return expected_ > 0 ? (double)matched_ / (double)expected_ : 0; }
+  double f1() const
+  {
+    const double p = precision();
+    const double r = recall();
+    return p + r > 0 ? 2 * p * r / (p + r) : 0;
+  }
+};
+
+struct AccuracyOptions
+{
+  const char *plugin_ = nullptr;
+  const char *parser_ = nullptr;
+  const char *gold_ = nullptr;
+  const char *baseline_ = nullptr;
+  const char *output_ = nullptr;
+  std::string engines_ = "python,tcc,space";
+  std::string reference_ = "python";
+  double      min_f1_ = 0;
+  double      min_ref_f1_ = 0;
+  double      max_slowdown_pct_ = 10;
+  double      min_seconds_ = 1.0;
+};
+
+void add_span(Boundaries &bounds, int64_t begin, int64_t end, int64_t len)
+{
+  if (begin > 0 && begin < len) {
+    bounds.push_back((uint32_t)begin);
+  }
+  if (end > 0 && end < len) {
+    bounds.push_back((uint32_t)end);
+  }
+}
+
+void normalize(Boundaries &bounds)
+{
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+}
+
+bool load_gold(const char *path, std::vector<GoldDoc> &docs)
+{
+  std::string content;
+  if (!host_read_file(path, content)) {
+    return false;
+  }
+  std::vector<std::pair<const char *, int64_t>> lines;
+  host_split_lines(content, lines);
+  docs.resize(lines.size());
+  for (size_t i = 0; i < lines.size(); i++) {
+    GoldDoc &doc = docs[i];
+    const char *line = lines[i].first;
+    const int64_t line_len = lines[i].second;
+    // 去掉分隔符得到原文，同时记录每个非空白词的起止位置
+    std::vector<std::pair<int64_t, int64_t>> spans;
+    int64_t word_begin = 0;
+    for (int64_t p = 0; p <= line_len; p++) {
+      if (p == line_len || '|' == line[p]) {
+        int64_t b = word_begin;
+        int64_t e = (int64_t)doc.text_.size();
+        while (b < e && isspace((unsigned char)doc.text_[b])) {
+          b++;
+        }
+        while (e > b && isspace((unsigned char)doc.text_[e - 1])) {
+          e--;
+        }
+        if (b < e) {
+          spans.push_back(std::make_pair(b, e));
+        }
+        word_begin = (int64_t)doc.text_.size();
+      } else {
+        doc.text_.push_back(line[p]);
+      }
+    }
+    for (size_t s = 0; s < spans.size(); s++) {
+      add_span(doc.bounds_, spans[s].first, spans[s].second, (int64_t)doc.text_.size());
+    }
+    normalize(doc.bounds_);
+  }
+  return true;
+}
+
+// token 可能指向原文，也可能是插件的拷贝；后者从游标处向后查找
+void tokenize_doc(const ObHostScanner &scanner, const std::string &text, EngineRun &run, Boundaries &bounds)
+{
+  const char *begin = text.data();
+  const int64_t len = (int64_t)text.size();
+  int64_t cursor = 0;
+  scanner.scan(begin, len, [&](const char *word, int64_t word_len, int64_t, int64_t) {
+      int64_t pos = -1;
+      if (word >= begin && word + word_len <= begin + len) {
+        pos = word - begin;
+      } else if (word_len > 0 && cursor < len) {
+        const void *found = memmem(begin + cursor, len - cursor, word, word_len);
+        pos = nullptr == found ? -1 : (const char *)found - begin;
+      }
+      if (pos < 0) {
+        run.unaligned_++;
+      } else {
+        add_span(bounds, pos, pos + word_len, len);
+        cursor = pos + word_len;
+      }
+      run.tokens_++;
+    });
+  normalize(bounds);
+}
+
+void run_engine_child(const AccuracyOptions &opts, const std::vector<GoldDoc> &docs, EngineRun &run)
+{
+  ObPluginHost host;
+  const ObPluginFTParser *parser = nullptr;
+  if (OBP_SUCCESS != host.load(opts.plugin_) || nullptr == (parser = host.parser(opts.parser_))) {
+    return;
+  }
+  ObHostScanner scanner(parser);
+  run.bounds_.resize(docs.size());
+  for (size_t i = 0; i < docs.size(); i++) {
+    tokenize_doc(scanner, docs[i].text_, run, run.bounds_[i]);
+  }
+  // 吞吐单独计时，不含对齐的开销
+  const int64_t min_ns = (int64_t)(opts.min_seconds_ * 1e9);
+  const int64_t begin_ns = bench_now_ns();
+  int64_t elapsed_ns = 0;
+  do {
+    for (size_t i = 0; i < docs.size(); i++) {
+      int64_t tokens = 0;
+      scanner.count(docs[i].text_.data(), (int64_t)docs[i].text_.size(), tokens);
+      run.docs_++;
+      run.bytes_ += (int64_t)docs[i].text_.size();
+    }
+    elapsed_ns = bench_now_ns() - begin_ns;
+  } while (elapsed_ns < min_ns);
+  run.seconds_ = (double)elapsed_ns / 1e9;
+  typedef int64_t (*SnapshotFunc)(char *, int64_t);
+  SnapshotFunc snapshot = (SnapshotFunc)host.symbol("thai_ftparser_stats_snapshot");
+  if (nullptr != snapshot) {
+    char buf[4096];
+    snapshot(buf, sizeof(buf));
+    run.stats_ = buf;
+  }
+}
+
+// 子进程把结果按原生字节序序列化后写回父进程
+template <typename T>
+void put(std::string &out, const T &value)
+{
+  out.append((const char *)&value, sizeof(value));
+}
+
+template <typename T>
+bool get(const std::string &in, size_t &pos, T &value)
+{
+  const bool ok = pos + sizeof(value) <= in.size();
+  if (ok) {
+    memcpy(&value, in.data() + pos, sizeof(value));
+    pos += sizeof(value);
+  }
+  return ok;
+}
+
+void serialize(const EngineRun &run, std::string &out)
+{
+  put(out, run.seconds_);
+  put(out, run.docs_);
+  put(out, run.bytes_);
+  put(out, run.tokens_);
+  put(out, run.unaligned_);
+  put(out, (uint64_t)run.stats_.size());
+  out += run.stats_;
+  put(out, (uint64_t)run.bounds_.size());
+  for (size_t i = 0; i < run.bounds_.size(); i++) {
+    put(out, (uint64_t)run.bounds_[i].size());
+    out.append((const char *)run.bounds_[i].data(), run.bounds_[i].size() * sizeof(uint32_t));
+  }
+}
+
+bool deserialize(const std::string &in, EngineRun &run)
+{
+  size_t pos = 0;
+  uint64_t n = 0;
+  bool ok = get(in, pos, run.seconds_) && get(in, pos, run.docs_) && get(in, pos, run.bytes_)
+            && get(in, pos, run.tokens_) && get(in, pos, run.unaligned_) && get(in, pos, n) && pos + n <= in.size();
+  if (ok) {
+    run.stats_.assign(in.data() + pos, n);
+    pos += n;
+    ok = get(in, pos, n);
+  }
+  if (ok) {
+    run.bounds_.resize(n);
+  }
+  for (size_t i = 0; ok && i < run.bounds_.size(); i++) {
+    ok = get(in, pos, n) && pos + n * sizeof(uint32_t) <= in.size();
+    if (ok) {
+      run.bounds_[i].resize(n);
+      memcpy(run.bounds_[i].data(), in.data() + pos, n * sizeof(uint32_t));
+      pos += n * sizeof(uint32_t);
+    }
+  }
+  return ok;
+}
+
+void score(const std::vector<Boundaries> &predicted, const std::vector<Boundaries> &expected, Score &s)
+{
+  for (size_t i = 0; i < predicted.size() && i < expected.size(); i++) {
+    std::vector<uint32_t> common;
+    std::set_intersection(predicted[i].begin(), predicted[i].end(), expected[i].begin(), expected[i].end(),
+                          std::back_inserter(common));
+    s.matched_ += (int64_t)common.size();
+    s.predicted_ += (int64_t)predicted[i].size();
+    s.expected_ += (int64_t)expected[i].size();
+  }
+}
+
+// 从之前的报告中取某个引擎的 mb_per_s，报告是本工具写的，不需要完整的 JSON 解析
+bool baseline_mb_per_s(const std::string &report, const char *engine, double &mb_per_s)
+{
+  const std::string key = std::string("{\"engine\":\"") + engine + "\"";
+  const size_t at = report.find(key);
+  const size_t value = std::string::npos == at ? at : report.find("\"mb_per_s\":", at);
+  const size_t next = std::string::npos == at ? at : report.find("{\"engine\":", at + 1);
+  const bool found = std::string::npos != value && (std::string::npos == next || value < next);
+  if (found) {
+    mb_per_s = atof(report.c_str() + value + strlen("\"mb_per_s\":"));
+  }
+  return found;
+}
+
+void append_score(std::string &out, const char *name, const Score &s)
+{
+  json_appendf(out, ",\"%s\":{\"precision\":%.4f,\"recall\":%.4f,\"f1\":%.4f,\"matched\":%ld,"
+               "\"predicted\":%ld,\"expected\":%ld}",
+               name, s.precision(), s.recall(), s.f1(), s.matched_, s.predicted_, s.expected_);
+}
+
+void usage(const char *prog)
+{
+  fprintf(stderr,
+          "usage: %s -g gold.txt [options] plugin.so\n"
+          "  -g file     gold segmentation, one document per line, words separated by '|'\n"
+          "  -p name     ftparser to use, default the first one registered\n"
+          "  -e list     engines, default python,tcc,space\n"
+          "  -r engine   reference engine, default python\n"
+          "  -f f1       fail when an engine's F1 against gold is below this\n"
+          "  -F f1       fail when an engine's F1 against the reference is below this\n"
+          "  -b file     previous report of this tool to compare throughput with\n"
+          "  -R pct      fail when MB/s drops more than pct below the baseline, default 10\n"
+          "  -d seconds  minimum run time of the throughput pass, default 1\n"
+          "  -o file     write the JSON report to file instead of stdout\n",
+          prog);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  AccuracyOptions opts;
+  int opt = 0;
+  while (-1 != (opt = getopt(argc, argv, "g:p:e:r:f:F:b:R:d:o:h"))) {
+    switch (opt) {
+      case 'g': opts.gold_ = optarg; break;
+      case 'p': opts.parser_ = optarg; break;
+      case 'e': opts.engines_ = optarg; break;
+      case 'r': opts.reference_ = optarg; break;
+      case 'f': opts.min_f1_ = atof(optarg); break;
+      case 'F': opts.min_ref_f1_ = atof(optarg); break;
+      case 'b': opts.baseline_ = optarg; break;
+      case 'R': opts.max_slowdown_pct_ = atof(optarg); break;
+      case 'd': opts.min_seconds_ = atof(optarg); break;
+      case 'o': opts.output_ = optarg; break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  if (optind >= argc || nullptr == opts.gold_) {
+    usage(argv[0]);
+    return 2;
+  }
+  opts.plugin_ = argv[optind];
+
+  std::vector<GoldDoc> docs;
+  if (!load_gold(opts.gold_, docs) || docs.empty()) {
+    fprintf(stderr, "failed to read gold data from %s\n", opts.gold_);
+    return 1;
+  }
+  std::string baseline;
+  if (nullptr != opts.baseline_ && !host_read_file(opts.baseline_, baseline)) {
+    fprintf(stderr, "failed to read baseline %s\n", opts.baseline_);
+    return 1;
+  }
+  std::vector<Boundaries> gold(docs.size());
+  for (size_t i = 0; i < docs.size(); i++) {
+    gold[i] = docs[i].bounds_;
+  }
+
+  // 参考引擎排在最前，其余引擎需要和它比较
+  std::vector<std::string> engines(1, opts.reference_);
+  for (const char *p = opts.engines_.c_str(); '\0' != *p;) {
+    const char *comma = strchr(p, ',');
+    const std::string name(p, nullptr == comma ? strlen(p) : comma - p);
+    if (!name.empty() && name != opts.reference_) {
+      engines.push_back(name);
+    }
+    p = nullptr == comma ? p + strlen(p) : comma + 1;
+  }
+
+  std::vector<EngineRun> runs(engines.size());
+  std::vector<bool> available(engines.size(), false);
+  for (size_t e = 0; e < engines.size(); e++) {
+    fprintf(stderr, "engine %s ...\n", engines[e].c_str());
+    std::string result;
+    int status = 0;
+    const bool ok = bench_run_in_child([&](std::string &out) {
+        setenv("OB_THAI_FTPARSER_ENGINE", engines[e].c_str(), 1);
+        EngineRun run;
+        run_engine_child(opts, docs, run);
+        if (!run.bounds_.empty()) {
+          serialize(run, out);
+        }
+      }, result, status);
+    available[e] = ok && !result.empty() && deserialize(result, runs[e]);
+    if (!available[e]) {
+      fprintf(stderr, "engine %s: no result, child status=%d\n", engines[e].c_str(), status);
+    }
+  }
+
+  bool pass = true;
+  std::string report = "{\"benchmark\":\"thai_ftparser_accuracy\",\"plugin\":";
+  json_append_string(report, opts.plugin_);
+  report += ",\"gold\":";
+  json_append_string(report, opts.gold_);
+  report += ",\"reference\":";
+  json_append_string(report, opts.reference_.c_str());
+  json_appendf(report, ",\"docs\":%zu,\"min_f1\":%.4f,\"min_reference_f1\":%.4f,\"max_slowdown_pct\":%.1f,"
+               "\"engines\":[", docs.size(), opts.min_f1_, opts.min_ref_f1_, opts.max_slowdown_pct_);
+  fprintf(stderr, "%-10s %9s %9s %9s %9s %10s %10s  %s\n",
+          "engine", "precision", "recall", "f1", "ref_f1", "MB/s", "base MB/s", "verdict");
+  for (size_t e = 0; e < engines.size(); e++) {
+    const char *name = engines[e].c_str();
+    report += 0 == e ? "\n  {\"engine\":" : ",\n  {\"engine\":";
+    json_append_string(report, name);
+    if (!available[e]) {
+      report += ",\"available\":false}";
+      fprintf(stderr, "%-10s unavailable  FAIL\n", name);
+      pass = false;
+      continue;
+    }
+    const EngineRun &run = runs[e];
+    Score vs_gold;
+    Score vs_ref;
+    score(run.bounds_, gold, vs_gold);
+    if (available[0]) {
+      score(run.bounds_, runs[0].bounds_, vs_ref);
+    }
+    const double mb_per_s = run.seconds_ > 0 ? (double)run.bytes_ / run.seconds_ / 1e6 : 0;
+    double base_mb_per_s = 0;
+    const bool has_base = !baseline.empty() && baseline_mb_per_s(baseline, name, base_mb_per_s);
+    std::string verdict;
+    if (vs_gold.f1() < opts.min_f1_) {
+      verdict += " f1";
+    }
+    if (e > 0 && available[0] && vs_ref.f1() < opts.min_ref_f1_) {
+      verdict += " ref_f1";
+    }
+    if (has_base && mb_per_s < base_mb_per_s * (1 - opts.max_slowdown_pct_ / 100)) {
+      verdict += " speed";
+    }
+    pass = pass && verdict.empty();
+    json_appendf(report, ",\"available\":true,\"docs\":%ld,\"bytes\":%ld,\"tokens\":%ld,\"unaligned_tokens\":%ld,"
+                 "\"seconds\":%.6f,\"mb_per_s\":%.3f,\"docs_per_s\":%.1f",
+                 run.docs_, run.bytes_, run.tokens_, run.unaligned_, run.seconds_, mb_per_s,
+                 run.seconds_ > 0 ? (double)run.docs_ / run.seconds_ : 0.0);
+    append_score(report, "gold", vs_gold);
+    if (available[0]) {
+      append_score(report, "reference", vs_ref);
+    }
+    if (has_base) {
+      json_appendf(report, ",\"baseline_mb_per_s\":%.3f", base_mb_per_s);
+    }
+    report += ",\"pass\":";
+    report += verdict.empty() ? "true" : "false";
+    report += ",\"plugin_stats\":";
+    json_append_string(report, run.stats_.c_str());
+    report += "}";
+    char base[32] = "-";
+    if (has_base) {
+      snprintf(base, sizeof(base), "%.2f", base_mb_per_s);
+    }
+    fprintf(stderr, "%-10s %9.4f %9.4f %9.4f %9.4f %10.2f %10s  %s%s\n",
+            name, vs_gold.precision(), vs_gold.recall(), vs_gold.f1(), vs_ref.f1(), mb_per_s, base,
+            verdict.empty() ? "ok" : "FAIL:", verdict.c_str());
+  }
+  report += "\n],\"pass\":";
+  report += pass ? "true" : "false";
+  report += "}\n";
+  if (!bench_write_output(opts.output_, report)) {
+    fprintf(stderr, "failed to write %s\n", opts.output_);
+    return 1;
+  }
+  return pass ? 0 : 1;
+}
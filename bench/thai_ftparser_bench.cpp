@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Single thread throughput of the plugin per engine, document shape and
+ * script.
+ *
+ *   thai_ftparser_bench [-p parser] [-e engines] [-s shapes] [-t scripts]
+ *                       [-c corpus] [-d seconds] [-S seed] [-o out.json] plugin.so
+ *
+ * Every engine runs in a child process with OB_THAI_FTPARSER_ENGINE set,
+ * since the plugin reads its configuration once per process. Results are
+ * one JSON document: MB/s, documents/s and tokens/s per case plus the
+ * plugin's own stats line per engine. With -c the documents of a corpus
+ * file written by thai_corpus_gen replace the generated shapes.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "bench_corpus.h"
+#include "bench_text.h"
+#include "bench_util.h"
+#include "ob_plugin_host.h"
+
+using namespace oceanbase::thai;
+
+namespace {
+
+struct BenchEngine
+{
+  const char *name_;
+  const char *env_value_;     // OB_THAI_FTPARSER_ENGINE，nullptr 表示插件不支持
+  const char *skip_reason_;
+};
+
+const BenchEngine ENGINES[] = {
+  {"space", "space", nullptr},
+  {"python", "python", nullptr},
+  {"tcc", "tcc", nullptr},
+  {"dict", "dict", nullptr},
+  {"viterbi", "viterbi", nullptr},
+  {"ngram", "ngram", nullptr},
+  {"ascii", "ascii", nullptr},
+  {"auto", "auto", nullptr},
+  {"cache", nullptr, "the plugin has no result cache"},
+};
+const int ENGINE_COUNT = sizeof(ENGINES) / sizeof(ENGINES[0]);
+
+const int64_t POOL_BYTES = 4 * 1024 * 1024;    // 每个用例生成的文档总量
+const int64_t POOL_MAX_DOCS = 256;
+
+struct BenchOptions
+{
+  const char *plugin_ = nullptr;
+  const char *parser_ = nullptr;
+  const char *output_ = nullptr;
+  const char *corpus_ = nullptr;
+  std::string engines_ = "space,python,tcc,dict,viterbi,auto,cache";
+  std::string shapes_ = "query,title,description,article";
+  std::string scripts_ = "thai,english,mixed";
+  double      min_seconds_ = 1.0;
+  uint64_t    seed_ = 42;
+};
+
+bool in_list(const std::string &list, const char *name)
+{
+  const std::string padded = "," + list + ",";
+  return std::string::npos != padded.find(std::string(",") + name + ",");
+}
+
+typedef std::vector<std::pair<const char *, int64_t>> DocList;
+
+// 循环扫描 docs 至少 min_seconds 秒，结果追加为一个 JSON 对象
+void run_case(const ObHostScanner &scanner, const DocList &docs, double min_seconds, const char *shape,
+              const char *script, int64_t doc_bytes, std::string &out)
+{
+  int64_t count = 0;
+  int64_t bytes = 0;
+  int64_t tokens = 0;
+  int64_t failed = 0;
+  const int64_t min_ns = (int64_t)(min_seconds * 1e9);
+  const int64_t begin_ns = bench_now_ns();
+  int64_t elapsed_ns = 0;
+  do {
+    for (size_t i = 0; i < docs.size(); i++) {
+      int64_t doc_tokens = 0;
+      if (OBP_SUCCESS != scanner.count(docs[i].first, docs[i].second, doc_tokens)) {
+        failed++;
+      }
+      count++;
+      bytes += docs[i].second;
+      tokens += doc_tokens;
+    }
+    elapsed_ns = bench_now_ns() - begin_ns;
+  } while (elapsed_ns < min_ns);
+
+  const double seconds = (double)elapsed_ns / 1e9;
+  json_appendf(out, "{\"shape\":\"%s\",\"script\":\"%s\",\"doc_bytes\":%ld,\"docs\":%ld,\"bytes\":%ld,"
+               "\"tokens\":%ld,\"failed\":%ld,\"seconds\":%.6f,"
+               "\"mb_per_s\":%.3f,\"docs_per_s\":%.1f,\"tokens_per_s\":%.1f}",
+               shape, script, doc_bytes, count, bytes, tokens, failed, seconds,
+               (double)bytes / seconds / 1e6, (double)count / seconds, (double)tokens / seconds);
+}
+
+// 在子进程中跑一个引擎的全部用例，返回该引擎的 JSON 对象
+void run_engine_cases(const BenchOptions &opts, const BenchEngine &engine, std::string &out)
+{
+  ObPluginHost host;
+  const ObPluginFTParser *parser = nullptr;
+  if (OBP_SUCCESS != host.load(opts.plugin_) || nullptr == (parser = host.parser(opts.parser_))) {
+    out += "{\"engine\":";
+    json_append_string(out, engine.name_);
+    out += ",\"available\":false,\"reason\":\"failed to load plugin or parser\"}";
+    return;
+  }
+  ObHostScanner scanner(parser);
+  out += "{\"engine\":";
+  json_append_string(out, engine.name_);
+  out += ",\"available\":true,\"results\":[";
+  bool first = true;
+  ObBenchCorpus corpus;
+  std::string err;
+  if (nullptr != opts.corpus_ && corpus.open(opts.corpus_, err)) {
+    DocList docs(corpus.count());
+    for (int64_t i = 0; i < corpus.count(); i++) {
+      docs[i].first = corpus.doc(i, docs[i].second);
+    }
+    out += "\n    ";
+    first = false;
+    run_case(scanner, docs, opts.min_seconds_, "corpus", "file",
+             corpus.count() > 0 ? corpus.data_bytes() / corpus.count() : 0, out);
+  }
+  for (int64_t s = 0; nullptr == opts.corpus_ && s < BENCH_SHAPE_COUNT; s++) {
+    const ObBenchShape &shape = BENCH_SHAPES[s];
+    if (!in_list(opts.shapes_, shape.name_)) {
+      continue;
+    }
+    for (int t = 0; t < OB_BENCH_SCRIPT_MAX; t++) {
+      const ObBenchScript script = (ObBenchScript)t;
+      if (!in_list(opts.scripts_, get_bench_script_name(script))) {
+        continue;
+      }
+      // 相同种子保证各引擎、各次运行使用相同的文档
+      ObBenchTextGen gen(opts.seed_ + s * OB_BENCH_SCRIPT_MAX + t);
+      int64_t pool_docs = POOL_BYTES / shape.bytes_;
+      pool_docs = pool_docs < 1 ? 1 : (pool_docs > POOL_MAX_DOCS ? POOL_MAX_DOCS : pool_docs);
+      std::vector<std::string> pool(pool_docs);
+      DocList docs(pool_docs);
+      for (int64_t i = 0; i < pool_docs; i++) {
+        gen.generate(script, shape.bytes_, pool[i]);
+        docs[i] = std::make_pair(pool[i].data(), (int64_t)pool[i].size());
+      }
+      out += first ? "\n    " : ",\n    ";
+      first = false;
+      run_case(scanner, docs, opts.min_seconds_, shape.name_, get_bench_script_name(script), shape.bytes_, out);
+    }
+  }
+  out += "]";
+  typedef int64_t (*SnapshotFunc)(char *, int64_t);
+  SnapshotFunc snapshot = (SnapshotFunc)host.symbol("thai_ftparser_stats_snapshot");
+  if (nullptr != snapshot) {
+    char buf[4096];
+    snapshot(buf, sizeof(buf));
+    out += ",\"plugin_stats\":";
+    json_append_string(out, buf);
+  }
+  out += "}";
+}
+
+// fork 出子进程运行一个引擎，通过管道取回结果
+bool run_engine(const BenchOptions &opts, const BenchEngine &engine, std::string &out)
+{
+  std::string result;
+  int status = 0;
+  const bool ok = bench_run_in_child([&](std::string &child_out) {
+      setenv("OB_THAI_FTPARSER_ENGINE", engine.env_value_, 1);
+      run_engine_cases(opts, engine, child_out);
+    }, result, status);
+  if (!ok || result.empty()) {
+    fprintf(stderr, "engine %s: child exited abnormally, status=%d\n", engine.name_, status);
+    out += "{\"engine\":";
+    json_append_string(out, engine.name_);
+    json_appendf(out, ",\"available\":false,\"reason\":\"child exited abnormally, status=%d\"}", status);
+    return false;
+  }
+  out += result;
+  return true;
+}
+
+void usage(const char *prog)
+{
+  fprintf(stderr,
+          "usage: %s [options] plugin.so\n"
+          "  -p name     ftparser to use, default the first one registered\n"
+          "  -e list     engines, default space,python,tcc,dict,viterbi,auto,cache\n"
+          "  -s list     shapes, default query,title,description,article\n"
+          "  -t list     scripts, default thai,english,mixed\n"
+          "  -c file     benchmark the documents of a corpus file instead of -s/-t\n"
+          "  -d seconds  minimum run time of each case, default 1\n"
+          "  -S seed     seed of the generated documents, default 42\n"
+          "  -o file     write the JSON report to file instead of stdout\n",
+          prog);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  BenchOptions opts;
+  int opt = 0;
+  while (-1 != (opt = getopt(argc, argv, "p:e:s:t:c:d:S:o:h"))) {
+    switch (opt) {
+      case 'p': opts.parser_ = optarg; break;
+      case 'e': opts.engines_ = optarg; break;
+      case 's': opts.shapes_ = optarg; break;
+      case 't': opts.scripts_ = optarg; break;
+      case 'c': opts.corpus_ = optarg; break;
+      case 'd': opts.min_seconds_ = atof(optarg); break;
+      case 'S': opts.seed_ = strtoull(optarg, nullptr, 10); break;
+      case 'o': opts.output_ = optarg; break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  if (optind >= argc) {
+    usage(argv[0]);
+    return 2;
+  }
+  opts.plugin_ = argv[optind];
+  if (nullptr != opts.corpus_) {
+    // 先在父进程校验一次，子进程各自映射
+    ObBenchCorpus corpus;
+    std::string err;
+    if (!corpus.open(opts.corpus_, err)) {
+      fprintf(stderr, "%s: %s\n", opts.corpus_, err.c_str());
+      return 1;
+    }
+  }
+
+  std::string report = "{\"benchmark\":\"thai_ftparser_throughput\",\"plugin\":";
+  json_append_string(report, opts.plugin_);
+  report += ",\"parser\":";
+  json_append_string(report, nullptr != opts.parser_ ? opts.parser_ : "");
+  json_appendf(report, ",\"seed\":%lu,\"min_seconds\":%.3f,\"engines\":[", opts.seed_, opts.min_seconds_);
+  bool first = true;
+  bool ok = true;
+  for (int e = 0; e < ENGINE_COUNT; e++) {
+    const BenchEngine &engine = ENGINES[e];
+    if (!in_list(opts.engines_, engine.name_)) {
+      continue;
+    }
+    report += first ? "\n  " : ",\n  ";
+    first = false;
+    fprintf(stderr, "engine %s ...\n", engine.name_);
+    if (nullptr == engine.env_value_) {
+      report += "{\"engine\":";
+      json_append_string(report, engine.name_);
+      report += ",\"available\":false,\"reason\":";
+      json_append_string(report, engine.skip_reason_);
+      report += "}";
+    } else if (!run_engine(opts, engine, report)) {
+      ok = false;
+    }
+  }
+  report += "\n]}\n";
+  if (!bench_write_output(opts.output_, report)) {
+    fprintf(stderr, "failed to write %s\n", opts.output_);
+    ok = false;
+  }
+  return ok ? 0 : 1;
+}
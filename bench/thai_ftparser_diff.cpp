@@ -0,0 +1,585 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Differential test of parser variants.
+ *
+ *   thai_ftparser_diff [-p parser] [-c corpus | -f docs.txt] [-B baseline]
+ *                      [-x examples] [-d seconds] [-C] [-E] [-o out.json]
+ *                      name=plugin.so name=plugin.so ...
+ *
+ * Every variant is loaded in its own process, since they export the same
+ * symbols and each keeps its own interpreter state. All variants scan the
+ * same documents: a corpus file (-c), one document per line (-f), or by
+ * default a generated mix of Thai, English and mixed text of every shape
+ * plus documents above the 10000 byte cap and invalid UTF-8.
+ *
+ * Token streams (word bytes and char_len) are diffed against the baseline
+ * variant, the first one unless -B is given. Each differing document is
+ * classified:
+ *   error     - one side failed the scan
+ *   repeated  - one stream is the other emitted twice
+ *   prefix    - one stream is a prefix of the other (truncation, caps)
+ *   char_len  - same words, different char_len
+ *   other     - anything else
+ * Cost per variant: MB/s, documents/s, p50/p99 latency, CPU time and peak
+ * RSS of its process. With -E the exit code is 1 when any document differs.
+ *
+ * -C also checks the parser's charset fallback: every variant scans the
+ * documents once more with the worker engine pointed at an in-process
+ * worker that answers no tokens (ObHostEmptyWorker), and each document
+ * must yield exactly the tokens of a charset scan of its text, every one
+ * once and in order. A failing check makes the exit code 1. Only variants
+ * built from this tree honour OB_THAI_FTPARSER_ENGINE; the legacy ones
+ * fail it.
+ *
+ * The CMake build produces the legacy variants next to the benchmarks:
+ *   thai_ftparser_diff original=libthai_ftparser_original_variant.so \
+ *                      fixed=libthai_ftparser_fixed_variant.so \
+ *                      emergency=libthai_ftparser.so
+ */
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <vector>
+
+#include "bench_corpus.h"
+#include "bench_text.h"
+#include "bench_util.h"
+#include "ob_plugin_host.h"
+
+using namespace oceanbase::thai;
+
+namespace {
+
+const int64_t MAX_LATENCY_SAMPLES = 1 << 20;
+// 与解析器的 THAI_MAX_TOKEN_BYTES 一致，达到的 token 被丢弃
+const int64_t MAX_TOKEN_BYTES = 1000;
+
+enum DiffClass
+{
+  DIFF_ERROR = 0,
+  DIFF_REPEATED,
+  DIFF_PREFIX,
+  DIFF_CHAR_LEN,
+  DIFF_OTHER,
+  DIFF_CLASS_MAX
+};
+
+const char *DIFF_CLASS_NAMES[DIFF_CLASS_MAX] = {"error", "repeated", "prefix", "char_len", "other"};
+
+struct Token
+{
+  std::string word_;
+  int64_t     char_len_;
+
+  bool operator==(const Token &other) const { return char_len_ == other.char_len_ && word_ == other.word_; }
+};
+
+struct DocResult
+{
+  int32_t            ret_ = OBP_SUCCESS;
+  std::vector<Token> tokens_;
+};
+
+struct VariantRun
+{
+  std::string            name_;
+  std::string            path_;
+  bool                   available_ = false;
+  int64_t                docs_ = 0;
+  int64_t                bytes_ = 0;
+  double                 seconds_ = 0;
+  int64_t                p50_ns_ = 0;
+  int64_t                p99_ns_ = 0;
+  double                 cpu_seconds_ = 0;
+  int64_t                max_rss_kb_ = 0;
+  std::vector<DocResult> results_;
+  // -C：与字符集扫描不一致的文档数，-1 表示子进程没有结果
+  int64_t                fallback_differing_ = -1;
+  int64_t                fallback_first_doc_ = -1;
+};
+
+typedef std::vector<std::pair<const char *, int64_t>> DocList;
+
+template <typename T>
+void put(std::string &out, const T &value)
+{
+  out.append((const char *)&value, sizeof(value));
+}
+
+template <typename T>
+bool get(const std::string &in, size_t &pos, T &value)
+{
+  const bool ok = pos + sizeof(value) <= in.size();
+  if (ok) {
+    memcpy(&value, in.data() + pos, sizeof(value));
+    pos += sizeof(value);
+  }
+  return ok;
+}
+
+// 子进程：收集每篇文档的 token 流，再单独计时
+void run_variant_child(const char *path, const char *parser_name, const DocList &docs, double min_seconds,
+                       std::string &out)
+{
+  ObPluginHost host;
+  const ObPluginFTParser *parser = nullptr;
+  if (OBP_SUCCESS != host.load(path) || nullptr == (parser = host.parser(parser_name))) {
+    return;
+  }
+  ObHostScanner scanner(parser);
+  put(out, (uint64_t)docs.size());
+  for (size_t i = 0; i < docs.size(); i++) {
+    std::string tokens;
+    uint32_t count = 0;
+    const int32_t ret = scanner.scan(docs[i].first, docs[i].second,
+                                     [&](const char *word, int64_t word_len, int64_t char_len, int64_t) {
+        put(tokens, (uint32_t)word_len);
+        tokens.append(word, word_len);
+        put(tokens, char_len);
+        count++;
+      });
+    put(out, ret);
+    put(out, count);
+    out += tokens;
+  }
+
+  std::vector<int64_t> latency;
+  int64_t count = 0;
+  int64_t bytes = 0;
+  const int64_t min_ns = (int64_t)(min_seconds * 1e9);
+  const int64_t begin_ns = bench_now_ns();
+  int64_t elapsed_ns = 0;
+  do {
+    for (size_t i = 0; i < docs.size(); i++) {
+      int64_t tokens = 0;
+      const int64_t doc_begin_ns = bench_now_ns();
+      scanner.count(docs[i].first, docs[i].second, tokens);
+      if ((int64_t)latency.size() < MAX_LATENCY_SAMPLES) {
+        latency.push_back(bench_now_ns() - doc_begin_ns);
+      }
+      count++;
+      bytes += docs[i].second;
+    }
+    elapsed_ns = bench_now_ns() - begin_ns;
+  } while (elapsed_ns < min_ns);
+  std::sort(latency.begin(), latency.end());
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  put(out, count);
+  put(out, bytes);
+  put(out, elapsed_ns);
+  put(out, latency.empty() ? (int64_t)0 : latency[latency.size() / 2]);
+  put(out, latency.empty() ? (int64_t)0 : latency[std::min(latency.size() - 1, latency.size() * 99 / 100)]);
+  put(out, (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+           + (double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6);
+  put(out, (int64_t)usage.ru_maxrss);
+}
+
+// 与解析器的 next_charset_token 一致：字母、数字和下划线组成的连续片段，超长的丢弃
+void charset_tokens(const char *text, int64_t len, std::vector<Token> &tokens)
+{
+  const ObPluginCharsetInfoPtr cs = (ObPluginCharsetInfoPtr)host_charset();
+  const char *next = text;
+  const char *end = text + len;
+  while (next < end) {
+    const char *start = next;
+    int64_t c_nums = 0;
+    bool in_word = true;
+    while (next < end && in_word) {
+      int ctype = 0;
+      const int mbl = obp_charset_ctype(cs, &ctype, (const unsigned char *)next, (const unsigned char *)end);
+      in_word = (ctype & (OBP_CHAR_TYPE_UPPER | OBP_CHAR_TYPE_LOWER | OBP_CHAR_TYPE_NUMBER)) || '_' == *next;
+      if (in_word || next == start) {
+        c_nums += in_word ? 1 : 0;
+        next += mbl > 0 ? mbl : (mbl < 0 ? -mbl : 1);
+      }
+    }
+    if (c_nums > 0 && next - start < MAX_TOKEN_BYTES) {
+      Token token;
+      token.word_.assign(start, next - start);
+      token.char_len_ = c_nums;
+      tokens.push_back(token);
+    }
+  }
+}
+
+// 子进程：所有文档都走解析器的字符集兜底，输出与字符集扫描不一致的文档数和第一篇的下标
+void run_fallback_child(const char *path, const char *parser_name, const DocList &docs, std::string &out)
+{
+  ObHostEmptyWorker worker;
+  ObPluginHost host;
+  const ObPluginFTParser *parser = nullptr;
+  if (0 != worker.start() || OBP_SUCCESS != host.load(path) || nullptr == (parser = host.parser(parser_name))) {
+    return;
+  }
+  ObHostScanner scanner(parser);
+  int64_t differing = 0;
+  int64_t first_doc = -1;
+  for (size_t i = 0; i < docs.size(); i++) {
+    std::vector<Token> expected;
+    std::vector<Token> actual;
+    charset_tokens(docs[i].first, docs[i].second, expected);
+    const int32_t ret = scanner.scan(docs[i].first, docs[i].second,
+                                     [&](const char *word, int64_t word_len, int64_t char_len, int64_t) {
+        Token token;
+        token.word_.assign(word, word_len);
+        token.char_len_ = char_len;
+        actual.push_back(token);
+      });
+    if (OBP_SUCCESS != ret || expected != actual) {
+      first_doc = differing++ > 0 ? first_doc : (int64_t)i;
+    }
+  }
+  put(out, differing);
+  put(out, first_doc);
+}
+
+bool deserialize(const std::string &in, VariantRun &run)
+{
+  size_t pos = 0;
+  uint64_t docs = 0;
+  bool ok = get(in, pos, docs);
+  if (ok) {
+    run.results_.resize(docs);
+  }
+  for (size_t i = 0; ok && i < run.results_.size(); i++) {
+    DocResult &doc = run.results_[i];
+    uint32_t count = 0;
+    ok = get(in, pos, doc.ret_) && get(in, pos, count);
+    doc.tokens_.resize(ok ? count : 0);
+    for (size_t t = 0; ok && t < doc.tokens_.size(); t++) {
+      uint32_t len = 0;
+      ok = get(in, pos, len) && pos + len <= in.size();
+      if (ok) {
+        doc.tokens_[t].word_.assign(in.data() + pos, len);
+        pos += len;
+        ok = get(in, pos, doc.tokens_[t].char_len_);
+      }
+    }
+  }
+  int64_t elapsed_ns = 0;
+  ok = ok && get(in, pos, run.docs_) && get(in, pos, run.bytes_) && get(in, pos, elapsed_ns)
+       && get(in, pos, run.p50_ns_) && get(in, pos, run.p99_ns_) && get(in, pos, run.cpu_seconds_)
+       && get(in, pos, run.max_rss_kb_);
+  run.seconds_ = (double)elapsed_ns / 1e9;
+  return ok;
+}
+
+bool same_words(const std::vector<Token> &a, const std::vector<Token> &b)
+{
+  bool same = a.size() == b.size();
+  for (size_t i = 0; same && i < a.size(); i++) {
+    same = a[i].word_ == b[i].word_;
+  }
+  return same;
+}
+
+// a 是否等于 b 连续出现两次
+bool is_repeated(const std::vector<Token> &a, const std::vector<Token> &b)
+{
+  return !b.empty() && a.size() == 2 * b.size() && std::equal(b.begin(), b.end(), a.begin())
+         && std::equal(b.begin(), b.end(), a.begin() + b.size());
+}
+
+bool is_prefix(const std::vector<Token> &a, const std::vector<Token> &b)
+{
+  return a.size() < b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+DiffClass classify(const DocResult &base, const DocResult &other)
+{
+  DiffClass cls = DIFF_OTHER;
+  if (base.ret_ != other.ret_) {
+    cls = DIFF_ERROR;
+  } else if (is_repeated(base.tokens_, other.tokens_) || is_repeated(other.tokens_, base.tokens_)) {
+    cls = DIFF_REPEATED;
+  } else if (is_prefix(base.tokens_, other.tokens_) || is_prefix(other.tokens_, base.tokens_)) {
+    cls = DIFF_PREFIX;
+  } else if (same_words(base.tokens_, other.tokens_)) {
+    cls = DIFF_CHAR_LEN;
+  }
+  return cls;
+}
+
+void append_token(std::string &out, const std::vector<Token> &tokens, size_t idx)
+{
+  if (idx < tokens.size()) {
+    json_append_string(out, tokens[idx].word_.c_str());
+  } else {
+    out += "null";
+  }
+}
+
+void build_default_docs(uint64_t seed, std::vector<std::string> &texts)
+{
+  ObBenchTextGen gen(seed);
+  std::string doc;
+  for (int t = 0; t < OB_BENCH_SCRIPT_MAX; t++) {
+    // article 太大，Python 变体下单篇要几百毫秒，这里只用前三种形态
+    for (int64_t s = 0; s < BENCH_SHAPE_COUNT && BENCH_SHAPES[s].bytes_ <= 64 * 1024; s++) {
+      for (int i = 0; i < 32; i++) {
+        gen.generate((ObBenchScript)t, BENCH_SHAPES[s].bytes_, doc);
+        texts.push_back(doc);
+      }
+    }
+    for (int i = 0; i < 4; i++) {
+      gen.generate((ObBenchScript)t, 12000 + 8000 * i, doc);
+      texts.push_back(doc);
+    }
+  }
+  texts.push_back(" ");
+  texts.push_back("a");
+  texts.push_back("ก");
+  texts.push_back("hello_world foo-bar 123");
+  texts.push_back(std::string("\xe0\xb8", 2));
+  texts.push_back(std::string("\xff\xfe valid \xc3", 11));
+}
+
+void usage(const char *prog)
+{
+  fprintf(stderr,
+          "usage: %s [options] name=plugin.so name=plugin.so ...\n"
+          "  -p name     ftparser to use, default the first one registered\n"
+          "  -c file     documents of a corpus file written by thai_corpus_gen\n"
+          "  -f file     one document per line\n"
+          "  -S seed     seed of the default generated documents, default 42\n"
+          "  -B name     baseline variant, default the first one\n"
+          "  -x n        examples of differing documents per variant, default 5\n"
+          "  -d seconds  minimum run time of the timed pass, default 1\n"
+          "  -C          also check the charset fallback against a charset scan\n"
+          "  -E          exit 1 when any document differs from the baseline\n"
+          "  -o file     write the JSON report to file instead of stdout\n",
+          prog);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const char *parser_name = nullptr;
+  const char *corpus_path = nullptr;
+  const char *docs_path = nullptr;
+  const char *baseline_name = nullptr;
+  const char *output = nullptr;
+  int64_t max_examples = 5;
+  double min_seconds = 1.0;
+  uint64_t seed = 42;
+  bool fail_on_diff = false;
+  bool check_fallback = false;
+  int opt = 0;
+  while (-1 != (opt = getopt(argc, argv, "p:c:f:S:B:x:d:CEo:h"))) {
+    switch (opt) {
+      case 'p': parser_name = optarg; break;
+      case 'c': corpus_path = optarg; break;
+      case 'f': docs_path = optarg; break;
+      case 'S': seed = strtoull(optarg, nullptr, 10); break;
+      case 'B': baseline_name = optarg; break;
+      case 'x': max_examples = atoll(optarg); break;
+      case 'd': min_seconds = atof(optarg); break;
+      case 'C': check_fallback = true; break;
+      case 'E': fail_on_diff = true; break;
+      case 'o': output = optarg; break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  std::vector<VariantRun> variants;
+  for (int i = optind; i < argc; i++) {
+    const char *eq = strchr(argv[i], '=');
+    VariantRun run;
+    run.name_ = nullptr == eq ? argv[i] : std::string(argv[i], eq - argv[i]);
+    run.path_ = nullptr == eq ? argv[i] : eq + 1;
+    variants.push_back(run);
+  }
+  if (variants.size() < 2) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  std::vector<std::string> texts;
+  std::string content;
+  DocList docs;
+  ObBenchCorpus corpus;
+  std::string err;
+  if (nullptr != corpus_path) {
+    if (!corpus.open(corpus_path, err)) {
+      fprintf(stderr, "%s: %s\n", corpus_path, err.c_str());
+      return 1;
+    }
+    docs.resize(corpus.count());
+    for (int64_t i = 0; i < corpus.count(); i++) {
+      docs[i].first = corpus.doc(i, docs[i].second);
+    }
+  } else if (nullptr != docs_path) {
+    if (!host_read_file(docs_path, content)) {
+      fprintf(stderr, "failed to read %s\n", docs_path);
+      return 1;
+    }
+    host_split_lines(content, docs);
+  } else {
+    build_default_docs(seed, texts);
+    for (size_t i = 0; i < texts.size(); i++) {
+      docs.push_back(std::make_pair(texts[i].data(), (int64_t)texts[i].size()));
+    }
+  }
+
+  size_t base = 0;
+  for (size_t v = 0; v < variants.size(); v++) {
+    if (nullptr != baseline_name && variants[v].name_ == baseline_name) {
+      base = v;
+    }
+    fprintf(stderr, "variant %s ...\n", variants[v].name_.c_str());
+    std::string result;
+    int status = 0;
+    const bool ok = bench_run_in_child([&](std::string &out) {
+        run_variant_child(variants[v].path_.c_str(), parser_name, docs, min_seconds, out);
+      }, result, status);
+    variants[v].available_ = ok && !result.empty() && deserialize(result, variants[v])
+                             && variants[v].results_.size() == docs.size();
+    if (!variants[v].available_) {
+      fprintf(stderr, "variant %s: no result, child status=%d\n", variants[v].name_.c_str(), status);
+    }
+  }
+  if (!variants[base].available_) {
+    fprintf(stderr, "baseline variant %s is unavailable\n", variants[base].name_.c_str());
+    return 1;
+  }
+  for (size_t v = 0; check_fallback && v < variants.size(); v++) {
+    std::string result;
+    int status = 0;
+    size_t pos = 0;
+    const bool ok = bench_run_in_child([&](std::string &out) {
+        run_fallback_child(variants[v].path_.c_str(), parser_name, docs, out);
+      }, result, status);
+    if (!ok || !get(result, pos, variants[v].fallback_differing_) || !get(result, pos, variants[v].fallback_first_doc_)) {
+      variants[v].fallback_differing_ = -1;
+      fprintf(stderr, "variant %s: no charset fallback result, child status=%d\n", variants[v].name_.c_str(), status);
+    }
+  }
+
+  bool any_diff = false;
+  std::string report = "{\"benchmark\":\"thai_ftparser_diff\",";
+  json_appendf(report, "\"docs\":%zu,\"baseline\":", docs.size());
+  json_append_string(report, variants[base].name_.c_str());
+  report += ",\"variants\":[";
+  fprintf(stderr, "%-12s %8s %8s %10s %10s %9s %9s %8s %9s\n",
+          "variant", "tokens", "failed", "MB/s", "docs/s", "p50_us", "p99_us", "cpu_s", "rss_kb");
+  for (size_t v = 0; v < variants.size(); v++) {
+    const VariantRun &run = variants[v];
+    report += 0 == v ? "\n  {\"name\":" : ",\n  {\"name\":";
+    json_append_string(report, run.name_.c_str());
+    report += ",\"plugin\":";
+    json_append_string(report, run.path_.c_str());
+    if (!run.available_) {
+      report += ",\"available\":false}";
+      continue;
+    }
+    int64_t tokens = 0;
+    int64_t failed = 0;
+    for (size_t i = 0; i < run.results_.size(); i++) {
+      tokens += (int64_t)run.results_[i].tokens_.size();
+      failed += OBP_SUCCESS != run.results_[i].ret_ ? 1 : 0;
+    }
+    const double mb_per_s = run.seconds_ > 0 ? (double)run.bytes_ / run.seconds_ / 1e6 : 0;
+    const double docs_per_s = run.seconds_ > 0 ? (double)run.docs_ / run.seconds_ : 0;
+    json_appendf(report, ",\"available\":true,\"tokens\":%ld,\"failed_docs\":%ld,\"mb_per_s\":%.3f,"
+                 "\"docs_per_s\":%.1f,\"p50_us\":%.1f,\"p99_us\":%.1f,\"cpu_seconds\":%.3f,\"max_rss_kb\":%ld}",
+                 tokens, failed, mb_per_s, docs_per_s, (double)run.p50_ns_ / 1e3, (double)run.p99_ns_ / 1e3,
+                 run.cpu_seconds_, run.max_rss_kb_);
+    fprintf(stderr, "%-12s %8ld %8ld %10.2f %10.1f %9.1f %9.1f %8.2f %9ld\n",
+            run.name_.c_str(), tokens, failed, mb_per_s, docs_per_s, (double)run.p50_ns_ / 1e3,
+            (double)run.p99_ns_ / 1e3, run.cpu_seconds_, run.max_rss_kb_);
+  }
+  report += "\n],\"diffs\":[";
+
+  bool first = true;
+  for (size_t v = 0; v < variants.size(); v++) {
+    if (v == base || !variants[v].available_) {
+      continue;
+    }
+    const VariantRun &b = variants[base];
+    const VariantRun &o = variants[v];
+    int64_t classes[DIFF_CLASS_MAX] = {0};
+    int64_t differing = 0;
+    std::string examples;
+    for (size_t i = 0; i < docs.size(); i++) {
+      const DocResult &br = b.results_[i];
+      const DocResult &orr = o.results_[i];
+      if (br.ret_ == orr.ret_ && br.tokens_ == orr.tokens_) {
+        continue;
+      }
+      const DiffClass cls = classify(br, orr);
+      classes[cls]++;
+      if (differing++ < max_examples) {
+        size_t at = 0;
+        while (at < br.tokens_.size() && at < orr.tokens_.size() && br.tokens_[at] == orr.tokens_[at]) {
+          at++;
+        }
+        examples += examples.empty() ? "" : ",";
+        json_appendf(examples, "{\"doc\":%zu,\"class\":\"%s\",\"doc_bytes\":%ld,\"ret\":[%d,%d],"
+                     "\"tokens\":[%zu,%zu],\"first_diff\":%zu,\"tokens_at_diff\":[",
+                     i, DIFF_CLASS_NAMES[cls], docs[i].second, br.ret_, orr.ret_,
+                     br.tokens_.size(), orr.tokens_.size(), at);
+        append_token(examples, br.tokens_, at);
+        examples += ",";
+        append_token(examples, orr.tokens_, at);
+        examples += "]}";
+      }
+    }
+    any_diff = any_diff || differing > 0;
+    report += first ? "\n  {\"variant\":" : ",\n  {\"variant\":";
+    first = false;
+    json_append_string(report, o.name_.c_str());
+    json_appendf(report, ",\"identical_docs\":%zu,\"differing_docs\":%ld,\"classes\":{",
+                 docs.size() - differing, differing);
+    fprintf(stderr, "%s vs %s: %ld of %zu documents differ",
+                    o.name_.c_str(), b.name_.c_str(), differing, docs.size());
+    for (int c = 0; c < DIFF_CLASS_MAX; c++) {
+      json_appendf(report, "%s\"%s\":%ld", 0 == c ? "" : ",", DIFF_CLASS_NAMES[c], classes[c]);
+      if (classes[c] > 0) {
+        fprintf(stderr, ", %s=%ld", DIFF_CLASS_NAMES[c], classes[c]);
+      }
+    }
+    fprintf(stderr, "\n");
+    report += "},\"examples\":[" + examples + "]}";
+  }
+  report += "\n]";
+
+  bool fallback_failed = false;
+  if (check_fallback) {
+    report += ",\"charset_fallback\":[";
+    for (size_t v = 0; v < variants.size(); v++) {
+      const VariantRun &run = variants[v];
+      report += 0 == v ? "\n  {\"variant\":" : ",\n  {\"variant\":";
+      json_append_string(report, run.name_.c_str());
+      json_appendf(report, ",\"differing_docs\":%ld,\"first_doc\":%ld}", run.fallback_differing_, run.fallback_first_doc_);
+      fprintf(stderr, "%s charset fallback: %ld of %zu documents differ from a charset scan\n",
+              run.name_.c_str(), run.fallback_differing_, docs.size());
+      fallback_failed = fallback_failed || 0 != run.fallback_differing_;
+    }
+    report += "\n]";
+  }
+  report += "}\n";
+  if (!bench_write_output(output, report)) {
+    fprintf(stderr, "failed to write %s\n", output);
+    return 1;
+  }
+  return ((fail_on_diff && any_diff) || fallback_failed) ? 1 : 0;
+}
@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Multi-thread scaling of the plugin.
+ *
+ *   thai_ftparser_scaling [-p parser] [-e engine] [-T 1,2,4,...] [-s shape]
+ *                         [-t script] [-c corpus] [-d seconds] [-S seed] [-o out.json] plugin.so
+ *
+ * For every thread count all threads loop scan_begin/next_token/scan_end
+ * over a shared pool of documents for -d seconds. Reported per step:
+ * throughput, speedup and efficiency against one thread, and p50/p99/p999
+ * latency of a whole document scan. The plugin's lock contention report
+ * of each step is attached when the plugin exports it. With -c the pool is
+ * a corpus file written by thai_corpus_gen instead of generated documents.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "bench_corpus.h"
+#include "bench_text.h"
+#include "bench_util.h"
+#include "ob_plugin_host.h"
+
+using namespace oceanbase::thai;
+
+namespace {
+
+const int64_t POOL_DOCS = 512;
+const int64_t MAX_SAMPLES_PER_THREAD = 1 << 20;   // 延迟样本上限，超过后按步长抽样
+
+typedef std::vector<std::pair<const char *, int64_t>> DocList;
+
+struct ThreadResult
+{
+  int64_t              docs_ = 0;
+  int64_t              bytes_ = 0;
+  int64_t              tokens_ = 0;
+  int64_t              failed_ = 0;
+  std::vector<int64_t> latency_ns_;
+};
+
+struct StepResult
+{
+  int64_t threads_ = 0;
+  int64_t docs_ = 0;
+  int64_t bytes_ = 0;
+  int64_t tokens_ = 0;
+  int64_t failed_ = 0;
+  double  seconds_ = 0;
+  int64_t p50_ns_ = 0;
+  int64_t p99_ns_ = 0;
+  int64_t p999_ns_ = 0;
+  int64_t max_ns_ = 0;
+};
+
+int64_t percentile(const std::vector<int64_t> &sorted, double pct)
+{
+  int64_t value = 0;
+  if (!sorted.empty()) {
+    size_t rank = (size_t)(pct / 100.0 * (double)sorted.size());
+    value = sorted[rank < sorted.size() ? rank : sorted.size() - 1];
+  }
+  return value;
+}
+
+void worker(const ObHostScanner &scanner, const DocList &pool, int64_t thread_idx,
+            const std::atomic<bool> &start, const std::atomic<bool> &stop, ThreadResult &result)
+{
+  result.latency_ns_.reserve(64 * 1024);
+  while (!start.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+  // 各线程从不同位置开始，避免同时处理同一篇文档
+  int64_t idx = (thread_idx * 7919) % (int64_t)pool.size();
+  int64_t stride = 1;
+  while (!stop.load(std::memory_order_relaxed)) {
+    const DocList::value_type &doc = pool[idx];
+    int64_t tokens = 0;
+    const int64_t begin_ns = bench_now_ns();
+    if (OBP_SUCCESS != scanner.count(doc.first, doc.second, tokens)) {
+      result.failed_++;
+    }
+    const int64_t elapsed_ns = bench_now_ns() - begin_ns;
+    if (0 == result.docs_ % stride) {
+      result.latency_ns_.push_back(elapsed_ns);
+      if ((int64_t)result.latency_ns_.size() >= MAX_SAMPLES_PER_THREAD) {
+        // 样本满后隔一个丢一个，步长加倍
+        size_t keep = 0;
+        for (size_t i = 0; i < result.latency_ns_.size(); i += 2) {
+          result.latency_ns_[keep++] = result.latency_ns_[i];
+        }
+        result.latency_ns_.resize(keep);
+        stride *= 2;
+      }
+    }
+    result.docs_++;
+    result.bytes_ += doc.second;
+    result.tokens_ += tokens;
+    idx = idx + 1 < (int64_t)pool.size() ? idx + 1 : 0;
+  }
+}
+
+StepResult run_step(const ObHostScanner &scanner, const DocList &pool,
+                    int64_t thread_count, double seconds)
+{
+  std::atomic<bool> start(false);
+  std::atomic<bool> stop(false);
+  std::vector<ThreadResult> results(thread_count);
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  for (int64_t i = 0; i < thread_count; i++) {
+    threads.emplace_back(worker, std::cref(scanner), std::cref(pool), i,
+                         std::cref(start), std::cref(stop), std::ref(results[i]));
+  }
+  const int64_t begin_ns = bench_now_ns();
+  start.store(true, std::memory_order_release);
+  usleep((useconds_t)(seconds * 1e6));
+  stop.store(true, std::memory_order_relaxed);
+  for (size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+  const int64_t elapsed_ns = bench_now_ns() - begin_ns;
+
+  StepResult step;
+  step.threads_ = thread_count;
+  step.seconds_ = (double)elapsed_ns / 1e9;
+  std::vector<int64_t> latency;
+  for (size_t i = 0; i < results.size(); i++) {
+    step.docs_ += results[i].docs_;
+    step.bytes_ += results[i].bytes_;
+    step.tokens_ += results[i].tokens_;
+    step.failed_ += results[i].failed_;
+    latency.insert(latency.end(), results[i].latency_ns_.begin(), results[i].latency_ns_.end());
+  }
+  std::sort(latency.begin(), latency.end());
+  step.p50_ns_ = percentile(latency, 50);
+  step.p99_ns_ = percentile(latency, 99);
+  step.p999_ns_ = percentile(latency, 99.9);
+  step.max_ns_ = latency.empty() ? 0 : latency.back();
+  return step;
+}
+
+void usage(const char *prog)
+{
+  fprintf(stderr,
+          "usage: %s [options] plugin.so\n"
+          "  -p name     ftparser to use, default the first one registered\n"
+          "  -e engine   sets OB_THAI_FTPARSER_ENGINE before loading the plugin\n"
+          "  -T list     thread counts, default 1,2,4,8,16,32,64\n"
+          "  -s shape    query, title (default), description or article\n"
+          "  -t script   thai, english or mixed (default)\n"
+          "  -c file     use the documents of a corpus file instead of -s/-t\n"
+          "  -d seconds  run time of each step, default 2\n"
+          "  -S seed     seed of the generated documents, default 42\n"
+          "  -o file     write the JSON report to file instead of stdout\n",
+          prog);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const char *parser_name = nullptr;
+  const char *engine = nullptr;
+  const char *output = nullptr;
+  const char *corpus_path = nullptr;
+  const char *shape_name = "title";
+  const char *script_name = "mixed";
+  std::string thread_list = "1,2,4,8,16,32,64";
+  double seconds = 2.0;
+  uint64_t seed = 42;
+  int opt = 0;
+  while (-1 != (opt = getopt(argc, argv, "p:e:T:s:t:c:d:S:o:h"))) {
+    switch (opt) {
+      case 'p': parser_name = optarg; break;
+      case 'e': engine = optarg; break;
+      case 'T': thread_list = optarg; break;
+      case 's': shape_name = optarg; break;
+      case 't': script_name = optarg; break;
+      case 'c': corpus_path = optarg; break;
+      case 'd': seconds = atof(optarg); break;
+      case 'S': seed = strtoull(optarg, nullptr, 10); break;
+      case 'o': output = optarg; break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  const ObBenchShape *shape = nullptr;
+  for (int64_t i = 0; i < BENCH_SHAPE_COUNT; i++) {
+    if (0 == strcmp(shape_name, BENCH_SHAPES[i].name_)) {
+      shape = &BENCH_SHAPES[i];
+    }
+  }
+  const ObBenchScript script = get_bench_script(script_name);
+  std::vector<int64_t> thread_counts;
+  for (const char *p = thread_list.c_str(); '\0' != *p;) {
+    char *end = nullptr;
+    const long long n = strtoll(p, &end, 10);
+    if (end == p || n <= 0) {
+      thread_counts.clear();
+      break;
+    }
+    thread_counts.push_back(n);
+    p = (',' == *end) ? end + 1 : end;
+  }
+  if (optind >= argc || nullptr == shape || OB_BENCH_SCRIPT_MAX == script || thread_counts.empty()) {
+    usage(argv[0]);
+    return 2;
+  }
+  const char *plugin = argv[optind];
+  if (nullptr != engine) {
+    setenv("OB_THAI_FTPARSER_ENGINE", engine, 1);
+  }
+
+  ObPluginHost host;
+  const ObPluginFTParser *parser = nullptr;
+  if (OBP_SUCCESS != host.load(plugin) || nullptr == (parser = host.parser(parser_name))) {
+    fprintf(stderr, "failed to load %s\n", plugin);
+    return 1;
+  }
+  typedef int64_t (*ReportFunc)(char *, int64_t);
+  ReportFunc contention_report = (ReportFunc)host.symbol("thai_ftparser_contention_report");
+  ObHostScanner scanner(parser);
+
+  std::vector<std::string> texts;
+  DocList pool;
+  ObBenchCorpus corpus;
+  if (nullptr != corpus_path) {
+    std::string err;
+    if (!corpus.open(corpus_path, err) || 0 == corpus.count()) {
+      fprintf(stderr, "%s: %s\n", corpus_path, err.empty() ? "empty corpus" : err.c_str());
+      return 1;
+    }
+    pool.resize(corpus.count());
+    for (int64_t i = 0; i < corpus.count(); i++) {
+      pool[i].first = corpus.doc(i, pool[i].second);
+    }
+  } else {
+    texts.resize(POOL_DOCS);
+    pool.resize(POOL_DOCS);
+    ObBenchTextGen gen(seed);
+    for (size_t i = 0; i < texts.size(); i++) {
+      gen.generate(script, shape->bytes_, texts[i]);
+      pool[i] = std::make_pair(texts[i].data(), (int64_t)texts[i].size());
+    }
+  }
+
+  // 预热：触发插件的一次性初始化(Python 解释器、模块导入)
+  run_step(scanner, pool, 1, seconds / 10);
+  if (nullptr != contention_report) {
+    char discard[256];
+    contention_report(discard, sizeof(discard));
+  }
+
+  std::string report = "{\"benchmark\":\"thai_ftparser_scaling\",\"plugin\":";
+  json_append_string(report, plugin);
+  report += ",\"engine\":";
+  json_append_string(report, nullptr != engine ? engine : "");
+  report += ",\"corpus\":";
+  json_append_string(report, nullptr != corpus_path ? corpus_path : "");
+  json_appendf(report, ",\"shape\":\"%s\",\"script\":\"%s\",\"seed\":%lu,\"seconds\":%.3f,"
+               "\"hardware_threads\":%u,\"steps\":[",
+               shape->name_, get_bench_script_name(script), seed, seconds,
+               std::thread::hardware_concurrency());
+  double base_docs_per_s = 0;
+  std::vector<char> buf(16384);
+  for (size_t i = 0; i < thread_counts.size(); i++) {
+    fprintf(stderr, "threads=%ld ...\n", thread_counts[i]);
+    const StepResult step = run_step(scanner, pool, thread_counts[i], seconds);
+    const double docs_per_s = (double)step.docs_ / step.seconds_;
+    if (0 == i) {
+      base_docs_per_s = docs_per_s / (double)step.threads_;
+    }
+    const double speedup = base_docs_per_s > 0 ? docs_per_s / base_docs_per_s : 0;
+    report += 0 == i ? "\n  " : ",\n  ";
+    json_appendf(report, "{\"threads\":%ld,\"docs\":%ld,\"bytes\":%ld,\"tokens\":%ld,\"failed\":%ld,"
+                 "\"seconds\":%.6f,\"docs_per_s\":%.1f,\"mb_per_s\":%.3f,\"tokens_per_s\":%.1f,"
+                 "\"speedup\":%.3f,\"efficiency\":%.3f,",
+                 step.threads_, step.docs_, step.bytes_, step.tokens_, step.failed_,
+                 step.seconds_, docs_per_s, (double)step.bytes_ / step.seconds_ / 1e6,
+                 (double)step.tokens_ / step.seconds_, speedup, speedup / (double)step.threads_);
+    json_appendf(report, "\"latency_us\":{\"p50\":%.1f,\"p99\":%.1f,\"p999\":%.1f,\"max\":%.1f}",
+                 (double)step.p50_ns_ / 1e3, (double)step.p99_ns_ / 1e3,
+                 (double)step.p999_ns_ / 1e3, (double)step.max_ns_ / 1e3);
+    if (nullptr != contention_report) {
+      contention_report(buf.data(), (int64_t)buf.size());
+      report += ",\"contention\":";
+      json_append_string(report, buf.data());
+    }
+    report += "}";
+  }
+  report += "\n]}\n";
+  if (!bench_write_output(output, report)) {
+    fprintf(stderr, "failed to write %s\n", output);
+    return 1;
+  }
+  return 0;
+}
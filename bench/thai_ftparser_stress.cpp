@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Concurrency stress reproducer of the SIGABRT described in
+ * crash_root_cause_analysis.md (460 worker threads indexing documents).
+ *
+ *   thai_ftparser_stress [-p parser] [-n threads] [-d seconds] [-P pause_sec]
+ *                        [-F failure_rate] [-w stall_sec] [-k] plugin.so
+ *
+ * Workers scan a mix of Thai, English and mixed documents plus the hostile
+ * ones: texts above the 10000 byte cap, ones cut inside a UTF-8 sequence,
+ * invalid UTF-8 and near empty texts. Every -P seconds all workers park at
+ * a barrier until the plugin's last Python user is gone, then restart at
+ * once: a teardown followed by a concurrent re-initialization storm.
+ * With -F a fake thai_tokenizer module is put first on PYTHONPATH; it fails
+ * at the given rate (raises, returns a non list, returns bad items).
+ *
+ * A watchdog reports any scan running longer than -w seconds, or no
+ * progress at all, then aborts (-k: exit 3 instead) so a core is left.
+ * Exit 0 means no stall, no scan error and no emergency shutdown.
+ */
+
+#include <atomic>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "bench_text.h"
+#include "bench_util.h"
+#include "ob_plugin_host.h"
+
+using namespace oceanbase::thai;
+
+namespace {
+
+enum DocKind
+{
+  DOC_THAI = 0,
+  DOC_ENGLISH,
+  DOC_MIXED,
+  DOC_OVER_CAP,        // 超过 10000 字节上限
+  DOC_CUT_UTF8,        // 在 UTF-8 序列中间截断
+  DOC_INVALID_UTF8,
+  DOC_TINY,            // 1~3 字节，可能只有空白
+  DOC_KIND_MAX
+};
+
+const char *DOC_KIND_NAMES[DOC_KIND_MAX] = {
+  "thai", "english", "mixed", "over_cap", "cut_utf8", "invalid_utf8", "tiny",
+};
+
+enum ScanPhase
+{
+  PHASE_IDLE = 0,
+  PHASE_SCAN,
+  PHASE_PARKED,
+};
+
+struct alignas(64) WorkerState
+{
+  std::atomic<int64_t> scan_begin_ns_{0};    // 0 表示不在扫描中
+  std::atomic<int>     phase_{PHASE_IDLE};
+  std::atomic<int>     kind_{0};
+  std::atomic<int64_t> docs_{0};
+  std::atomic<int64_t> failed_{0};
+};
+
+struct StressContext
+{
+  const ObHostScanner *                 scanner_ = nullptr;
+  std::vector<std::vector<std::string>> docs_;   // 按 DocKind 分组
+  std::vector<WorkerState>              workers_;
+  std::atomic<bool>                     stop_{false};
+  std::atomic<bool>                     pause_{false};
+  std::atomic<int64_t>                  parked_{0};
+
+  explicit StressContext(int64_t threads) : docs_(DOC_KIND_MAX), workers_(threads) {}
+};
+
+// -F 使用的故障注入模块，接口与 thai_tokenizer 一致
+const char *FAKE_TOKENIZER =
+  "import os, random\n"
+  "_RATE = float(os.environ.get('THAI_STRESS_FAILURE_RATE', '0.05'))\n"
+  "class Tokenizer:\n"
+  "    def __init__(self):\n"
+  "        if random.random() < _RATE / 4:\n"
+  "            raise RuntimeError('induced init failure')\n"
+  "    def split(self, text):\n"
+  "        r = random.random()\n"
+  "        if r < _RATE / 3:\n"
+  "            raise RuntimeError('induced split failure')\n"
+  "        if r < _RATE * 2 / 3:\n"
+  "            return 'not a list'\n"
+  "        if r < _RATE:\n"
+  "            return [None, 42, '', 'x' * 2000] + text.split()\n"
+  "        return [text[i:i + 3] for i in range(0, len(text), 3)]\n";
+
+void build_docs(StressContext &ctx, uint64_t seed)
+{
+  ObBenchTextGen gen(seed);
+  const int64_t per_kind = 64;
+  for (int64_t i = 0; i < per_kind; i++) {
+    std::string doc;
+    gen.generate(OB_BENCH_SCRIPT_THAI, 100 + gen.uniform(4000), doc);
+    ctx.docs_[DOC_THAI].push_back(doc);
+    gen.generate(OB_BENCH_SCRIPT_ENGLISH, 100 + gen.uniform(4000), doc);
+    ctx.docs_[DOC_ENGLISH].push_back(doc);
+    gen.generate(OB_BENCH_SCRIPT_MIXED, 100 + gen.uniform(4000), doc);
+    ctx.docs_[DOC_MIXED].push_back(doc);
+    gen.generate(OB_BENCH_SCRIPT_THAI, 10001 + gen.uniform(60000), doc);
+    ctx.docs_[DOC_OVER_CAP].push_back(doc);
+    // 泰文字符占 3 字节，截掉 1~2 字节留下不完整的序列
+    gen.generate(OB_BENCH_SCRIPT_THAI, 50 + gen.uniform(2000), doc);
+    doc.resize(doc.size() > 3 ? doc.size() - 1 - gen.uniform(2) : doc.size());
+    ctx.docs_[DOC_CUT_UTF8].push_back(doc);
+    doc.clear();
+    for (int64_t n = 8 + gen.uniform(512); n > 0; n--) {
+      doc.push_back((char)(0x80 + gen.uniform(0x80)));
+    }
+    ctx.docs_[DOC_INVALID_UTF8].push_back(doc);
+    static const char *TINY[] = {" ", "\n", "a", "ก", " \t", "1 2"};
+    ctx.docs_[DOC_TINY].push_back(TINY[i % (sizeof(TINY) / sizeof(TINY[0]))]);
+  }
+}
+
+void worker(StressContext &ctx, int64_t idx, uint64_t seed)
+{
+  WorkerState &state = ctx.workers_[idx];
+  ObBenchTextGen rng(seed + (uint64_t)idx * 1000003ULL);
+  while (!ctx.stop_.load(std::memory_order_relaxed)) {
+    if (ctx.pause_.load(std::memory_order_acquire)) {
+      state.phase_.store(PHASE_PARKED, std::memory_order_relaxed);
+      ctx.parked_.fetch_add(1);
+      while (ctx.pause_.load(std::memory_order_acquire) && !ctx.stop_.load(std::memory_order_relaxed)) {
+        usleep(1000);
+      }
+      ctx.parked_.fetch_sub(1);
+      state.phase_.store(PHASE_IDLE, std::memory_order_relaxed);
+      continue;
+    }
+    const int kind = (int)rng.uniform(DOC_KIND_MAX);
+    const std::vector<std::string> &docs = ctx.docs_[kind];
+    const std::string &doc = docs[rng.uniform(docs.size())];
+    state.kind_.store(kind, std::memory_order_relaxed);
+    state.phase_.store(PHASE_SCAN, std::memory_order_relaxed);
+    state.scan_begin_ns_.store(bench_now_ns(), std::memory_order_relaxed);
+    int64_t tokens = 0;
+    const int ret = ctx.scanner_->count(doc.data(), (int64_t)doc.size(), tokens);
+    state.scan_begin_ns_.store(0, std::memory_order_relaxed);
+    state.phase_.store(PHASE_IDLE, std::memory_order_relaxed);
+    if (OBP_SUCCESS != ret) {
+      state.failed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    state.docs_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+int64_t total_docs(const StressContext &ctx)
+{
+  int64_t docs = 0;
+  for (size_t i = 0; i < ctx.workers_.size(); i++) {
+    docs += ctx.workers_[i].docs_.load(std::memory_order_relaxed);
+  }
+  return docs;
+}
+
+// 报告卡住的线程和插件的锁统计，然后中止进程留下 core
+void report_stall(const StressContext &ctx, const ObPluginHost &host, int64_t stall_ns, bool keep_core,
+                  const char *reason)
+{
+  const int64_t now = bench_now_ns();
+  fprintf(stderr, "\n=== STALL DETECTED: %s ===\n", reason);
+  int64_t stuck = 0;
+  for (size_t i = 0; i < ctx.workers_.size(); i++) {
+    const int64_t begin = ctx.workers_[i].scan_begin_ns_.load(std::memory_order_relaxed);
+    if (0 != begin && now - begin > stall_ns) {
+      if (stuck++ < 32) {
+        fprintf(stderr, "worker %zu: in scan for %.1fs, document kind %s\n", i, (double)(now - begin) / 1e9,
+                DOC_KIND_NAMES[ctx.workers_[i].kind_.load(std::memory_order_relaxed)]);
+      }
+    }
+  }
+  fprintf(stderr, "%ld workers stuck in a scan, %ld parked, %ld documents done\n",
+          stuck, ctx.parked_.load(), total_docs(ctx));
+  typedef int64_t (*ReportFunc)(char *, int64_t);
+  ReportFunc contention = (ReportFunc)host.symbol("thai_ftparser_contention_report");
+  if (nullptr != contention) {
+    std::vector<char> buf(16384);
+    contention(buf.data(), (int64_t)buf.size());
+    fprintf(stderr, "contention: %s\n", buf.data());
+  }
+  fflush(stderr);
+  if (keep_core) {
+    // 插件会接管 SIGABRT，这里恢复默认处理以确保生成 core
+    signal(SIGABRT, SIG_DFL);
+    abort();
+  }
+  _exit(3);
+}
+
+void usage(const char *prog)
+{
+  fprintf(stderr,
+          "usage: %s [options] plugin.so\n"
+          "  -p name     ftparser to use, default the first one registered\n"
+          "  -n threads  worker threads, default 460\n"
+          "  -d seconds  run time, default 60\n"
+          "  -P seconds  interval of the teardown/re-init barrier, default 5, 0 disables\n"
+          "  -F rate     use a fake thai_tokenizer failing at this rate (0..1)\n"
+          "  -w seconds  a scan longer than this is a stall, default 10\n"
+          "  -k          exit 3 on a stall instead of aborting with a core\n"
+          "  -S seed     seed of the documents, default 42\n",
+          prog);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const char *parser_name = nullptr;
+  int64_t threads = 460;
+  double seconds = 60;
+  double pause_interval = 5;
+  double failure_rate = -1;
+  double stall_sec = 10;
+  bool keep_core = true;
+  uint64_t seed = 42;
+  int opt = 0;
+  while (-1 != (opt = getopt(argc, argv, "p:n:d:P:F:w:kS:h"))) {
+    switch (opt) {
+      case 'p': parser_name = optarg; break;
+      case 'n': threads = atoll(optarg); break;
+      case 'd': seconds = atof(optarg); break;
+      case 'P': pause_interval = atof(optarg); break;
+      case 'F': failure_rate = atof(optarg); break;
+      case 'w': stall_sec = atof(optarg); break;
+      case 'k': keep_core = false; break;
+      case 'S': seed = strtoull(optarg, nullptr, 10); break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  if (optind >= argc || threads <= 0 || stall_sec <= 0) {
+    usage(argv[0]);
+    return 2;
+  }
+  const char *plugin = argv[optind];
+
+  if (failure_rate >= 0) {
+    // 解释器在插件第一次分词时才初始化，此前设置的环境变量都会生效
+    char dir[] = "/tmp/thai_stress_XXXXXX";
+    if (nullptr == mkdtemp(dir)) {
+      fprintf(stderr, "mkdtemp failed\n");
+      return 1;
+    }
+    const std::string module = std::string(dir) + "/thai_tokenizer.py";
+    if (!bench_write_output(module.c_str(), FAKE_TOKENIZER)) {
+      fprintf(stderr, "failed to write %s\n", module.c_str());
+      return 1;
+    }
+    const char *old_path = getenv("PYTHONPATH");
+    const std::string path = std::string(dir) + (nullptr != old_path ? std::string(":") + old_path : "");
+    setenv("PYTHONPATH", path.c_str(), 1);
+    char rate[32];
+    snprintf(rate, sizeof(rate), "%g", failure_rate);
+    setenv("THAI_STRESS_FAILURE_RATE", rate, 1);
+    fprintf(stderr, "fake thai_tokenizer in %s, failure rate %s\n", dir, rate);
+  }
+
+  ObPluginHost host;
+  const ObPluginFTParser *parser = nullptr;
+  if (OBP_SUCCESS != host.load(plugin) || nullptr == (parser = host.parser(parser_name))) {
+    fprintf(stderr, "failed to load %s\n", plugin);
+    return 1;
+  }
+  ObHostScanner scanner(parser);
+  StressContext ctx(threads);
+  ctx.scanner_ = &scanner;
+  build_docs(ctx, seed);
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (int64_t i = 0; i < threads; i++) {
+    workers.emplace_back(worker, std::ref(ctx), i, seed);
+  }
+  fprintf(stderr, "%ld workers started for %.0fs\n", threads, seconds);
+
+  const int64_t stall_ns = (int64_t)(stall_sec * 1e9);
+  const int64_t begin_ns = bench_now_ns();
+  const int64_t end_ns = begin_ns + (int64_t)(seconds * 1e9);
+  int64_t next_pause_ns = pause_interval > 0 ? begin_ns + (int64_t)(pause_interval * 1e9) : INT64_MAX;
+  int64_t next_status_ns = begin_ns + 5000000000LL;
+  int64_t last_docs = 0;
+  int64_t last_progress_ns = begin_ns;
+  int64_t cycles = 0;
+  int64_t pause_begin_ns = 0;
+  for (int64_t now = bench_now_ns(); now < end_ns; now = bench_now_ns()) {
+    usleep(100000);
+    // 看门狗：单个扫描超时或整体没有进展
+    for (size_t i = 0; i < ctx.workers_.size(); i++) {
+      const int64_t scan_begin = ctx.workers_[i].scan_begin_ns_.load(std::memory_order_relaxed);
+      if (0 != scan_begin && now - scan_begin > stall_ns) {
+        report_stall(ctx, host, stall_ns, keep_core, "scan exceeded the stall threshold");
+      }
+    }
+    const int64_t docs = total_docs(ctx);
+    if (docs != last_docs || ctx.pause_.load()) {
+      last_docs = docs;
+      last_progress_ns = now;
+    } else if (now - last_progress_ns > stall_ns) {
+      report_stall(ctx, host, stall_ns, keep_core, "no document finished");
+    }
+    // 屏障：全部线程停下后等最后一个 Python 用户释放，再同时放行
+    if (!ctx.pause_.load() && now >= next_pause_ns) {
+      ctx.pause_.store(true, std::memory_order_release);
+      pause_begin_ns = now;
+    } else if (ctx.pause_.load()) {
+      if (ctx.parked_.load() == threads) {
+        usleep(50000);
+        ctx.pause_.store(false, std::memory_order_release);
+        cycles++;
+        next_pause_ns = bench_now_ns() + (int64_t)(pause_interval * 1e9);
+      } else if (now - pause_begin_ns > stall_ns) {
+        report_stall(ctx, host, stall_ns, keep_core, "workers did not reach the barrier");
+      }
+    }
+    if (now >= next_status_ns) {
+      fprintf(stderr, "[%3.0fs] docs=%ld, teardown cycles=%ld\n", (double)(now - begin_ns) / 1e9, docs, cycles);
+      next_status_ns += 5000000000LL;
+    }
+  }
+  ctx.stop_.store(true);
+  ctx.pause_.store(false);
+  for (size_t i = 0; i < workers.size(); i++) {
+    workers[i].join();
+  }
+
+  int64_t docs = 0;
+  int64_t failed = 0;
+  for (size_t i = 0; i < ctx.workers_.size(); i++) {
+    docs += ctx.workers_[i].docs_.load();
+    failed += ctx.workers_[i].failed_.load();
+  }
+  // 插件捕获 SIGSEGV/SIGABRT 后进入紧急模式，统计里能看到
+  bool emergency = false;
+  typedef int64_t (*ReportFunc)(char *, int64_t);
+  ReportFunc snapshot = (ReportFunc)host.symbol("thai_ftparser_stats_snapshot");
+  if (nullptr != snapshot) {
+    std::vector<char> buf(4096);
+    snapshot(buf.data(), (int64_t)buf.size());
+    fprintf(stderr, "plugin stats: %s\n", buf.data());
+    const char *p = strstr(buf.data(), "emergency={docs=");
+    emergency = nullptr != p && 0 != atoll(p + strlen("emergency={docs="));
+  }
+  fprintf(stderr, "done: docs=%ld, failed scans=%ld, teardown cycles=%ld, emergency=%s\n",
+          docs, failed, cycles, emergency ? "yes" : "no");
+  return (0 == failed && !emergency) ? 0 : 1;
+}
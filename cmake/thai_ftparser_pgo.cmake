@@ -0,0 +1,137 @@
+# 剖析反馈优化 (PGO) 和链接时优化 (LTO)
+#
+# THAI_FTPARSER_PGO=ON 时，编译 thai_ftparser_core 和插件之前先在 ${CMAKE_BINARY_DIR}/pgo
+# 下配置并构建一份插桩版本，用固定种子生成的基准语料跑 thai_engine_bench 和独立宿主
+# 程序收集剖析数据，再带着剖析数据和 LTO 编译核心库和插件。整个流程挂在插件目标的
+# 依赖上，构建 thai_ftparser 即可复现；源文件变化后自动重新训练。
+#
+# THAI_FTPARSER_PGO_GENERATE 只在插桩构建内部使用：剖析数据写到该目录。
+
+IF(CMAKE_BUILD_TYPE STREQUAL "Release")
+  SET(thai_pgo_default ON)
+ELSE()
+  SET(thai_pgo_default OFF)
+ENDIF()
+OPTION(THAI_FTPARSER_PGO "Build the core library and the plugin with profile feedback and LTO, default ON for Release" ${thai_pgo_default})
+SET(THAI_FTPARSER_PGO_DOCS 2000 CACHE STRING "Documents in the PGO training corpus")
+SET(THAI_FTPARSER_PGO_WORDS "" CACHE FILEPATH "Word list of the dict engine during PGO training, default the built-in benchmark words")
+SET(THAI_FTPARSER_PGO_GENERATE "" CACHE PATH "Internal: build instrumented binaries writing profiles to this directory")
+MARK_AS_ADVANCED(THAI_FTPARSER_PGO_DOCS THAI_FTPARSER_PGO_WORDS THAI_FTPARSER_PGO_GENERATE)
+
+IF(NOT THAI_FTPARSER_PGO AND NOT THAI_FTPARSER_PGO_GENERATE)
+  RETURN()
+ENDIF()
+
+# GCC 的剖析文件按目标文件的绝对路径命名，插桩构建和正式构建不在同一目录，
+# 需要 -fprofile-prefix-path (GCC 11) 把路径换成相对构建目录的
+IF(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+  IF(CMAKE_CXX_COMPILER_VERSION VERSION_LESS 11)
+    MESSAGE(FATAL_ERROR "THAI_FTPARSER_PGO needs GCC 11 or later, found ${CMAKE_CXX_COMPILER_VERSION}")
+  ENDIF()
+ELSEIF(NOT CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+  MESSAGE(FATAL_ERROR "THAI_FTPARSER_PGO supports GCC and Clang, found ${CMAKE_CXX_COMPILER_ID}")
+ENDIF()
+
+SET(thai_pgo_targets thai_ftparser_core)
+IF(TARGET ${PLUGIN_NAME})
+  LIST(APPEND thai_pgo_targets ${PLUGIN_NAME})
+ENDIF()
+
+IF(THAI_FTPARSER_PGO_GENERATE)
+  # 插桩构建：计数器原子更新，宿主程序和基准测试可以多线程驱动插件
+  SET(thai_pgo_flags -fprofile-generate=${THAI_FTPARSER_PGO_GENERATE} -fprofile-update=prefer-atomic)
+  IF(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+    LIST(APPEND thai_pgo_flags -fprofile-prefix-path=${CMAKE_BINARY_DIR})
+  ENDIF()
+  FOREACH(target ${thai_pgo_targets})
+    TARGET_COMPILE_OPTIONS(${target} PRIVATE ${thai_pgo_flags})
+  ENDFOREACH()
+  # 链接核心库的程序都要带上剖析运行时
+  TARGET_LINK_OPTIONS(thai_ftparser_core INTERFACE -fprofile-generate=${THAI_FTPARSER_PGO_GENERATE})
+  IF(TARGET ${PLUGIN_NAME})
+    TARGET_LINK_OPTIONS(${PLUGIN_NAME} PRIVATE -fprofile-generate=${THAI_FTPARSER_PGO_GENERATE})
+  ENDIF()
+
+  # 训练脚本从这里拿到要构建的目标和产物路径
+  SET(thai_pgo_build_targets thai_corpus_gen thai_engine_bench)
+  SET(thai_pgo_content "SET(PGO_CORPUS_GEN \"$<TARGET_FILE:thai_corpus_gen>\")\n"
+                       "SET(PGO_ENGINE_BENCH \"$<TARGET_FILE:thai_engine_bench>\")\n")
+  IF(TARGET ${PLUGIN_NAME} AND TARGET thai_ftparser_host)
+    LIST(APPEND thai_pgo_build_targets ${PLUGIN_NAME} thai_ftparser_host)
+    LIST(APPEND thai_pgo_content "SET(PGO_PLUGIN \"$<TARGET_FILE:${PLUGIN_NAME}>\")\n"
+                                 "SET(PGO_HOST \"$<TARGET_FILE:thai_ftparser_host>\")\n")
+  ENDIF()
+  STRING(REPLACE ";" " " thai_pgo_build_targets "${thai_pgo_build_targets}")
+  LIST(APPEND thai_pgo_content "SET(PGO_BUILD_TARGETS ${thai_pgo_build_targets})\n")
+  STRING(JOIN "" thai_pgo_content ${thai_pgo_content})
+  FILE(GENERATE OUTPUT ${CMAKE_BINARY_DIR}/thai_ftparser_pgo_targets.cmake CONTENT "${thai_pgo_content}")
+  RETURN()
+ENDIF()
+
+INCLUDE(CheckIPOSupported)
+CHECK_IPO_SUPPORTED(RESULT thai_ipo_supported OUTPUT thai_ipo_output LANGUAGES CXX)
+IF(NOT thai_ipo_supported)
+  MESSAGE(FATAL_ERROR "THAI_FTPARSER_PGO needs LTO: ${thai_ipo_output}")
+ENDIF()
+
+SET(thai_pgo_dir ${CMAKE_BINARY_DIR}/pgo)
+SET(thai_pgo_profile_dir ${thai_pgo_dir}/profiles)
+SET(thai_pgo_stamp ${thai_pgo_dir}/profile.stamp)
+IF(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+  SET(thai_pgo_profdata "")
+  # 没跑到的函数 (Python 桥接、错误路径) 按普通 -O2 优化，而不是当作冷代码
+  SET(thai_pgo_flags -fprofile-use=${thai_pgo_profile_dir} -fprofile-prefix-path=${CMAKE_BINARY_DIR}
+                     -fprofile-partial-training -Wno-missing-profile)
+ELSE()
+  GET_FILENAME_COMPONENT(thai_compiler_dir ${CMAKE_CXX_COMPILER} DIRECTORY)
+  FIND_PROGRAM(LLVM_PROFDATA NAMES llvm-profdata HINTS ${thai_compiler_dir})
+  IF(NOT LLVM_PROFDATA)
+    MESSAGE(FATAL_ERROR "THAI_FTPARSER_PGO with Clang needs llvm-profdata, set LLVM_PROFDATA")
+  ENDIF()
+  SET(thai_pgo_profdata ${thai_pgo_profile_dir}/${PLUGIN_NAME}.profdata)
+  SET(thai_pgo_flags -fprofile-use=${thai_pgo_profdata} -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date)
+ENDIF()
+
+# 插桩构建沿用本构建的编译器、构建类型和插件选项，只是关掉 PGO 并打开插桩
+SET(thai_pgo_cache_args "")
+FOREACH(var CMAKE_C_COMPILER CMAKE_CXX_COMPILER CMAKE_BUILD_TYPE CMAKE_C_FLAGS CMAKE_CXX_FLAGS
+            CMAKE_PREFIX_PATH ObPlugin_DIR OB_PLUGIN_INCLUDE_DIR Python3_ROOT_DIR
+            THAI_FTPARSER_BUILD_PLUGIN THAI_FTPARSER_PYTHON THAI_FTPARSER_USDT)
+  IF(DEFINED CACHE{${var}})
+    STRING(APPEND thai_pgo_cache_args "  [==[-D${var}=$CACHE{${var}}]==]\n")
+  ENDIF()
+ENDFOREACH()
+# 内容不变时不改写文件，重新配置不会触发重新训练
+FILE(CONFIGURE OUTPUT ${thai_pgo_dir}/pgo_config.cmake CONTENT [===[
+SET(PGO_SOURCE_DIR [==[@PROJECT_SOURCE_DIR@]==])
+SET(PGO_BINARY_DIR [==[@thai_pgo_dir@/instrumented]==])
+SET(PGO_PROFILE_DIR [==[@thai_pgo_profile_dir@]==])
+SET(PGO_PROFDATA [==[@thai_pgo_profdata@]==])
+SET(PGO_LLVM_PROFDATA [==[@LLVM_PROFDATA@]==])
+SET(PGO_STAMP [==[@thai_pgo_stamp@]==])
+SET(PGO_GENERATOR [==[@CMAKE_GENERATOR@]==])
+SET(PGO_DOCS [==[@THAI_FTPARSER_PGO_DOCS@]==])
+SET(PGO_WORDS [==[@THAI_FTPARSER_PGO_WORDS@]==])
+SET(PGO_CACHE_ARGS
+@thai_pgo_cache_args@)
+]===] @ONLY)
+
+FILE(GLOB thai_pgo_inputs CONFIGURE_DEPENDS
+  ${PROJECT_SOURCE_DIR}/*.h ${PROJECT_SOURCE_DIR}/*.cpp ${PROJECT_SOURCE_DIR}/CMakeLists.txt
+  ${PROJECT_SOURCE_DIR}/bench/*.h ${PROJECT_SOURCE_DIR}/bench/*.cpp
+  ${PROJECT_SOURCE_DIR}/tools/*.h ${PROJECT_SOURCE_DIR}/tools/*.cpp)
+ADD_CUSTOM_COMMAND(OUTPUT ${thai_pgo_stamp}
+  COMMAND ${CMAKE_COMMAND} -DPGO_CONFIG=${thai_pgo_dir}/pgo_config.cmake
+          -P ${CMAKE_CURRENT_LIST_DIR}/thai_ftparser_pgo_train.cmake
+  DEPENDS ${thai_pgo_inputs} ${thai_pgo_dir}/pgo_config.cmake ${CMAKE_CURRENT_LIST_DIR}/thai_ftparser_pgo_train.cmake
+  COMMENT "Collecting PGO profiles for ${PLUGIN_NAME}"
+  VERBATIM)
+ADD_CUSTOM_TARGET(thai_ftparser_pgo_profile DEPENDS ${thai_pgo_stamp})
+
+FOREACH(target ${thai_pgo_targets})
+  ADD_DEPENDENCIES(${target} thai_ftparser_pgo_profile)
+  TARGET_COMPILE_OPTIONS(${target} PRIVATE ${thai_pgo_flags})
+  SET_TARGET_PROPERTIES(${target} PROPERTIES INTERPROCEDURAL_OPTIMIZATION ON)
+ENDFOREACH()
+# 剖析数据更新后重新编译
+SET_SOURCE_FILES_PROPERTIES(${CORE_SOURCES} ${SOURCES} PROPERTIES OBJECT_DEPENDS ${thai_pgo_stamp})
@@ -0,0 +1,70 @@
+# PGO 训练：由 thai_ftparser_pgo.cmake 的 custom command 调用
+#
+#   cmake -DPGO_CONFIG=<build>/pgo/pgo_config.cmake -P thai_ftparser_pgo_train.cmake
+#
+# 构建插桩版本，生成固定种子的基准语料，依次用 thai_engine_bench 和独立宿主程序
+# 跑一遍，最后得到 PGO_PROFILE_DIR 下的剖析数据。每个文档只扫描固定的次数，
+# 不按时间循环，同一份源码和语料得到的计数相同。
+
+INCLUDE(${PGO_CONFIG})
+
+# 旧的剖析数据和新代码对不上，先清掉
+FILE(REMOVE_RECURSE ${PGO_PROFILE_DIR})
+FILE(MAKE_DIRECTORY ${PGO_PROFILE_DIR})
+
+EXECUTE_PROCESS(
+  COMMAND ${CMAKE_COMMAND} -S ${PGO_SOURCE_DIR} -B ${PGO_BINARY_DIR} -G ${PGO_GENERATOR}
+          ${PGO_CACHE_ARGS}
+          -DTHAI_FTPARSER_PGO=OFF
+          -DTHAI_FTPARSER_PGO_GENERATE=${PGO_PROFILE_DIR}
+          -DTHAI_FTPARSER_BUILD_TOOLS=ON
+          -DTHAI_FTPARSER_BUILD_FUZZ=OFF
+  COMMAND_ERROR_IS_FATAL ANY)
+INCLUDE(${PGO_BINARY_DIR}/thai_ftparser_pgo_targets.cmake)
+EXECUTE_PROCESS(
+  COMMAND ${CMAKE_COMMAND} --build ${PGO_BINARY_DIR} --parallel --target ${PGO_BUILD_TARGETS}
+  COMMAND_ERROR_IS_FATAL ANY)
+
+# 语料：二进制格式给 thai_engine_bench，每行一个文档的文本给宿主程序
+SET(corpus ${PGO_BINARY_DIR}/pgo_corpus.bin)
+SET(corpus_text ${PGO_BINARY_DIR}/pgo_corpus.txt)
+EXECUTE_PROCESS(COMMAND ${PGO_CORPUS_GEN} -S 42 -n ${PGO_DOCS} -o ${corpus} COMMAND_ERROR_IS_FATAL ANY)
+EXECUTE_PROCESS(COMMAND ${PGO_CORPUS_GEN} -i ${corpus} -x
+  OUTPUT_FILE ${corpus_text} ERROR_QUIET COMMAND_ERROR_IS_FATAL ANY)
+
+SET(words_args "")
+IF(PGO_WORDS)
+  SET(words_args -w ${PGO_WORDS})
+ENDIF()
+# 核心库：语料一遍，再加各种长度和文种的合成文档一遍
+EXECUTE_PROCESS(COMMAND ${PGO_ENGINE_BENCH} -c ${corpus} -d 0 ${words_args}
+  OUTPUT_QUIET ERROR_QUIET COMMAND_ERROR_IS_FATAL ANY)
+EXECUTE_PROCESS(COMMAND ${PGO_ENGINE_BENCH} -d 0 ${words_args}
+  OUTPUT_QUIET ERROR_QUIET COMMAND_ERROR_IS_FATAL ANY)
+
+# 插件：经宿主程序走完整的 scan_begin/next_token 路径。Python 引擎的耗时在
+# 解释器里，训练结果还依赖本机装的 thai_tokenizer，不参与训练
+IF(PGO_PLUGIN)
+  SET(dict_env "")
+  IF(PGO_WORDS)
+    SET(dict_env OB_THAI_FTPARSER_DICT_PATH=${PGO_WORDS})
+  ENDIF()
+  FOREACH(engine space tcc dict viterbi ngram ascii)
+    EXECUTE_PROCESS(
+      COMMAND ${CMAKE_COMMAND} -E env OB_THAI_FTPARSER_ENGINE=${engine} ${dict_env}
+              ${PGO_HOST} -L -c -r 3 ${PGO_PLUGIN} ${corpus_text}
+      OUTPUT_QUIET COMMAND_ERROR_IS_FATAL ANY)
+  ENDFOREACH()
+ENDIF()
+
+# Clang 写的是原始剖析数据，需要合并成 -fprofile-use 读的格式
+IF(PGO_PROFDATA)
+  FILE(GLOB raw_profiles ${PGO_PROFILE_DIR}/*.profraw)
+  IF(NOT raw_profiles)
+    MESSAGE(FATAL_ERROR "PGO training wrote no profiles to ${PGO_PROFILE_DIR}")
+  ENDIF()
+  EXECUTE_PROCESS(COMMAND ${PGO_LLVM_PROFDATA} merge -o ${PGO_PROFDATA} ${raw_profiles}
+    COMMAND_ERROR_IS_FATAL ANY)
+ENDIF()
+
+FILE(TOUCH ${PGO_STAMP})
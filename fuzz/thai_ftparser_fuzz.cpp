@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Crash and worst-case complexity fuzzer of the segmentation engines.
+ *
+ * Built with -fsanitize=fuzzer it is a libFuzzer target. Built with
+ * THAI_FUZZ_STANDALONE it reads files, directories or stdin (AFL, or
+ * replaying saved cases) and exits 1 when any input is over budget.
+ *
+ * Configuration comes from the environment, since libFuzzer owns argv:
+ *   THAI_FUZZ_TARGET        tcc (default, in process), dict or viterbi (in
+ *                           process) or plugin
+ *   THAI_FUZZ_DICT          word list of the dict and viterbi targets, default a small
+ *                           built-in list with every prefix of a long word
+ *   THAI_FUZZ_PLUGIN        plugin .so for the plugin target; the engine is
+ *                           chosen by OB_THAI_FTPARSER_ENGINE as usual
+ *   THAI_FUZZ_NS_PER_BYTE   linear budget per input byte, default 2000
+ *   THAI_FUZZ_BASE_US       fixed budget per input, default 2000
+ *   THAI_FUZZ_SLOW_DIR      where over-budget inputs are saved, default
+ *                           thai_fuzz_slow
+ *   THAI_FUZZ_ABORT_ON_SLOW 1 to abort on an over-budget input so libFuzzer
+ *                           keeps it as a crash artifact
+ *
+ * An input over budget is re-run twice and only counts when its fastest
+ * run is still over, so scheduling noise is not recorded. Besides timing,
+ * every token is checked: non empty and char_len not above word_len; for
+ * the in-process engines also in order, inside the input and separated
+ * by whitespace only.
+ *
+ * To steer libFuzzer towards slow inputs, the cost in ns per byte is
+ * bucketed on a log scale into extra counters. An input reaching a new
+ * bucket counts as new coverage and joins the corpus.
+ *
+ * The plugin target loads the .so through the standalone host. The plugin
+ * installs its own SIGSEGV/SIGABRT handlers on every scan, so a crash
+ * inside it shows up as a libFuzzer timeout rather than a crash.
+ */
+
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#include "thai_ftparser_common.h"
+#include "thai_ftparser_dict.h"
+#include "thai_ftparser_tcc.h"
+#ifdef THAI_FUZZ_PLUGIN_TARGET
+#include "ob_plugin_host.h"
+#endif
+
+using namespace oceanbase::thai;
+
+namespace {
+
+enum FuzzTarget
+{
+  FUZZ_TARGET_TCC = 0,
+  FUZZ_TARGET_DICT,
+  FUZZ_TARGET_VITERBI,
+  FUZZ_TARGET_PLUGIN,
+};
+
+// ก 重复 1..16 次全部成词，ก 连写的输入在每个字符簇上都要探测到网格宽度上限
+const char BUILTIN_DICT[] =
+  "ก\nกก\nกกก\nกกกก\nกกกกก\nกกกกกก\nกกกกกกก\nกกกกกกกก\n"
+  "กกกกกกกกก\nกกกกกกกกกก\nกกกกกกกกกกก\nกกกกกกกกกกกก\n"
+  "กกกกกกกกกกกกก\nกกกกกกกกกกกกกก\nกกกกกกกกกกกกกกก\nกกกกกกกกกกกกกกกก\n"
+  "ภาษา\nไทย\nภาษาไทย\nเป็น\nที่\nมี\nความ\nสวยงาม\nสวัสดี\n";
+
+struct FuzzConfig
+{
+  FuzzTarget  target_ = FUZZ_TARGET_TCC;
+  int64_t     ns_per_byte_ = 2000;
+  int64_t     base_ns_ = 2000 * 1000;
+  std::string slow_dir_ = "thai_fuzz_slow";
+  bool        abort_on_slow_ = false;
+};
+
+FuzzConfig g_config;
+ObThaiDictionary g_dict;
+#ifdef THAI_FUZZ_PLUGIN_TARGET
+ObPluginHost g_host;
+const ObHostScanner *g_scanner = nullptr;
+#endif
+
+#if defined(__linux__) && !defined(THAI_FUZZ_STANDALONE)
+// 每 2 倍耗时分 4 档，覆盖到 2^16 ns/byte
+const int COST_BUCKETS = 64;
+__attribute__((section("__libfuzzer_extra_counters"), used)) uint8_t g_cost_counters[COST_BUCKETS];
+#endif
+
+int64_t env_int(const char *name, int64_t def)
+{
+  const char *value = getenv(name);
+  return (nullptr != value && '\0' != *value) ? atoll(value) : def;
+}
+
+void check(bool cond, const char *what, int64_t len)
+{
+  if (!cond) {
+    fprintf(stderr, "thai fuzz: invariant violated: %s, input length=%ld\n", what, len);
+    abort();
+  }
+}
+
+// 切片型引擎：token 按顺序、不重叠，之间只隔空白
+template <typename Tokenizer>
+void check_slices(Tokenizer &tokenizer, const char *data, int64_t len)
+{
+  const char *word = nullptr;
+  int64_t word_len = 0;
+  const char *last_end = data;
+  while (tokenizer.next(word, word_len)) {
+    check(word_len > 0, "empty token", len);
+    check(word >= last_end && word + word_len <= data + len, "token outside the input or overlapping", len);
+    for (const char *p = last_end; p < word; p++) {
+      check(' ' == *p || '\t' == *p || '\n' == *p, "non-space bytes skipped between tokens", len);
+    }
+    last_end = word + word_len;
+  }
+}
+
+// 跑一遍目标引擎并检查 token，返回耗时
+int64_t run_once(const char *data, int64_t len)
+{
+  const int64_t begin_ns = thai_monotonic_ns();
+  if (FUZZ_TARGET_TCC == g_config.target_) {
+    ObThaiTccTokenizer tcc;
+    tcc.reset(data, data + len);
+    check_slices(tcc, data, len);
+  } else if (FUZZ_TARGET_DICT == g_config.target_ || FUZZ_TARGET_VITERBI == g_config.target_) {
+    ObThaiDictTokenizer dict;
+    dict.reset(&g_dict, data, data + len,
+               FUZZ_TARGET_VITERBI == g_config.target_ ? OB_THAI_DICT_VITERBI : OB_THAI_DICT_MAXIMAL);
+    check_slices(dict, data, len);
+  }
+#ifdef THAI_FUZZ_PLUGIN_TARGET
+  else if (nullptr != g_scanner) {
+    g_scanner->scan(data, len, [len](const char *word, int64_t word_len, int64_t char_len, int64_t) {
+        check(nullptr != word && word_len > 0, "empty plugin token", len);
+        check(char_len > 0 && char_len <= word_len, "plugin char_len out of range", len);
+      });
+  }
+#endif
+  return thai_monotonic_ns() - begin_ns;
+}
+
+void save_slow_input(const char *data, int64_t len, int64_t ns)
+{
+  mkdir(g_config.slow_dir_.c_str(), 0755);
+  // FNV-1a 作为文件名，同一输入只保存一份
+  uint64_t hash = 1469598103934665603ULL;
+  for (int64_t i = 0; i < len; i++) {
+    hash = (hash ^ (unsigned char)data[i]) * 1099511628211ULL;
+  }
+  char path[4096];
+  snprintf(path, sizeof(path), "%s/slow-%016lx", g_config.slow_dir_.c_str(), hash);
+  FILE *fp = fopen(path, "wb");
+  if (nullptr != fp) {
+    fwrite(data, 1, len, fp);
+    fclose(fp);
+  }
+  fprintf(stderr, "thai fuzz: input of %ld bytes took %ld ns (%.1f ns/byte), saved to %s\n",
+          len, ns, len > 0 ? (double)ns / (double)len : 0.0, path);
+}
+
+/// @return false when the input stays over the linear budget
+bool fuzz_one(const char *data, int64_t len)
+{
+  int64_t ns = run_once(data, len);
+  const int64_t budget = g_config.base_ns_ + g_config.ns_per_byte_ * len;
+  if (ns > budget) {
+    for (int i = 0; i < 2 && ns > budget; i++) {
+      const int64_t again = run_once(data, len);
+      ns = again < ns ? again : ns;
+    }
+  }
+#if defined(__linux__) && !defined(THAI_FUZZ_STANDALONE)
+  const double per_byte = (double)ns / (double)(len > 0 ? len : 1);
+  int bucket = (int)(log2(per_byte + 1.0) * 4);
+  bucket = bucket < 0 ? 0 : (bucket >= COST_BUCKETS ? COST_BUCKETS - 1 : bucket);
+  g_cost_counters[bucket] = 1;
+#endif
+  const bool within = ns <= budget;
+  if (!within) {
+    save_slow_input(data, len, ns);
+    if (g_config.abort_on_slow_) {
+      abort();
+    }
+  }
+  return within;
+}
+
+void init_config()
+{
+  const char *target = getenv("THAI_FUZZ_TARGET");
+  g_config.target_ = FUZZ_TARGET_TCC;
+  if (nullptr != target && 0 == strcmp(target, "dict")) {
+    g_config.target_ = FUZZ_TARGET_DICT;
+  } else if (nullptr != target && 0 == strcmp(target, "viterbi")) {
+    g_config.target_ = FUZZ_TARGET_VITERBI;
+  } else if (nullptr != target && 0 == strcmp(target, "plugin")) {
+    g_config.target_ = FUZZ_TARGET_PLUGIN;
+  }
+  g_config.ns_per_byte_ = env_int("THAI_FUZZ_NS_PER_BYTE", g_config.ns_per_byte_);
+  g_config.base_ns_ = env_int("THAI_FUZZ_BASE_US", g_config.base_ns_ / 1000) * 1000;
+  g_config.abort_on_slow_ = 0 != env_int("THAI_FUZZ_ABORT_ON_SLOW", 0);
+  const char *slow_dir = getenv("THAI_FUZZ_SLOW_DIR");
+  if (nullptr != slow_dir && '\0' != *slow_dir) {
+    g_config.slow_dir_ = slow_dir;
+  }
+  if (FUZZ_TARGET_DICT == g_config.target_ || FUZZ_TARGET_VITERBI == g_config.target_) {
+    const char *path = getenv("THAI_FUZZ_DICT");
+    const bool loaded = nullptr != path && '\0' != *path
+        ? g_dict.load(path) : g_dict.build(BUILTIN_DICT, (int64_t)sizeof(BUILTIN_DICT) - 1);
+    if (!loaded) {
+      fprintf(stderr, "thai fuzz: cannot load dictionary %s\n", nullptr != path ? path : "(built-in)");
+      exit(2);
+    }
+  } else if (FUZZ_TARGET_PLUGIN == g_config.target_) {
+#ifdef THAI_FUZZ_PLUGIN_TARGET
+    const char *path = getenv("THAI_FUZZ_PLUGIN");
+    const ObPluginFTParser *parser = nullptr;
+    if (nullptr == path || OBP_SUCCESS != g_host.load(path) || nullptr == (parser = g_host.parser(nullptr))) {
+      fprintf(stderr, "thai fuzz: set THAI_FUZZ_PLUGIN to a loadable plugin .so\n");
+      exit(2);
+    }
+    static ObHostScanner scanner(parser);
+    g_scanner = &scanner;
+#else
+    fprintf(stderr, "thai fuzz: built without the plugin target\n");
+    exit(2);
+#endif
+  }
+}
+
+} // namespace
+
+#ifndef THAI_FUZZ_STANDALONE
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+  init_config();
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+  fuzz_one((const char *)data, (int64_t)size);
+  return 0;
+}
+
+#else
+
+namespace {
+
+bool read_file(const char *path, std::string &content)
+{
+  FILE *fp = 0 == strcmp(path, "-") ? stdin : fopen(path, "rb");
+  bool ok = nullptr != fp;
+  char buf[65536];
+  size_t n = 0;
+  while (ok && (n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+    content.append(buf, n);
+  }
+  if (nullptr != fp && stdin != fp) {
+    fclose(fp);
+  }
+  return ok;
+}
+
+// 目录按一层展开，用于重放保存下来的用例
+void collect_inputs(const char *path, std::vector<std::string> &inputs)
+{
+  struct stat st;
+  if (0 == stat(path, &st) && S_ISDIR(st.st_mode)) {
+    // 按文件名排序，和 ls 一样每次重放的顺序固定
+    std::vector<std::string> names;
+    DIR *dir = opendir(path);
+    struct dirent *entry = nullptr;
+    while (nullptr != dir && nullptr != (entry = readdir(dir))) {
+      if (0 != strcmp(entry->d_name, ".") && 0 != strcmp(entry->d_name, "..")) {
+        names.push_back(entry->d_name);
+      }
+    }
+    if (nullptr != dir) {
+      closedir(dir);
+    }
+    std::sort(names.begin(), names.end());
+    for (size_t i = 0; i < names.size(); i++) {
+      inputs.push_back(std::string(path) + "/" + names[i]);
+    }
+  } else {
+    inputs.push_back(path);
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  init_config();
+  std::vector<std::string> inputs;
+  for (int i = 1; i < argc; i++) {
+    collect_inputs(argv[i], inputs);
+  }
+  int ret = 0;
+#ifdef __AFL_HAVE_MANUAL_CONTROL
+  if (inputs.empty()) {
+    // AFL++ 持久模式
+    while (__AFL_LOOP(1000)) {
+      std::string content;
+      read_file("-", content);
+      fuzz_one(content.data(), (int64_t)content.size());
+    }
+    return 0;
+  }
+#endif
+  if (inputs.empty()) {
+    inputs.push_back("-");
+  }
+  int64_t slow = 0;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    std::string content;
+    if (!read_file(inputs[i].c_str(), content)) {
+      fprintf(stderr, "thai fuzz: cannot read %s, errno=%d\n", inputs[i].c_str(), errno);
+      ret = 2;
+    } else if (!fuzz_one(content.data(), (int64_t)content.size())) {
+      slow++;
+    }
+  }
+  fprintf(stderr, "thai fuzz: %zu inputs, %ld over budget\n", inputs.size(), slow);
+  return 0 != ret ? ret : (slow > 0 ? 1 : 0);
+}
+
+#endif
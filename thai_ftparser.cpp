@@ -18,6 +18,7 @@
 #include <pthread.h>
 
 #include "oceanbase/ob_plugin_ftparser.h"
+#include "thai_ftparser_log.h"
 
 /**
  * @defgroup ThaiFtParser Thai Fulltext Parser Plugin
@@ -106,13 +107,13 @@ int ObThaiFTParser::init(ObPluginFTParserParamPtr param)
 
   if (is_inited_) {
     ret = OBP_INIT_TWICE;
-    OBP_LOG_WARN("init twice. ret=%d, param=%p, this=%p", ret, param, this);
+    THAI_LOG_WARN("init twice. ret=%d, param=%p, this=%p", ret, param, this);
   } else if (0 == param
       || 0 == cs
       || nullptr == fulltext
       || 0 >= ft_length) {
     ret = OBP_INVALID_ARGUMENT;
-    OBP_LOG_WARN("invalid arguments, ret=%d, param=%p", ret, param);
+    THAI_LOG_WARN("invalid arguments, ret=%d, param=%p", ret, param);
   } else {
     cs_ = cs;
     start_ = fulltext;
@@ -126,25 +127,25 @@ int ObThaiFTParser::init(ObPluginFTParserParamPtr param)
     
     // 检查是否为泰语文本
     if (is_thai_text(fulltext, ft_length)) {
-      OBP_LOG_INFO("Detected Thai text, initializing Python tokenizer");
+      THAI_LOG_TRACE("Detected Thai text, initializing Python tokenizer");
       ret = initialize_python();
       if (ret == OBP_SUCCESS) {
-        OBP_LOG_INFO("Python initialized successfully, tokenizing text");
+        THAI_LOG_TRACE("Python initialized successfully, tokenizing text");
         ret = tokenize_text();
       } else {
         // Python初始化失败，使用空格分词作为回退
-        OBP_LOG_WARN("Python initialization failed, falling back to space tokenization");
+        THAI_LOG_WARN("Python initialization failed, falling back to space tokenization");
         ret = tokenize_with_spaces();
       }
     } else {
-      OBP_LOG_INFO("Non-Thai text detected, using space tokenization");
+      THAI_LOG_TRACE("Non-Thai text detected, using space tokenization");
       ret = tokenize_with_spaces();
     }
   }
   if (ret != OBP_SUCCESS && !is_inited_) {
     reset();
   }
-  OBP_LOG_INFO("thai ftparser init done. ret=%d", ret);
+  THAI_LOG_TRACE("thai ftparser init done. ret=%d", ret);
   return ret;
 }
 
@@ -166,7 +167,7 @@ int ObThaiFTParser::initialize_python()
     // 导入thai_tokenizer模块
     PyObject* pModule = PyImport_ImportModule("thai_tokenizer");
     if (!pModule) {
-      OBP_LOG_WARN("Failed to import thai_tokenizer module");
+      THAI_LOG_WARN("Failed to import thai_tokenizer module");
       pthread_mutex_unlock(&python_mutex_);
       return OBP_PLUGIN_ERROR;
     }
@@ -174,7 +175,7 @@ int ObThaiFTParser::initialize_python()
     // 获取Tokenizer类
     PyObject* pTokenizerClass = PyObject_GetAttrString(pModule, "Tokenizer");
     if (!pTokenizerClass) {
-      OBP_LOG_WARN("Failed to get Tokenizer class");
+      THAI_LOG_WARN("Failed to get Tokenizer class");
       Py_DECREF(pModule);
       pthread_mutex_unlock(&python_mutex_);
       return OBP_PLUGIN_ERROR;
@@ -183,7 +184,7 @@ int ObThaiFTParser::initialize_python()
     // 创建Tokenizer实例（Python 3.10版本不需要参数）
     PyObject* pTokenizer = PyObject_CallObject(pTokenizerClass, nullptr);
     if (!pTokenizer) {
-      OBP_LOG_WARN("Failed to create Tokenizer instance");
+      THAI_LOG_WARN("Failed to create Tokenizer instance");
       Py_DECREF(pTokenizerClass);
       Py_DECREF(pModule);
       pthread_mutex_unlock(&python_mutex_);
@@ -193,7 +194,7 @@ int ObThaiFTParser::initialize_python()
     // 获取split方法
     PyObject* pSplitFunc = PyObject_GetAttrString(pTokenizer, "split");
     if (!pSplitFunc) {
-      OBP_LOG_WARN("Failed to get split method");
+      THAI_LOG_WARN("Failed to get split method");
       Py_DECREF(pTokenizer);
       Py_DECREF(pTokenizerClass);
       Py_DECREF(pModule);
@@ -209,7 +210,7 @@ int ObThaiFTParser::initialize_python()
     pthread_mutex_unlock(&python_mutex_);
     return OBP_SUCCESS;
   } catch (const std::exception& e) {
-    OBP_LOG_WARN("Python initialization failed: %s", e.what());
+    THAI_LOG_WARN("Python initialization failed: %s", e.what());
     pthread_mutex_unlock(&python_mutex_);
     return OBP_PLUGIN_ERROR;
   }
@@ -283,7 +284,7 @@ int ObThaiFTParser::tokenize_text()
           memcpy(tokens_[i], str, str_len);
           tokens_[i][str_len] = '\0';
           // 添加调试日志
-          OBP_LOG_INFO("Token[%d]: '%s' (len=%d)", (int)i, tokens_[i], (int)str_len);
+          THAI_LOG_TRACE("Token[%d]: '%s' (len=%d)", (int)i, tokens_[i], (int)str_len);
         }
       }
     }
@@ -432,7 +433,7 @@ int ObThaiFTParser::get_next_token(
   
   if (!is_inited_) {
     ret = OBP_PLUGIN_ERROR;
-    OBP_LOG_WARN("thai ft parser isn't initialized. ret=%d, is_inited=%d", ret, is_inited_);
+    THAI_LOG_WARN("thai ft parser isn't initialized. ret=%d, is_inited=%d", ret, is_inited_);
   } else if (tokens_ && current_token_index_ < token_count_) {
     // 使用Python分词结果
     while (current_token_index_ < token_count_ && !tokens_[current_token_index_]) {
@@ -445,7 +446,7 @@ int ObThaiFTParser::get_next_token(
       char_len = word_len;
       word_freq = 1;
       // 添加调试日志
-      OBP_LOG_INFO("Returning token[%d]: '%s' (len=%d)", current_token_index_, word, (int)word_len);
+      THAI_LOG_TRACE("Returning token[%d]: '%s' (len=%d)", current_token_index_, word, (int)word_len);
       current_token_index_++;
     } else {
       ret = OBP_ITER_END;
@@ -501,7 +502,7 @@ int ObThaiFTParser::get_next_token(
     ret = OBP_ITER_END;
   }
   
-  OBP_LOG_TRACE("next word. start=%p, next=%p, end=%p", start_, next_, end_);
+  THAI_LOG_TRACE("next word. start=%p, next=%p, end=%p", start_, next_, end_);
   return ret;
 }
 
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_COMMON_H_
+#define OB_THAI_FTPARSER_COMMON_H_
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * @brief Small helpers shared by the Thai ftparser modules.
+ * @details Nothing here depends on the OceanBase plugin headers.
+ */
+
+#define THAI_LIKELY(x)   __builtin_expect(!!(x), 1)
+#define THAI_UNLIKELY(x) __builtin_expect(!!(x), 0)
+
+// 导出给宿主程序/调试器使用的符号
+#define THAI_EXPORT extern "C" __attribute__((visibility("default")))
+
+namespace oceanbase {
+namespace thai {
+
+// 单调时钟，纳秒
+inline int64_t thai_monotonic_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * 追加格式化输出到 buf+pos，空间不足时截断并保持 '\0' 结尾
+ * @return 是否完整写入
+ */
+inline bool thai_databuff_printf(char *buf, int64_t buf_len, int64_t &pos, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+inline bool thai_databuff_printf(char *buf, int64_t buf_len, int64_t &pos, const char *fmt, ...)
+{
+  bool complete = false;
+  if (nullptr != buf && pos >= 0 && pos < buf_len) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + pos, buf_len - pos, fmt, args);
+    va_end(args);
+    if (n >= 0 && pos + n < buf_len) {
+      pos += n;
+      complete = true;
+    } else if (n >= 0) {
+      pos = buf_len - 1;
+    }
+  }
+  return complete;
+}
+
+} // namespace thai
+} // namespace oceanbase
+
+#endif // OB_THAI_FTPARSER_COMMON_H_
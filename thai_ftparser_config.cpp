@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "thai_ftparser_config.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace oceanbase {
+namespace thai {
+
+static const char *ENGINE_NAMES[OB_THAI_ENGINE_MAX] = {
+  "auto",
+  "python",
+  "space",
+  "tcc",
+  "dict",
+  "viterbi",
+  "worker",
+  "ngram",
+  "ascii",
+};
+
+const char *get_engine_name(ObThaiEngineType engine)
+{
+  return (engine >= 0 && engine < OB_THAI_ENGINE_MAX) ? ENGINE_NAMES[engine] : "unknown";
+}
+
+bool get_engine_type(const char *name, ObThaiEngineType &engine)
+{
+  bool found = false;
+  for (int i = 0; !found && nullptr != name && i < OB_THAI_ENGINE_MAX; i++) {
+    if (0 == strcasecmp(name, ENGINE_NAMES[i])) {
+      engine = (ObThaiEngineType)i;
+      found = true;
+    }
+  }
+  return found;
+}
+
+const ObThaiConfig &ObThaiConfig::instance()
+{
+  // C++11 保证局部静态变量初始化线程安全
+  static ObThaiConfig config;
+  return config;
+}
+
+ObThaiConfig::ObThaiConfig()
+{
+  stats_interval_sec_ = get_int("OB_THAI_FTPARSER_STATS_INTERVAL_SEC", stats_interval_sec_);
+  if (stats_interval_sec_ < 0) {
+    stats_interval_sec_ = 0;
+  }
+  log_rate_per_sec_ = get_int("OB_THAI_FTPARSER_LOG_RATE", log_rate_per_sec_);
+  if (log_rate_per_sec_ < 0 || log_rate_per_sec_ > 1000000000LL) {
+    log_rate_per_sec_ = 0;
+  }
+  log_burst_ = get_int("OB_THAI_FTPARSER_LOG_BURST", log_burst_);
+  slow_doc_top_k_ = get_int("OB_THAI_FTPARSER_SLOW_DOC_TOP_K", slow_doc_top_k_);
+  if (slow_doc_top_k_ < 0) {
+    slow_doc_top_k_ = 0;
+  }
+  slow_doc_prefix_len_ = get_int("OB_THAI_FTPARSER_SLOW_DOC_PREFIX", slow_doc_prefix_len_);
+  if (slow_doc_prefix_len_ < 0) {
+    slow_doc_prefix_len_ = 0;
+  }
+  metrics_socket_path_ = get_str("OB_THAI_FTPARSER_METRICS_SOCKET");
+  metrics_file_path_ = get_str("OB_THAI_FTPARSER_METRICS_FILE");
+  metrics_interval_sec_ = get_int("OB_THAI_FTPARSER_METRICS_INTERVAL_SEC", metrics_interval_sec_);
+  if (metrics_interval_sec_ <= 0) {
+    metrics_interval_sec_ = 15;
+  }
+  memory_budget_mb_ = get_int("OB_THAI_FTPARSER_MEMORY_BUDGET_MB", memory_budget_mb_);
+  if (memory_budget_mb_ < 0) {
+    memory_budget_mb_ = 0;
+  }
+  window_bytes_ = get_int("OB_THAI_FTPARSER_WINDOW_BYTES", window_bytes_);
+  if (window_bytes_ < 256) {
+    window_bytes_ = 256;
+  }
+  get_engine_type(get_str("OB_THAI_FTPARSER_ENGINE").c_str(), engine_);
+  get_engine_type(get_str("OB_THAI_FTPARSER_THAI_ENGINE").c_str(), thai_engine_);
+  if (OB_THAI_ENGINE_AUTO == thai_engine_) {
+    thai_engine_ = OB_THAI_ENGINE_PYTHON;
+  }
+  dict_path_ = get_str("OB_THAI_FTPARSER_DICT_PATH");
+  worker_socket_path_ = get_str("OB_THAI_FTPARSER_WORKER_SOCKET");
+  worker_timeout_ms_ = get_int("OB_THAI_FTPARSER_WORKER_TIMEOUT_MS", worker_timeout_ms_);
+  if (worker_timeout_ms_ <= 0) {
+    worker_timeout_ms_ = 100;
+  }
+  worker_breaker_timeouts_ = get_int("OB_THAI_FTPARSER_WORKER_BREAKER_TIMEOUTS", worker_breaker_timeouts_);
+  if (worker_breaker_timeouts_ < 0) {
+    worker_breaker_timeouts_ = 0;
+  }
+  worker_breaker_sec_ = get_int("OB_THAI_FTPARSER_WORKER_BREAKER_SEC", worker_breaker_sec_);
+  if (worker_breaker_sec_ <= 0) {
+    worker_breaker_sec_ = 10;
+  }
+  get_engine_type(get_str("OB_THAI_FTPARSER_SHADOW_ENGINE").c_str(), shadow_engine_);
+  shadow_sample_permille_ = get_int("OB_THAI_FTPARSER_SHADOW_SAMPLE_PERMILLE", shadow_sample_permille_);
+  if (shadow_sample_permille_ < 0) {
+    shadow_sample_permille_ = 0;
+  } else if (shadow_sample_permille_ > 1000) {
+    shadow_sample_permille_ = 1000;
+  }
+  shadow_cpu_permille_ = get_int("OB_THAI_FTPARSER_SHADOW_CPU_PERMILLE", shadow_cpu_permille_);
+  if (shadow_cpu_permille_ <= 0 || shadow_cpu_permille_ > 1000) {
+    shadow_cpu_permille_ = 50;
+  }
+  shadow_diff_path_ = get_str("OB_THAI_FTPARSER_SHADOW_DIFF_FILE");
+  shadow_diff_max_mb_ = get_int("OB_THAI_FTPARSER_SHADOW_DIFF_MAX_MB", shadow_diff_max_mb_);
+  if (shadow_diff_max_mb_ <= 0) {
+    shadow_diff_max_mb_ = 16;
+  }
+}
+
+int64_t ObThaiConfig::get_int(const char *name, int64_t default_value)
+{
+  int64_t value = default_value;
+  const char *str = getenv(name);
+  if (nullptr != str && '\0' != *str) {
+    char *end = nullptr;
+    errno = 0;
+    long long v = strtoll(str, &end, 10);
+    if (0 == errno && nullptr != end && '\0' == *end) {
+      value = (int64_t)v;
+    }
+  }
+  return value;
+}
+
+std::string ObThaiConfig::get_str(const char *name)
+{
+  const char *str = getenv(name);
+  return std::string(nullptr != str ? str : "");
+}
+
+} // namespace thai
+} // namespace oceanbase
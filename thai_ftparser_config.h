@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_CONFIG_H_
+#define OB_THAI_FTPARSER_CONFIG_H_
+
+#include <stdint.h>
+#include <string>
+
+namespace oceanbase {
+namespace thai {
+
+/// 分词引擎选择 (OB_THAI_FTPARSER_ENGINE)
+enum ObThaiEngineType
+{
+  OB_THAI_ENGINE_AUTO = 0,   // 泰文走 OB_THAI_FTPARSER_THAI_ENGINE，其余按空格
+  OB_THAI_ENGINE_PYTHON,     // 所有文档都走 Python (不带 Python 的构建等同 dict)
+  OB_THAI_ENGINE_SPACE,      // 只按空格
+  OB_THAI_ENGINE_TCC,        // 只按字符簇
+  OB_THAI_ENGINE_DICT,       // 词典最大匹配，线性时间
+  OB_THAI_ENGINE_VITERBI,    // 词典加词频的一元语言模型，线性时间
+  OB_THAI_ENGINE_WORKER,     // 通过 Unix socket 交给外部分词进程
+  OB_THAI_ENGINE_NGRAM,      // 相邻两个字符簇组成一个 token
+  OB_THAI_ENGINE_ASCII,      // 只取 ASCII 字母、数字和下划线
+  OB_THAI_ENGINE_MAX
+};
+
+const char *get_engine_name(ObThaiEngineType engine);
+/// 按名字(不区分大小写)查找引擎。@return false if no engine has that name
+bool get_engine_type(const char *name, ObThaiEngineType &engine);
+
+/**
+ * @brief Node level settings of the Thai ftparser.
+ * @details The plugin API has no configuration channel, so every knob is read
+ * once from the environment of the observer process (OB_THAI_FTPARSER_*).
+ * Unset or malformed variables keep the default.
+ */
+class ObThaiConfig final
+{
+public:
+  static const ObThaiConfig &instance();
+
+  // 统计汇总日志的间隔，0 表示关闭 (OB_THAI_FTPARSER_STATS_INTERVAL_SEC)
+  int64_t stats_interval_sec_ = 60;
+  // 每个日志调用点每秒允许的条数，0 表示不限 (OB_THAI_FTPARSER_LOG_RATE)
+  int64_t log_rate_per_sec_ = 1;
+  // 每个日志调用点允许的突发条数 (OB_THAI_FTPARSER_LOG_BURST)
+  int64_t log_burst_ = 10;
+  // 每个统计周期保留的最慢文档数，0 表示关闭 (OB_THAI_FTPARSER_SLOW_DOC_TOP_K)
+  int64_t slow_doc_top_k_ = 8;
+  // 慢文档记录的正文前缀字节数，默认不记录正文 (OB_THAI_FTPARSER_SLOW_DOC_PREFIX)
+  int64_t slow_doc_prefix_len_ = 0;
+  // Prometheus 指标的 Unix socket 路径，空表示不启用 (OB_THAI_FTPARSER_METRICS_SOCKET)
+  std::string metrics_socket_path_;
+  // Prometheus 指标文件路径，空表示不启用 (OB_THAI_FTPARSER_METRICS_FILE)
+  std::string metrics_file_path_;
+  // 指标文件的刷新间隔 (OB_THAI_FTPARSER_METRICS_INTERVAL_SEC)
+  int64_t metrics_interval_sec_ = 15;
+  // 插件内存预算(MB)，0 表示不限 (OB_THAI_FTPARSER_MEMORY_BUDGET_MB)
+  int64_t memory_budget_mb_ = 1024;
+  // 分窗模式下每次交给分词器的字节数 (OB_THAI_FTPARSER_WINDOW_BYTES)
+  int64_t window_bytes_ = 2048;
+  // 本节点的分词引擎，取值见 ObThaiEngineType 各项的名字 (OB_THAI_FTPARSER_ENGINE)
+  ObThaiEngineType engine_ = OB_THAI_ENGINE_AUTO;
+  // auto 引擎下泰文文档使用的引擎，不能是 auto (OB_THAI_FTPARSER_THAI_ENGINE)
+  ObThaiEngineType thai_engine_ = OB_THAI_ENGINE_PYTHON;
+  // dict 和 viterbi 引擎的词表，每行一个词，高频词在前 (OB_THAI_FTPARSER_DICT_PATH)
+  std::string dict_path_;
+  // worker 引擎的 Unix socket 路径 (OB_THAI_FTPARSER_WORKER_SOCKET)
+  std::string worker_socket_path_;
+  // worker 引擎每篇文档的等待上限，超时后退回空格分词 (OB_THAI_FTPARSER_WORKER_TIMEOUT_MS)
+  int64_t worker_timeout_ms_ = 100;
+  // worker 引擎连续超时多少次后熔断，0 表示不熔断 (OB_THAI_FTPARSER_WORKER_BREAKER_TIMEOUTS)
+  int64_t worker_breaker_timeouts_ = 3;
+  // 熔断后跳过 worker 的秒数，之后放一篇文档去试探 (OB_THAI_FTPARSER_WORKER_BREAKER_SEC)
+  int64_t worker_breaker_sec_ = 10;
+  // 影子模式的第二个引擎，auto 表示关闭 (OB_THAI_FTPARSER_SHADOW_ENGINE)
+  ObThaiEngineType shadow_engine_ = OB_THAI_ENGINE_AUTO;
+  // 抽样比例，千分比 (OB_THAI_FTPARSER_SHADOW_SAMPLE_PERMILLE)
+  int64_t shadow_sample_permille_ = 10;
+  // 影子线程最多占用一个核的千分比 (OB_THAI_FTPARSER_SHADOW_CPU_PERMILLE)
+  int64_t shadow_cpu_permille_ = 50;
+  // 不一致文档的差异文件，空表示只计数 (OB_THAI_FTPARSER_SHADOW_DIFF_FILE)
+  std::string shadow_diff_path_;
+  // 差异文件达到该大小(MB)后轮转为 .1 (OB_THAI_FTPARSER_SHADOW_DIFF_MAX_MB)
+  int64_t shadow_diff_max_mb_ = 16;
+
+private:
+  ObThaiConfig();
+  static int64_t get_int(const char *name, int64_t default_value);
+  static std::string get_str(const char *name);
+};
+
+} // namespace thai
+} // namespace oceanbase
+
+#endif // OB_THAI_FTPARSER_CONFIG_H_
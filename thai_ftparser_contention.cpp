@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "thai_ftparser_contention.h"
+
+#include <algorithm>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+namespace oceanbase {
+namespace thai {
+
+static const char *LOCK_NAMES[OB_THAI_LOCK_MAX] = {
+  "python_mutex",
+  "gil",
+};
+
+const char *get_lock_name(ObThaiLockId id)
+{
+  return (id >= 0 && id < OB_THAI_LOCK_MAX) ? LOCK_NAMES[id] : "unknown";
+}
+
+static int64_t current_tid()
+{
+  static thread_local int64_t tid = 0;
+  if (0 == tid) {
+    tid = (int64_t)syscall(SYS_gettid);
+  }
+  return tid;
+}
+
+ObThaiContentionSlot::ObThaiContentionSlot()
+{
+  tid_.store(0, std::memory_order_relaxed);
+  for (int i = 0; i < OB_THAI_LOCK_MAX; i++) {
+    locks_[i].acquisitions_.store(0, std::memory_order_relaxed);
+    locks_[i].wait_ns_.store(0, std::memory_order_relaxed);
+    locks_[i].hold_ns_.store(0, std::memory_order_relaxed);
+    locks_[i].max_wait_ns_.store(0, std::memory_order_relaxed);
+    locks_[i].batches_.store(0, std::memory_order_relaxed);
+    locks_[i].batch_bytes_.store(0, std::memory_order_relaxed);
+    locks_[i].batch_tokens_.store(0, std::memory_order_relaxed);
+  }
+}
+
+ObThaiContention &ObThaiContention::instance()
+{
+  static ObThaiContention contention;
+  return contention;
+}
+
+ObThaiContentionSlot *ObThaiContention::local_slot()
+{
+  ObThaiContentionSlot *slot = ObThaiThreadSlots<ObThaiContentionSlot>::local();
+  if (THAI_LIKELY(nullptr != slot)) {
+    const int64_t tid = current_tid();
+    if (THAI_UNLIKELY(slot->tid_.load(std::memory_order_relaxed) != tid)) {
+      slot->tid_.store(tid, std::memory_order_relaxed);
+    }
+  }
+  return slot;
+}
+
+void ObThaiContention::record_hold(ObThaiLockId id, int64_t wait_ns, int64_t hold_ns)
+{
+  ObThaiContentionSlot *slot = local_slot();
+  if (THAI_LIKELY(nullptr != slot)) {
+    ObThaiContentionSlot::Lock &lock = slot->locks_[id];
+    const uint64_t wait = wait_ns > 0 ? (uint64_t)wait_ns : 0;
+    thai_counter_add(lock.acquisitions_, 1);
+    thai_counter_add(lock.wait_ns_, wait);
+    thai_counter_add(lock.hold_ns_, hold_ns > 0 ? (uint64_t)hold_ns : 0);
+    if (wait > lock.max_wait_ns_.load(std::memory_order_relaxed)) {
+      lock.max_wait_ns_.store(wait, std::memory_order_relaxed);
+    }
+  }
+}
+
+void ObThaiContention::record_batch(ObThaiLockId id, int64_t bytes, int64_t tokens)
+{
+  ObThaiContentionSlot *slot = local_slot();
+  if (THAI_LIKELY(nullptr != slot)) {
+    ObThaiContentionSlot::Lock &lock = slot->locks_[id];
+    thai_counter_add(lock.batches_, 1);
+    thai_counter_add(lock.batch_bytes_, (uint64_t)bytes);
+    thai_counter_add(lock.batch_tokens_, (uint64_t)tokens);
+  }
+}
+
+namespace {
+struct ThreadTotal
+{
+  int64_t  tid_;
+  uint64_t wait_ns_[OB_THAI_LOCK_MAX];
+  uint64_t hold_ns_[OB_THAI_LOCK_MAX];
+  uint64_t acquisitions_[OB_THAI_LOCK_MAX];
+  uint64_t total_wait_ns_;
+};
+} // namespace
+
+int64_t ObThaiContention::report(char *buf, int64_t buf_len, int64_t top_n, bool reset)
+{
+  int64_t pos = 0;
+  if (nullptr == buf || buf_len <= 0) {
+    return 0;
+  }
+  buf[0] = '\0';
+  uint64_t acquisitions[OB_THAI_LOCK_MAX] = {};
+  uint64_t wait_ns[OB_THAI_LOCK_MAX] = {};
+  uint64_t hold_ns[OB_THAI_LOCK_MAX] = {};
+  uint64_t max_wait_ns[OB_THAI_LOCK_MAX] = {};
+  uint64_t batches[OB_THAI_LOCK_MAX] = {};
+  uint64_t batch_bytes[OB_THAI_LOCK_MAX] = {};
+  uint64_t batch_tokens[OB_THAI_LOCK_MAX] = {};
+  std::vector<ThreadTotal> threads;
+  ObThaiThreadSlots<ObThaiContentionSlot>::for_each(
+      [&](const ObThaiContentionSlot &slot, bool) {
+        ThreadTotal t;
+        t.tid_ = slot.tid_.load(std::memory_order_relaxed);
+        t.total_wait_ns_ = 0;
+        for (int i = 0; i < OB_THAI_LOCK_MAX; i++) {
+          const ObThaiContentionSlot::Lock &lock = slot.locks_[i];
+          t.acquisitions_[i] = lock.acquisitions_.load(std::memory_order_relaxed);
+          t.wait_ns_[i] = lock.wait_ns_.load(std::memory_order_relaxed);
+          t.hold_ns_[i] = lock.hold_ns_.load(std::memory_order_relaxed);
+          t.total_wait_ns_ += t.wait_ns_[i];
+          acquisitions[i] += t.acquisitions_[i];
+          wait_ns[i] += t.wait_ns_[i];
+          hold_ns[i] += t.hold_ns_[i];
+          max_wait_ns[i] = std::max(max_wait_ns[i], lock.max_wait_ns_.load(std::memory_order_relaxed));
+          batches[i] += lock.batches_.load(std::memory_order_relaxed);
+          batch_bytes[i] += lock.batch_bytes_.load(std::memory_order_relaxed);
+          batch_tokens[i] += lock.batch_tokens_.load(std::memory_order_relaxed);
+        }
+        if (t.total_wait_ns_ > 0) {
+          threads.push_back(t);
+        }
+      });
+
+  std::lock_guard<std::mutex> guard(report_lock_);
+  const int64_t now = thai_monotonic_ns();
+  const int64_t elapsed_ns = last_report_ns_ > 0 ? now - last_report_ns_ : 0;
+  for (int i = 0; i < OB_THAI_LOCK_MAX; i++) {
+    // busy: 自上次报告以来持有时间占墙钟时间的比例，GIL 接近 1 即已饱和
+    const double busy = elapsed_ns > 0 ? (double)(hold_ns[i] - last_hold_ns_[i]) / (double)elapsed_ns : 0.0;
+    thai_databuff_printf(buf, buf_len, pos,
+                         "%s%s={acq=%lu, wait_ms=%.3f, hold_ms=%.3f, avg_wait_us=%.2f, avg_hold_us=%.2f,"
+                         " max_wait_us=%.2f, busy=%.3f, batches=%lu, avg_batch_bytes=%.1f, avg_batch_tokens=%.1f}",
+                         i > 0 ? ", " : "", LOCK_NAMES[i], acquisitions[i],
+                         (double)wait_ns[i] / 1e6, (double)hold_ns[i] / 1e6,
+                         acquisitions[i] > 0 ? (double)wait_ns[i] / (double)acquisitions[i] / 1e3 : 0.0,
+                         acquisitions[i] > 0 ? (double)hold_ns[i] / (double)acquisitions[i] / 1e3 : 0.0,
+                         (double)max_wait_ns[i] / 1e3, busy, batches[i],
+                         batches[i] > 0 ? (double)batch_bytes[i] / (double)batches[i] : 0.0,
+                         batches[i] > 0 ? (double)batch_tokens[i] / (double)batches[i] : 0.0);
+    if (reset) {
+      last_hold_ns_[i] = hold_ns[i];
+    }
+  }
+  if (reset) {
+    last_report_ns_ = now;
+  }
+
+  // 等待时间最长的线程
+  const size_t top = std::min((size_t)(top_n > 0 ? top_n : 0), threads.size());
+  std::partial_sort(threads.begin(), threads.begin() + top, threads.end(),
+                    [](const ThreadTotal &a, const ThreadTotal &b) { return a.total_wait_ns_ > b.total_wait_ns_; });
+  thai_databuff_printf(buf, buf_len, pos, ", top_waiters=[");
+  for (size_t t = 0; t < top; t++) {
+    const ThreadTotal &total = threads[t];
+    thai_databuff_printf(buf, buf_len, pos, "%s{tid=%ld", t > 0 ? ", " : "", total.tid_);
+    for (int i = 0; i < OB_THAI_LOCK_MAX; i++) {
+      thai_databuff_printf(buf, buf_len, pos, ", %s_wait_ms=%.3f, %s_hold_ms=%.3f, %s_acq=%lu",
+                           LOCK_NAMES[i], (double)total.wait_ns_[i] / 1e6,
+                           LOCK_NAMES[i], (double)total.hold_ns_[i] / 1e6,
+                           LOCK_NAMES[i], total.acquisitions_[i]);
+    }
+    thai_databuff_printf(buf, buf_len, pos, "}");
+  }
+  thai_databuff_printf(buf, buf_len, pos, "]");
+  return pos;
+}
+
+} // namespace thai
+} // namespace oceanbase
+
+int64_t thai_ftparser_contention_report(char *buf, int64_t buf_len)
+{
+  return oceanbase::thai::ObThaiContention::instance().report(buf, buf_len, 10, false);
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_CONTENTION_H_
+#define OB_THAI_FTPARSER_CONTENTION_H_
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+#include "thai_ftparser_common.h"
+#include "thai_ftparser_tls.h"
+
+namespace oceanbase {
+namespace thai {
+
+/// 被剖析的锁
+enum ObThaiLockId
+{
+  OB_THAI_LOCK_PYTHON_MUTEX = 0,   // g_python_mutex
+  OB_THAI_LOCK_GIL,                // PyGILState_Ensure/Release
+  OB_THAI_LOCK_MAX
+};
+
+const char *get_lock_name(ObThaiLockId id);
+
+/// 每线程的等待/持有统计
+struct ObThaiContentionSlot
+{
+  struct Lock
+  {
+    std::atomic<uint64_t> acquisitions_;
+    std::atomic<uint64_t> wait_ns_;
+    std::atomic<uint64_t> hold_ns_;
+    std::atomic<uint64_t> max_wait_ns_;
+    std::atomic<uint64_t> batches_;        // 持有期间提交的分词请求数
+    std::atomic<uint64_t> batch_bytes_;
+    std::atomic<uint64_t> batch_tokens_;
+  };
+  std::atomic<int64_t> tid_;               // 最近一次使用该槽位的线程
+  Lock                 locks_[OB_THAI_LOCK_MAX];
+
+  ObThaiContentionSlot();
+};
+
+/**
+ * @brief Wait versus hold time of g_python_mutex and the GIL, per thread.
+ * @details report() lists totals, the share of wall time each lock was
+ * held since the previous periodic report, the average work done per hold
+ * (the batch) and the threads that waited longest. Only the periodic
+ * report (reset) starts a new busy window; on-demand reports just read.
+ */
+class ObThaiContention final
+{
+public:
+  static ObThaiContention &instance();
+
+  void record_hold(ObThaiLockId id, int64_t wait_ns, int64_t hold_ns);
+  /// 记录一次在锁内完成的分词调用
+  void record_batch(ObThaiLockId id, int64_t bytes, int64_t tokens);
+
+  int64_t report(char *buf, int64_t buf_len, int64_t top_n, bool reset);
+
+private:
+  ObThaiContention() : last_report_ns_(thai_monotonic_ns()) {}
+  ObThaiContentionSlot *local_slot();
+
+  std::mutex report_lock_;
+  int64_t    last_report_ns_;
+  uint64_t   last_hold_ns_[OB_THAI_LOCK_MAX] = {};
+};
+
+/**
+ * @brief Times one acquisition of a profiled lock.
+ * @details Call begin() right before blocking, acquired() once the lock is
+ * held and released() right after giving it up. A timer still holding at
+ * destruction reports itself, so early return paths are covered.
+ */
+class ObThaiLockTimer final
+{
+public:
+  explicit ObThaiLockTimer(ObThaiLockId id) : id_(id) {}
+  ~ObThaiLockTimer() { released(); }
+
+  void begin() { wait_begin_ns_ = thai_monotonic_ns(); }
+  void acquired()
+  {
+    hold_begin_ns_ = thai_monotonic_ns();
+    if (0 == wait_begin_ns_) {
+      wait_begin_ns_ = hold_begin_ns_;
+    }
+  }
+  void released()
+  {
+    if (0 != hold_begin_ns_) {
+      ObThaiContention::instance().record_hold(id_, hold_begin_ns_ - wait_begin_ns_,
+                                               thai_monotonic_ns() - hold_begin_ns_);
+      hold_begin_ns_ = 0;
+      wait_begin_ns_ = 0;
+    }
+  }
+
+private:
+  ObThaiLockId id_;
+  int64_t      wait_begin_ns_ = 0;
+  int64_t      hold_begin_ns_ = 0;
+};
+
+} // namespace thai
+} // namespace oceanbase
+
+/**
+ * On-demand contention report, top 10 waiters. Does not start a new busy
+ * window, so the periodic summary is unaffected.
+ * @return bytes written, excluding the trailing '\0'
+ */
+THAI_EXPORT int64_t thai_ftparser_contention_report(char *buf, int64_t buf_len);
+
+#endif // OB_THAI_FTPARSER_CONTENTION_H_
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "thai_ftparser_dict.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "thai_ftparser_memory.h"
+#include "thai_ftparser_tcc.h"
+
+namespace oceanbase {
+namespace thai {
+
+static_assert(THAI_DICT_MAX_WORD_BYTES <= UINT8_MAX, "Entry::len_ is one byte");
+
+namespace {
+
+// 去掉行尾的 \r 和空白
+const char *trim_line(const char *line, const char *eol)
+{
+  while (eol > line && (' ' == eol[-1] || '\t' == eol[-1] || '\r' == eol[-1])) {
+    eol--;
+  }
+  return eol;
+}
+
+// 词必须全部是泰文字符且不超过长度限制，返回字符簇数，不合格返回 0
+int64_t count_word_clusters(const char *word, const char *end)
+{
+  int64_t clusters = 0;
+  if (end - word > THAI_DICT_MAX_WORD_BYTES) {
+    return 0;
+  }
+  for (const char *p = word; p < end; p += 3) {
+    if (!thai_is_thai_char(p, end)) {
+      return 0;
+    }
+  }
+  for (const char *p = word; p < end; p += thai_tcc_next(p, end)) {
+    clusters++;
+  }
+  return clusters <= THAI_DICT_MAX_WORD_CLUSTERS ? clusters : 0;
+}
+
+// 词代价按 1/16 比特计：第 rank 个词(从 0 起)在 Zipf 分布下的 -log2 P。
+// 归一化常数 H(N) ≈ ln N + γ，使短词切成多个高频词时也要付出代价
+const double COST_SCALE = 16.0;
+
+int32_t zipf_cost(int64_t rank, int64_t words)
+{
+  const double harmonic = log((double)words) + 0.5772;
+  const double bits = log2((double)(rank + 1)) + (harmonic > 1.0 ? log2(harmonic) : 0.0);
+  const double cost = COST_SCALE * bits + 0.5;
+  return cost < 1.0 ? 1 : (cost > (double)UINT16_MAX ? (int32_t)UINT16_MAX : (int32_t)cost);
+}
+
+} // namespace
+
+bool ObThaiDictionary::build(const char *data, int64_t len)
+{
+  reset();
+  const char *end = data + len;
+  // 第一遍：统计词池大小和表项上限(每个字符簇边界一个前缀)
+  int64_t pool_bytes = 0;
+  int64_t max_entries = 0;
+  int64_t words = 0;
+  for (const char *line = data; line < end;) {
+    const char *eol = (const char *)memchr(line, '\n', end - line);
+    eol = nullptr != eol ? eol : end;
+    const char *word_end = trim_line(line, eol);
+    if (word_end > line && '#' != *line) {
+      const int64_t clusters = count_word_clusters(line, word_end);
+      if (clusters > 0) {
+        pool_bytes += word_end - line;
+        max_entries += clusters;
+        words++;
+      } else {
+        rejected_count_++;
+      }
+    }
+    line = eol + 1;
+  }
+  if (pool_bytes > UINT32_MAX) {
+    return false;
+  }
+  uint64_t slot_count = 16;
+  while (slot_count < (uint64_t)max_entries * 2) {
+    slot_count <<= 1;
+  }
+  const int64_t table_bytes = (int64_t)(slot_count * sizeof(Entry));
+  block_ = (char *)thai_malloc(table_bytes + pool_bytes, OB_THAI_MEM_DICTIONARY);
+  if (nullptr == block_) {
+    return false;
+  }
+  allocated_ = table_bytes + pool_bytes;
+  slots_ = (Entry *)block_;
+  slot_mask_ = slot_count - 1;
+  pool_ = block_ + table_bytes;
+  memset(slots_, 0, table_bytes);
+  // 词典外的字符簇比排在最后的词还要罕见
+  unknown_cost_ = zipf_cost(words * 4, words > 0 ? words : 1) + (int32_t)COST_SCALE;
+
+  // 第二遍：复制词并登记词本身和它在每个字符簇边界上的前缀
+  uint32_t offset = 0;
+  for (const char *line = data; line < end;) {
+    const char *eol = (const char *)memchr(line, '\n', end - line);
+    eol = nullptr != eol ? eol : end;
+    const char *word_end = trim_line(line, eol);
+    if (word_end > line && '#' != *line && count_word_clusters(line, word_end) > 0) {
+      const int64_t word_len = word_end - line;
+      memcpy(pool_ + offset, line, word_len);
+      const int32_t cost = zipf_cost(word_count_, words);
+      uint64_t hash = hash_init();
+      for (const char *p = line; p < word_end;) {
+        const int64_t n = thai_tcc_next(p, word_end);
+        hash = hash_update(hash, p, n);
+        p += n;
+        insert(offset, p - line, hash, p < word_end ? FLAG_PREFIX : FLAG_WORD, cost);
+      }
+      offset += (uint32_t)word_len;
+      word_count_++;
+    }
+    line = eol + 1;
+  }
+  return true;
+}
+
+bool ObThaiDictionary::load(const char *path)
+{
+  FILE *fp = fopen(path, "rb");
+  if (nullptr == fp) {
+    return false;
+  }
+  // 整个文件读进一次分配，build 完即释放，加载期间也计入词典的内存
+  bool ret = false;
+  char *content = nullptr;
+  long size = -1;
+  if (0 == fseek(fp, 0, SEEK_END) && (size = ftell(fp)) >= 0 && 0 == fseek(fp, 0, SEEK_SET)
+      && nullptr != (content = (char *)thai_malloc(size > 0 ? size : 1, OB_THAI_MEM_DICTIONARY))) {
+    ret = (size_t)size == fread(content, 1, (size_t)size, fp);
+  }
+  fclose(fp);
+  ret = ret && build(content, (int64_t)size);
+  thai_free(content);
+  return ret;
+}
+
+void ObThaiDictionary::reset()
+{
+  if (nullptr != block_) {
+    thai_free(block_);
+  }
+  block_ = nullptr;
+  slots_ = nullptr;
+  slot_mask_ = 0;
+  pool_ = nullptr;
+  word_count_ = 0;
+  rejected_count_ = 0;
+  allocated_ = 0;
+  unknown_cost_ = 0;
+}
+
+void ObThaiDictionary::insert(uint32_t offset, int64_t len, uint64_t hash, int flags, int32_t cost)
+{
+  // 表容量至少是表项上限的两倍，线性探测一定能找到空槽
+  for (uint64_t i = hash & slot_mask_;; i = (i + 1) & slot_mask_) {
+    Entry &entry = slots_[i];
+    if (0 == entry.len_) {
+      entry.hash_ = hash;
+      entry.offset_ = offset;
+      entry.len_ = (uint8_t)len;
+      entry.flags_ = (uint8_t)flags;
+      entry.cost_ = (uint16_t)cost;
+      break;
+    } else if (entry.hash_ == hash && entry.len_ == len && 0 == memcmp(pool_ + entry.offset_, pool_ + offset, len)) {
+      // 重复的词取排名靠前的代价
+      if (0 != (flags & FLAG_WORD) && (0 == (entry.flags_ & FLAG_WORD) || cost < entry.cost_)) {
+        entry.cost_ = (uint16_t)cost;
+      }
+      entry.flags_ |= (uint8_t)flags;
+      break;
+    }
+  }
+}
+
+int ObThaiDictionary::lookup(const char *span, int64_t len, uint64_t hash, int32_t *cost) const
+{
+  int flags = 0;
+  if (nullptr != slots_) {
+    for (uint64_t i = hash & slot_mask_; 0 != slots_[i].len_; i = (i + 1) & slot_mask_) {
+      const Entry &entry = slots_[i];
+      if (entry.hash_ == hash && entry.len_ == len && 0 == memcmp(pool_ + entry.offset_, span, len)) {
+        flags = entry.flags_;
+        if (nullptr != cost) {
+          *cost = entry.cost_;
+        }
+        break;
+      }
+    }
+  }
+  return flags;
+}
+
+void ObThaiDictTokenizer::release()
+{
+  if (nullptr != block_) {
+    thai_free(block_);
+  }
+  block_ = nullptr;
+  bounds_ = nullptr;
+  cost_ = nullptr;
+  words_ = nullptr;
+  back_ = nullptr;
+  path_ = nullptr;
+  path_pos_ = 0;
+  path_count_ = 0;
+}
+
+void ObThaiDictTokenizer::solve()
+{
+  const int64_t K = THAI_DICT_MAX_WORD_CLUSTERS;
+  int64_t n = 0;
+  const char *p = next_;
+  bounds_[0] = p;
+  while (n < THAI_DICT_LATTICE_CLUSTERS && p < end_ && thai_is_thai_char(p, end_)) {
+    p += thai_tcc_next(p, end_);
+    bounds_[++n] = p;
+  }
+  const bool run_end = p >= end_ || !thai_is_thai_char(p, end_);
+
+  // 最大匹配时词典外的字符簇代价为 1、词为 0，即先比词典外字符簇数；
+  // Viterbi 时词代价来自词典，代价相同再比词数
+  const bool viterbi = OB_THAI_DICT_VITERBI == mode_;
+  const int32_t unknown_step = viterbi ? dict_->unknown_cost() : 1;
+  auto relax = [this](int64_t j, int32_t cost, int32_t words, int64_t from) {
+    if (cost < cost_[j] || (cost == cost_[j] && words < words_[j])) {
+      cost_[j] = cost;
+      words_[j] = words;
+      back_[j] = (int32_t)from;
+    }
+  };
+  cost_[0] = 0;
+  words_[0] = 0;
+  for (int64_t i = 1; i <= n; i++) {
+    cost_[i] = INT32_MAX;
+  }
+  for (int64_t i = 0; i < n; i++) {
+    const int32_t cost = cost_[i];
+    const int32_t words = words_[i] + 1;
+    // 单个字符簇总是一条边，保证任意输入都有路径
+    relax(i + 1, cost + unknown_step, words, i);
+    uint64_t hash = ObThaiDictionary::hash_init();
+    for (int64_t j = i + 1; j <= n && j - i <= K; j++) {
+      const int64_t cluster_len = bounds_[j] - bounds_[j - 1];
+      if (cluster_len > THAI_DICT_MAX_CLUSTER_BYTES || bounds_[j] - bounds_[i] > THAI_DICT_MAX_WORD_BYTES) {
+        break;
+      }
+      hash = ObThaiDictionary::hash_update(hash, bounds_[j - 1], cluster_len);
+      int32_t word_cost = 0;
+      const int flags = dict_->lookup(bounds_[i], bounds_[j] - bounds_[i], hash, viterbi ? &word_cost : nullptr);
+      if (0 != (flags & ObThaiDictionary::FLAG_WORD)) {
+        relax(j, cost + word_cost, words, i);
+      }
+      if (0 == (flags & ObThaiDictionary::FLAG_PREFIX)) {
+        break;
+      }
+    }
+  }
+
+  // 片段没结束时，最后 K 个字符簇的切分可能随后续文本改变，只提交之前的部分。
+  // 每条边不超过 K 个字符簇，所以路径上总有一个边界落在 (n - 2K, n - K]
+  int64_t commit = n;
+  while (!run_end && commit > n - K) {
+    commit = back_[commit];
+  }
+  path_count_ = 0;
+  for (int64_t node = commit; node > 0; node = back_[node]) {
+    path_[path_count_++] = (int32_t)node;
+  }
+  path_[path_count_++] = 0;
+  // 倒序得到从 0 开始的边界序列
+  for (int64_t i = 0, j = path_count_ - 1; i < j; i++, j--) {
+    const int32_t tmp = path_[i];
+    path_[i] = path_[j];
+    path_[j] = tmp;
+  }
+  path_pos_ = 0;
+  next_ = bounds_[commit];
+}
+
+bool ObThaiDictTokenizer::next(const char *&word, int64_t &word_len)
+{
+  if (path_pos_ + 1 < path_count_) {
+    word = bounds_[path_[path_pos_]];
+    word_len = bounds_[path_[path_pos_ + 1]] - word;
+    path_pos_++;
+    return true;
+  }
+  while (next_ < end_ && (' ' == *next_ || '\t' == *next_ || '\n' == *next_)) {
+    next_++;
+  }
+  if (next_ >= end_) {
+    return false;
+  }
+  const char *start = next_;
+  if (!thai_is_thai_char(next_, end_)) {
+    while (next_ < end_ && ' ' != *next_ && '\t' != *next_ && '\n' != *next_
+           && !thai_is_thai_char(next_, end_)) {
+      next_ += thai_utf8_char_len(next_, end_);
+    }
+  } else if (nullptr == dict_ || (nullptr == block_ && !alloc_lattice())) {
+    // 没有词典或网格分配失败时退化为按字符簇切分
+    next_ += thai_tcc_next(next_, end_);
+  } else {
+    solve();
+    return next(word, word_len);
+  }
+  word = start;
+  word_len = next_ - start;
+  return true;
+}
+
+bool ObThaiDictTokenizer::alloc_lattice()
+{
+  const int64_t nodes = THAI_DICT_LATTICE_CLUSTERS + 1;
+  block_ = (char *)thai_malloc(LATTICE_BYTES, OB_THAI_MEM_LATTICE);
+  if (nullptr != block_) {
+    bounds_ = (const char **)block_;
+    cost_ = (int32_t *)(block_ + nodes * sizeof(const char *));
+    words_ = cost_ + nodes;
+    back_ = words_ + nodes;
+    path_ = back_ + nodes;
+  }
+  return nullptr != block_;
+}
+
+} // namespace thai
+} // namespace oceanbase
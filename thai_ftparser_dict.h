@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_DICT_H_
+#define OB_THAI_FTPARSER_DICT_H_
+
+#include <stdint.h>
+
+#include "thai_ftparser_common.h"
+
+namespace oceanbase {
+namespace thai {
+
+/**
+ * @brief Dictionary segmentation over TCC clusters in guaranteed linear time.
+ * @details Words start and end on cluster boundaries. A run of Thai text is
+ * cut by a shortest path over the cluster lattice: fewest clusters left
+ * outside dictionary words first, then fewest words (maximal matching).
+ *
+ * Hard limits, so hostile input cannot make the cost per byte grow:
+ * - a word spans at most THAI_DICT_MAX_WORD_CLUSTERS clusters and
+ *   THAI_DICT_MAX_WORD_BYTES bytes, longer entries are dropped at load.
+ *   This is the lattice width: a node has at most that many outgoing edges;
+ * - a cluster longer than THAI_DICT_MAX_CLUSTER_BYTES (e.g. thousands of
+ *   stacked tone marks) is never looked up and is a token of its own;
+ *   the parser drops any token of THAI_MAX_TOKEN_BYTES (1000) or more, as
+ *   it does for the Python engine, so such a cluster is not indexed;
+ * - the lattice holds at most THAI_DICT_LATTICE_CLUSTERS clusters. Longer
+ *   runs are solved window by window and only the path up to
+ *   THAI_DICT_MAX_WORD_CLUSTERS clusters before the window end is kept;
+ * - clusters no dictionary word covers fall back to one token per cluster,
+ *   the same as the TCC engine.
+ *
+ * Per cluster that is at most THAI_DICT_MAX_WORD_CLUSTERS hash probes over
+ * at most THAI_DICT_MAX_WORD_BYTES hashed bytes. Every dictionary prefix
+ * is in the table too, so the scan stops at the first span that no word
+ * starts with. Text with no dictionary match costs one probe per cluster.
+ */
+static const int64_t THAI_DICT_MAX_WORD_CLUSTERS = 16;
+static const int64_t THAI_DICT_MAX_WORD_BYTES = 96;        // 32 个泰文字符
+static const int64_t THAI_DICT_MAX_CLUSTER_BYTES = 36;     // 12 个泰文字符
+static const int64_t THAI_DICT_LATTICE_CLUSTERS = 1024;
+
+/// 网格上的最短路径目标
+enum ObThaiDictMode
+{
+  OB_THAI_DICT_MAXIMAL = 0,   // 最大匹配：词典外字符簇最少，其次词数最少
+  OB_THAI_DICT_VITERBI,       // 一元语言模型：词代价之和最小
+};
+
+/**
+ * @brief Read-only word table shared by all scans.
+ * @details Open addressing hash table keyed by the bytes of a word or of a
+ * word prefix cut at a cluster boundary. Words are stored once in a pool;
+ * prefix entries point into the word they came from. Not copyable.
+ */
+class ObThaiDictionary final
+{
+public:
+  enum
+  {
+    FLAG_WORD = 1,        // 完整的词
+    FLAG_PREFIX = 2,      // 某个更长的词在字符簇边界上的前缀
+  };
+
+  ObThaiDictionary() = default;
+  ~ObThaiDictionary() { reset(); }
+  ObThaiDictionary(const ObThaiDictionary &) = delete;
+  ObThaiDictionary &operator=(const ObThaiDictionary &) = delete;
+
+  /// 每行一个词，忽略空行和 # 开头的行。@return false if allocation failed
+  bool build(const char *data, int64_t len);
+  /// @return false if the file cannot be read or allocation failed
+  bool load(const char *path);
+  void reset();
+
+  int64_t word_count() const { return word_count_; }
+  /// 超出长度限制或含非泰文字符而被丢弃的行数
+  int64_t rejected_count() const { return rejected_count_; }
+  int64_t allocated() const { return allocated_; }
+
+  static uint64_t hash_init() { return 1469598103934665603ULL; }
+  static uint64_t hash_update(uint64_t hash, const char *p, int64_t len)
+  {
+    for (int64_t i = 0; i < len; i++) {
+      hash = (hash ^ (unsigned char)p[i]) * 1099511628211ULL;
+    }
+    return hash;
+  }
+  /**
+   * @param hash hash_update() over the span
+   * @param cost if not null, receives the word cost when FLAG_WORD is set
+   * @return FLAG_* bits, 0 if absent
+   */
+  int lookup(const char *span, int64_t len, uint64_t hash, int32_t *cost = nullptr) const;
+  /**
+   * @brief Cost of a cluster no word covers, above the cost of any word.
+   * @details Word costs are -log2 of a Zipf probability by line number,
+   * so the word list is expected to be sorted most frequent first.
+   */
+  int32_t unknown_cost() const { return unknown_cost_; }
+
+private:
+  struct Entry
+  {
+    uint64_t hash_;
+    uint32_t offset_;      // 在 pool_ 中的起点
+    uint8_t  len_;         // 0 表示空槽，不超过 THAI_DICT_MAX_WORD_BYTES
+    uint8_t  flags_;
+    uint16_t cost_;        // 词代价，只对 FLAG_WORD 有意义
+  };
+
+  void insert(uint32_t offset, int64_t len, uint64_t hash, int flags, int32_t cost);
+
+  char *   block_ = nullptr;     // 哈希表和词池一次分配
+  Entry *  slots_ = nullptr;
+  uint64_t slot_mask_ = 0;
+  char *   pool_ = nullptr;
+  int64_t  word_count_ = 0;
+  int64_t  rejected_count_ = 0;
+  int64_t  allocated_ = 0;
+  int32_t  unknown_cost_ = 0;
+};
+
+/**
+ * @brief Streams dictionary tokens out of a text; tokens point into it.
+ * @details Whitespace separates tokens as in ObThaiTccTokenizer, and a
+ * non-Thai run is one token. OB_THAI_DICT_VITERBI runs over the same
+ * lattice with word costs as edge weights, so the same limits hold. The lattice is allocated on the first Thai
+ * run; if that fails the tokenizer falls back to plain TCC clusters.
+ */
+class ObThaiDictTokenizer final
+{
+public:
+  ObThaiDictTokenizer() = default;
+  ~ObThaiDictTokenizer() { release(); }
+  ObThaiDictTokenizer(const ObThaiDictTokenizer &) = delete;
+  ObThaiDictTokenizer &operator=(const ObThaiDictTokenizer &) = delete;
+
+  void reset(const ObThaiDictionary *dict, const char *begin, const char *end,
+             ObThaiDictMode mode = OB_THAI_DICT_MAXIMAL)
+  {
+    dict_ = dict;
+    mode_ = mode;
+    next_ = begin;
+    end_ = end;
+    path_pos_ = 0;
+    path_count_ = 0;
+  }
+  /// @return false once the text is exhausted
+  bool next(const char *&word, int64_t &word_len);
+  /// 释放分词网格
+  void release();
+  int64_t allocated() const { return nullptr != block_ ? LATTICE_BYTES : 0; }
+
+  /// 分词网格的大小，与文本长度无关
+  static const int64_t LATTICE_BYTES = (THAI_DICT_LATTICE_CLUSTERS + 1)
+      * (int64_t)(sizeof(const char *) + 4 * sizeof(int32_t));
+
+private:
+
+  bool alloc_lattice();
+  /// 对 next_ 开始的泰文片段建网格求最短路径，结果放入 path_
+  void solve();
+
+  const ObThaiDictionary *dict_ = nullptr;
+  ObThaiDictMode mode_ = OB_THAI_DICT_MAXIMAL;
+  const char *next_ = nullptr;
+  const char *end_ = nullptr;
+
+  char *        block_ = nullptr;
+  const char ** bounds_ = nullptr;    // 字符簇边界
+  int32_t *     cost_ = nullptr;      // 到达该边界的代价：词典外字符簇数或词代价之和
+  int32_t *     words_ = nullptr;     // 到达该边界时的词数，代价相同时取少的
+  int32_t *     back_ = nullptr;      // 最短路径上的前一个边界
+  int32_t *     path_ = nullptr;      // 待输出的边界序号
+  int64_t       path_pos_ = 0;
+  int64_t       path_count_ = 0;
+};
+
+} // namespace thai
+} // namespace oceanbase
+
+#endif // OB_THAI_FTPARSER_DICT_H_
@@ -4,12 +4,27 @@
  * SIGABRT FIX
  */
 #include <new>
+#ifndef THAI_FTPARSER_DISABLE_PYTHON
 #include <Python.h>
+#endif
 #include <pthread.h>
 #include <signal.h>
 #include <setjmp.h>
 
 #include "oceanbase/ob_plugin_ftparser.h"
+#include "thai_ftparser_config.h"
+#include "thai_ftparser_contention.h"
+#include "thai_ftparser_dict.h"
+#include "thai_ftparser_histogram.h"
+#include "thai_ftparser_log.h"
+#include "thai_ftparser_memory.h"
+#include "thai_ftparser_metrics.h"
+#include "thai_ftparser_probes.h"
+#include "thai_ftparser_segmenter.h"
+#include "thai_ftparser_shadow.h"
+#include "thai_ftparser_slowlog.h"
+#include "thai_ftparser_stats.h"
+#include "thai_ftparser_tcc.h"
 
 /**
  * @defgroup ThaiFtParser Thai Fulltext Parser Plugin - Emergency Fix
@@ -21,184 +36,622 @@ namespace oceanbase {
 namespace thai {
 
 // 全局静态变量 - 增强版
+static bool g_emergency_shutdown = false;
+
+#ifndef THAI_FTPARSER_DISABLE_PYTHON
 static pthread_mutex_t g_python_mutex;
 static pthread_once_t g_mutex_once = PTHREAD_ONCE_INIT;
 static bool g_python_initialized = false;
 static PyObject* g_pModule = nullptr;
 static PyObject* g_pTokenizerClass = nullptr;
 static int g_ref_count = 0;
-static bool g_emergency_shutdown = false;
 
 // 初始化互斥锁
 static void init_mutex() {
     pthread_mutex_init(&g_python_mutex, nullptr);
 }
 
+// Python 对象大小估算：对象头 + 字符数据 + 已缓存的 UTF-8 表示
+static int64_t estimate_unicode_size(PyObject* obj) {
+    return (int64_t)sizeof(PyCompactUnicodeObject)
+        + (int64_t)(PyUnicode_GET_LENGTH(obj) + 1) * PyUnicode_KIND(obj);
+}
+
+static int64_t estimate_list_size(PyObject* list) {
+    return (int64_t)sizeof(PyListObject) + (int64_t)PyList_GET_SIZE(list) * (int64_t)sizeof(PyObject*);
+}
+#endif // THAI_FTPARSER_DISABLE_PYTHON
+
 // 信号处理器
 static void signal_handler(int sig) {
     g_emergency_shutdown = true;
     OBP_LOG_WARN("Emergency shutdown triggered by signal %d", sig);
 }
 
-class ObThaiFTParser final
+/// 构造解析器之前按配置和文档内容选好的引擎，决定用哪个特化
+struct ObThaiDocRoute
+{
+  ObThaiEngineType   engine_ = OB_THAI_ENGINE_SPACE;
+  ObThaiDegradeLevel degrade_ = OB_THAI_DEGRADE_NONE;
+  int32_t            thai_permille_ = 0;
+  int64_t            begin_ns_ = 0;
+  int64_t            reserved_bytes_ = 0;   // 内存预算里为本文档预留的字节数
+};
+
+/// 分配策略：直接向堆申请
+struct ObThaiHeapAlloc
+{
+  static void *allocate(size_t size) { return thai_malloc(size, OB_THAI_MEM_PARSER); }
+  static void deallocate(void *ptr, size_t size, bool cacheable) { thai_free(ptr); }
+};
+
+/**
+ * @brief Allocation policy that keeps freed parsers per thread.
+ * @details A parser lives for one document, so each scan_begin/scan_end
+ * pair costs a malloc and a free, and inside the observer these go
+ * through its malloc hook. Each thread keeps up to PARSER_CACHE_SLOTS
+ * blocks of PARSER_CACHE_BLOCK bytes for the next scan; larger objects
+ * go to the heap, and so does every block freed while the memory budget
+ * is at OB_THAI_DEGRADE_NO_CACHE or above.
+ */
+struct ObThaiThreadCacheAlloc
+{
+  static const size_t PARSER_CACHE_BLOCK = 1024;
+  static const int PARSER_CACHE_SLOTS = 2;
+
+  static void *allocate(size_t size);
+  static void deallocate(void *ptr, size_t size, bool cacheable);
+};
+
+/// 归一化策略：char_len 取字节长度，与各引擎一直以来的输出一致
+struct ObThaiByteLenNorm
+{
+  static int64_t char_len(const char *word, int64_t word_len) { return word_len; }
+};
+
+/// 归一化策略：char_len 取 UTF-8 字符数，min/max token size 过滤才按字符计算
+struct ObThaiUtf8CharNorm
+{
+  static int64_t char_len(const char *word, int64_t word_len)
+  {
+    int64_t count = 0;
+    for (int64_t i = 0; i < word_len; i++) {
+      count += 0x80 != ((unsigned char)word[i] & 0xC0) ? 1 : 0;
+    }
+    return count;
+  }
+};
+
+/**
+ * @brief What the plugin entry points see of a parser.
+ * @details Holds the per-document state and the code that does not depend
+ * on the engine: argument checks, the charset fallback and the stats. The
+ * token loop lives in ObThaiFTParser below.
+ */
+class ObIThaiFTParser
 {
 public:
-  ObThaiFTParser() = default;
-  virtual ~ObThaiFTParser();
+  virtual ~ObIThaiFTParser() {}
 
-  int init(ObPluginFTParserParamPtr param);
-  void reset();
-  int get_next_token(
+  virtual int init(ObPluginFTParserParamPtr param, const ObThaiDocRoute &route) = 0;
+  virtual int get_next_token(
+      const char *&word,
+      int64_t &word_len,
+      int64_t &char_len,
+      int64_t &word_freq) = 0;
+  /// 析构并按构造时的分配策略释放，代替 delete
+  virtual void destroy() = 0;
+
+protected:
+  /// 校验参数并记下文档，返回成功且 is_inited_ 时才启动引擎
+  int init_document(ObPluginFTParserParamPtr param, const ObThaiDocRoute &route);
+  /// 引擎启动之后调用
+  void end_init(const ObThaiDocRoute &route);
+  void record_stats(int64_t parser_bytes);
+  void reset_document();
+  /// 引擎没有产出任何 token 时按字符集扫描原文
+  int next_charset_token(
       const char *&word,
       int64_t &word_len,
       int64_t &char_len,
       int64_t &word_freq);
 
-private:
-  int initialize_python_safe();
-  int tokenize_text_safe();
-  int tokenize_with_spaces();
-  int is_thai_text(const char* text, int64_t len);
-  void cleanup_python_safe();
-  bool check_python_health();
-  
   ObPluginDatum  cs_   = 0;
   const char *   start_     = nullptr;
   const char *   next_      = nullptr;
   const char *   end_       = nullptr;
   bool           is_inited_ = false;
-  
+  bool           charset_fallback_ = false;  // 引擎没有产出 token，余下的原文按字符集扫描
+  bool           engine_tokens_ = false;     // 引擎产出过 token，包括超长被丢弃的
+
+  // 统计信息，在 reset 时提交。引擎大多在取 token 时才分词，
+  // 所以 doc_ns_ 和 segment_ns_ 都包含 get_next_token 的耗时
+  ObThaiPath path_ = OB_THAI_PATH_MAX;
+  const char *doc_begin_ = nullptr;  // 原文起点，start_ 会随字符集扫描后移
+  int64_t doc_bytes_ = 0;
+  int64_t doc_ns_ = 0;             // scan_begin 加上所有 next_token
+  int64_t segment_ns_ = 0;         // 启动引擎加上所有 next_token
+  int64_t tokens_emitted_ = 0;
+  int32_t thai_permille_ = 0;
+
+  // 内存预算降级，预留的字节数在 reset_document 时归还
+  ObThaiDegradeLevel degrade_ = OB_THAI_DEGRADE_NONE;
+  int64_t budget_reserved_ = 0;
+
+  // 影子模式抽中的文档，输出的 token 都记到这里，见 thai_ftparser_shadow.h
+  ObThaiShadowDoc *shadow_ = nullptr;
+};
+
+/**
+ * @brief Parser specialized at compile time on its policies.
+ * @details Segmenter is a concrete final segmenter, so next() is a direct
+ * call the compiler can inline into get_next_token(), or
+ * ObThaiDynamicSegmenter, which looks the engine up in the registry. Alloc
+ * places the parser object, Norm computes char_len. The engine is chosen
+ * per document in scan_begin, before the parser is constructed, since
+ * auto routing and the memory budget both depend on the text; see
+ * create_parser() for the instantiations and THAI_PARSER_SPECS for the
+ * parser names built on them.
+ */
+template <typename Segmenter, typename Alloc, typename Norm>
+class ObThaiFTParser final : public ObIThaiFTParser
+{
+public:
+  static ObIThaiFTParser *create(ObThaiEngineType engine)
+  {
+    void *buf = Alloc::allocate(sizeof(ObThaiFTParser));
+    return nullptr != buf ? new (buf) ObThaiFTParser(engine) : nullptr;
+  }
+  ~ObThaiFTParser() override { reset(); }
+
+  int init(ObPluginFTParserParamPtr param, const ObThaiDocRoute &route) override;
+  int get_next_token(
+      const char *&word,
+      int64_t &word_len,
+      int64_t &char_len,
+      int64_t &word_freq) override;
+  void destroy() override
+  {
+    // 内存紧张时对象不留在线程缓存里
+    const bool cacheable = degrade_ < OB_THAI_DEGRADE_NO_CACHE;
+    this->~ObThaiFTParser();
+    Alloc::deallocate(this, sizeof(ObThaiFTParser), cacheable);
+  }
+
+private:
+  explicit ObThaiFTParser(ObThaiEngineType engine);
+  void reset();
+  void begin_segment(ObThaiEngineType engine);
+  /// 引擎的下一个 token，引擎没有产出任何 token 时改由字符集扫描
+  int next_engine_token(
+      const char *&word,
+      int64_t &word_len,
+      int64_t &char_len,
+      int64_t &word_freq);
+
+  Segmenter segmenter_;
+};
+
+#ifndef THAI_FTPARSER_DISABLE_PYTHON
+/**
+ * @brief Bridge to the thai_tokenizer Python module.
+ * @details Text beyond MAX_TEXT_BYTES is dropped. At the windowed memory level
+ * the text is handed to Python window by window, and a window Python fails
+ * on is split on whitespace instead.
+ */
+class ObThaiPythonSegmenter final : public ObThaiSegmenter
+{
+public:
+  static const int64_t MAX_TEXT_BYTES = 10000;
+
+  ~ObThaiPythonSegmenter() override { end_document(); }
+
+  bool begin_document(const ObThaiSegmentParam &param) override;
+  bool next(const char *&word, int64_t &word_len) override;
+  void end_document() override;
+  int64_t allocated() const override { return doc_mem_bytes_; }
+  /// 只有交给 Python 的部分占内存：截断后的正文，分窗时一个窗口
+  static int64_t projected_bytes(int64_t doc_bytes, bool windowed)
+  {
+    int64_t bytes = doc_bytes < MAX_TEXT_BYTES ? doc_bytes : MAX_TEXT_BYTES;
+    const int64_t window_bytes = ObThaiMemBudget::instance().window_bytes();
+    if (windowed && bytes > window_bytes) {
+      bytes = window_bytes;
+    }
+    return bytes * ObThaiMemBudget::DOC_COST_FACTOR;
+  }
+
+private:
+  int initialize_python_safe();
+  int tokenize_text_safe(const char* begin, const char* end);
+  int tokenize_next_window();
+  void cleanup_python_safe();
+  bool check_python_health();
+
   // Python相关
   PyObject* pTokenizer_ = nullptr;
   PyObject* pSplitFunc_ = nullptr;
   bool instance_has_python_ = false;
-  
-  // 分词结果
-  char** tokens_ = nullptr;
-  int token_count_ = 0;
-  int current_token_index_ = 0;
+
+  // 当前窗口的分词结果，一次分配
+  ObThaiTokenArena tokens_;
+  int64_t current_token_index_ = 0;
+  int64_t doc_mem_bytes_ = 0;           // 本文档的内存峰值(arena + Python 估算)
+
+  ObThaiDegradeLevel degrade_ = OB_THAI_DEGRADE_NONE;
+  const char* doc_begin_ = nullptr;
+  const char* window_begin_ = nullptr;  // 下一个待切分窗口的起点
+  const char* text_end_ = nullptr;      // 交给 Python 的正文终点(已按长度上限截断)
+  bool space_window_ = false;           // 当前窗口 Python 失败，按空格切分
+  ObThaiSpaceSegmenter space_;
 };
+#endif
+
+// 词典只加载一次，进程内所有解析器共享；未配置或加载失败时为空词典，dict 引擎退化为按字符簇切分
+static bool load_dictionary(ObThaiDictionary &dict)
+{
+  const std::string &path = ObThaiConfig::instance().dict_path_;
+  bool ret = false;
+  if (path.empty()) {
+    OBP_LOG_WARN("OB_THAI_FTPARSER_DICT_PATH is not set, dict engine splits by TCC only");
+  } else if (!dict.load(path.c_str())) {
+    OBP_LOG_WARN("failed to load thai dictionary. path=%s", path.c_str());
+  } else {
+    OBP_LOG_INFO("thai dictionary loaded. path=%s, words=%ld, rejected=%ld, bytes=%ld",
+                 path.c_str(), dict.word_count(), dict.rejected_count(), dict.allocated());
+    ret = true;
+  }
+  return ret;
+}
+
+static const ObThaiDictionary &get_dictionary()
+{
+  static ObThaiDictionary dict;
+  // 局部静态变量初始化线程安全，并发的首次调用会等待加载完成
+  static const bool loaded = load_dictionary(dict);
+  (void)loaded;
+  return dict;
+}
 
-ObThaiFTParser::~ObThaiFTParser()
+#ifndef THAI_FTPARSER_DISABLE_PYTHON
+// 在 window_bytes 内找最后一个空白，找不到则取最后一个字符簇边界
+static const char* find_window_end(const char* begin, const char* end, int64_t window_bytes)
 {
-  reset();
+  if (end - begin <= window_bytes) {
+    return end;
+  }
+  const char* limit = begin + window_bytes;
+  const char* cur = begin;
+  const char* last_space = nullptr;
+  while (cur < limit) {
+    if (*cur == ' ' || *cur == '\t' || *cur == '\n') {
+      last_space = cur + 1;
+    }
+    int64_t n = thai_tcc_next(cur, end);
+    if (cur + n > limit) {
+      break;
+    }
+    cur += n;
+  }
+  const char* cut = nullptr != last_space ? last_space : cur;
+  return cut > begin ? cut : begin + thai_tcc_next(begin, end);
 }
+#endif
+
+namespace {
 
-void ObThaiFTParser::reset()
+// 每个线程缓存的解析器对象，线程退出时释放
+struct ObThaiParserCache
+{
+  void *slots_[ObThaiThreadCacheAlloc::PARSER_CACHE_SLOTS] = {};
+  int   count_ = 0;
+  ~ObThaiParserCache()
+  {
+    while (count_ > 0) {
+      thai_free(slots_[--count_]);
+    }
+  }
+};
+
+thread_local ObThaiParserCache t_parser_cache;
+
+// 特化的引擎编译期确定；动态引擎构造后要告诉它引擎类型，启动后再问它实际走的路径
+template <typename Segmenter>
+inline void bind_engine(Segmenter &, ObThaiEngineType) {}
+
+inline void bind_engine(ObThaiDynamicSegmenter &segmenter, ObThaiEngineType engine)
+{
+  segmenter.set_engine(engine);
+}
+
+template <typename Segmenter>
+inline ObThaiPath segment_path(const Segmenter &, ObThaiEngineType engine)
+{
+  return ObThaiSegmenterRegistry::instance().path(engine);
+}
+
+inline ObThaiPath segment_path(const ObThaiDynamicSegmenter &segmenter, ObThaiEngineType)
+{
+  return segmenter.path();
+}
+
+// 引擎没有产出 token 时是否按字符集再扫一遍；只要 ASCII 的解析器不能输出其他字符
+template <typename Segmenter>
+inline bool use_charset_fallback(const Segmenter &) { return true; }
+
+inline bool use_charset_fallback(const ObThaiAsciiSegmenter &) { return false; }
+
+} // namespace
+
+void *ObThaiThreadCacheAlloc::allocate(size_t size)
+{
+  ObThaiParserCache &cache = t_parser_cache;
+  void *ptr = nullptr;
+  if (size > PARSER_CACHE_BLOCK) {
+    ptr = thai_malloc(size, OB_THAI_MEM_PARSER);
+  } else if (cache.count_ > 0) {
+    ptr = cache.slots_[--cache.count_];
+  } else {
+    ptr = thai_malloc(PARSER_CACHE_BLOCK, OB_THAI_MEM_PARSER);
+  }
+  return ptr;
+}
+
+void ObThaiThreadCacheAlloc::deallocate(void *ptr, size_t size, bool cacheable)
+{
+  ObThaiParserCache &cache = t_parser_cache;
+  if (cacheable && size <= PARSER_CACHE_BLOCK && cache.count_ < PARSER_CACHE_SLOTS) {
+    cache.slots_[cache.count_++] = ptr;
+  } else {
+    thai_free(ptr);
+  }
+}
+
+void ObIThaiFTParser::reset_document()
 {
   cs_ = 0;
   start_ = nullptr;
   next_ = nullptr;
   end_ = nullptr;
   is_inited_ = false;
-  current_token_index_ = 0;
-  
-  // 清理tokens
-  if (tokens_) {
-    for (int i = 0; i < token_count_; i++) {
-      if (tokens_[i]) {
-        free(tokens_[i]);
-      }
-    }
-    free(tokens_);
-    tokens_ = nullptr;
-  }
-  token_count_ = 0;
-  
-  cleanup_python_safe();
+  charset_fallback_ = false;
+  engine_tokens_ = false;
+  degrade_ = OB_THAI_DEGRADE_NONE;
+  ObThaiMemBudget::instance().release(budget_reserved_);
+  budget_reserved_ = 0;
 }
 
-bool ObThaiFTParser::check_python_health() {
-  // 检查 Python 解释器健康状态
-  if (!Py_IsInitialized()) {
-    OBP_LOG_WARN("Python interpreter not initialized");
-    return false;
+void ObIThaiFTParser::record_stats(int64_t parser_bytes)
+{
+  if (nullptr != shadow_) {
+    shadow_->primary_ns_ = doc_ns_;
+    ObThaiShadow::instance().submit(shadow_);
+    shadow_ = nullptr;
   }
-  
-  // Python 3.12 中 PyGILState_Check() 返回 int，不是 PyGILState_STATE
-  // 简化健康检查，避免使用已弃用的 API
-  try {
-    // 尝试获取 GIL 状态来验证 Python 环境
-    PyGILState_STATE gstate = PyGILState_Ensure();
-    PyGILState_Release(gstate);
-    return true;
-  } catch (...) {
-    OBP_LOG_WARN("Python GIL state check failed");
-    return false;
+  if (is_inited_) {
+    ObThaiLatency::instance().record(OB_THAI_STAGE_SEGMENT, segment_ns_);
+    ObThaiSlowDocSampler::instance().sample(doc_begin_, doc_bytes_, thai_permille_, path_, doc_ns_);
+  }
+  if (path_ < OB_THAI_PATH_MAX) {
+    ObThaiStats::instance().record_doc(path_, doc_bytes_, tokens_emitted_, doc_ns_);
+    THAI_PROBE4(doc__end, doc_bytes_, tokens_emitted_, doc_ns_, (int)path_);
+    ObThaiMemStat::instance().record_parser_bytes(parser_bytes);
   }
+  path_ = OB_THAI_PATH_MAX;
+  doc_begin_ = nullptr;
+  doc_bytes_ = 0;
+  doc_ns_ = 0;
+  segment_ns_ = 0;
+  tokens_emitted_ = 0;
+  thai_permille_ = 0;
 }
 
-int ObThaiFTParser::init(ObPluginFTParserParamPtr param)
+int ObIThaiFTParser::init_document(ObPluginFTParserParamPtr param, const ObThaiDocRoute &route)
 {
   int ret = OBP_SUCCESS;
   const char *fulltext = obp_ftparser_fulltext(param);
   int64_t ft_length = obp_ftparser_fulltext_length(param);
   ObPluginCharsetInfoPtr cs = obp_ftparser_charset_info(param);
 
+  // 预留从这里起归解析器所有，失败路径也由 reset_document 归还
+  budget_reserved_ += route.reserved_bytes_;
+
   // 安装信号处理器
   signal(SIGABRT, signal_handler);
   signal(SIGSEGV, signal_handler);
 
   if (g_emergency_shutdown) {
-    OBP_LOG_WARN("Emergency shutdown mode, using fallback tokenizer");
-    ret = tokenize_with_spaces();
-    return ret;
-  }
-
-  if (is_inited_) {
+    THAI_LOG_WARN("Emergency shutdown mode, using fallback tokenizer");
+    path_ = OB_THAI_PATH_EMERGENCY;
+    doc_bytes_ = ft_length;
+    doc_ns_ = thai_monotonic_ns() - route.begin_ns_;
+    ObThaiStats::instance().record_fallback(OB_THAI_FALLBACK_EMERGENCY);
+    THAI_PROBE2(fallback, (int)OB_THAI_FALLBACK_EMERGENCY, ft_length);
+  } else if (is_inited_) {
     ret = OBP_INIT_TWICE;
-    OBP_LOG_WARN("init twice. ret=%d, param=%p, this=%p", ret, param, this);
+    THAI_LOG_WARN("init twice. ret=%d, param=%p, this=%p", ret, param, this);
   } else if (0 == param
       || 0 == cs
       || nullptr == fulltext
       || 0 >= ft_length) {
     ret = OBP_INVALID_ARGUMENT;
-    OBP_LOG_WARN("invalid arguments, ret=%d, param=%p", ret, param);
+    THAI_LOG_WARN("invalid arguments, ret=%d, param=%p", ret, param);
   } else {
     cs_ = cs;
     start_ = fulltext;
     next_ = start_;
     end_ = start_ + ft_length;
     is_inited_ = true;
-    current_token_index_ = 0;
-    
-    // 检查是否为泰语文本
-    if (is_thai_text(fulltext, ft_length)) {
-      OBP_LOG_INFO("Detected Thai text, attempting safe Python initialization");
-      ret = initialize_python_safe();
-      if (ret == OBP_SUCCESS) {
-        OBP_LOG_INFO("Python initialized successfully, attempting safe tokenization");
-        ret = tokenize_text_safe();
-        if (ret != OBP_SUCCESS) {
-          OBP_LOG_WARN("Safe tokenization failed, falling back to space tokenization");
-          ret = tokenize_with_spaces();
-        }
-      } else {
-        OBP_LOG_WARN("Safe Python initialization failed, using space tokenization");
-        ret = tokenize_with_spaces();
-      }
-    } else {
-      OBP_LOG_INFO("Non-Thai text detected, using space tokenization");
-      ret = tokenize_with_spaces();
-    }
+    doc_begin_ = fulltext;
+    doc_bytes_ = ft_length;
+    thai_permille_ = route.thai_permille_;
+    degrade_ = route.degrade_;
+  }
+  return ret;
+}
+
+void ObIThaiFTParser::end_init(const ObThaiDocRoute &route)
+{
+  doc_ns_ = thai_monotonic_ns() - route.begin_ns_;
+  THAI_PROBE2(engine, (int)path_, thai_permille_);
+  // 内存紧张时不抽样，影子模式不能加重降级
+  if (OB_THAI_DEGRADE_NONE == degrade_) {
+    shadow_ = ObThaiShadow::instance().sample(doc_begin_, doc_bytes_, path_);
+  }
+}
+
+template <typename Segmenter, typename Alloc, typename Norm>
+ObThaiFTParser<Segmenter, Alloc, Norm>::ObThaiFTParser(ObThaiEngineType engine)
+{
+  bind_engine(segmenter_, engine);
+}
+
+template <typename Segmenter, typename Alloc, typename Norm>
+void ObThaiFTParser<Segmenter, Alloc, Norm>::reset()
+{
+  record_stats((int64_t)sizeof(*this) + segmenter_.allocated());
+  segmenter_.end_document();
+  reset_document();
+}
+
+template <typename Segmenter, typename Alloc, typename Norm>
+void ObThaiFTParser<Segmenter, Alloc, Norm>::begin_segment(ObThaiEngineType engine)
+{
+  const int64_t begin_ns = thai_monotonic_ns();
+  ObThaiSegmentParam param;
+  param.begin_ = start_;
+  param.end_ = end_;
+  param.degrade_ = degrade_;
+  param.get_dict_ = get_dictionary;
+  // 特化的引擎总是成功，只有动态引擎会退回空格分词
+  if (!segmenter_.begin_document(param)) {
+    THAI_LOG_WARN("%s engine failed, using space tokenization", get_engine_name(engine));
+  }
+  path_ = segment_path(segmenter_, engine);
+  segment_ns_ += thai_monotonic_ns() - begin_ns;
+}
+
+template <typename Segmenter, typename Alloc, typename Norm>
+int ObThaiFTParser<Segmenter, Alloc, Norm>::init(ObPluginFTParserParamPtr param, const ObThaiDocRoute &route)
+{
+  int ret = init_document(param, route);
+  if (OBP_SUCCESS == ret && is_inited_) {
+    begin_segment(route.engine_);
+    end_init(route);
   }
-  
   if (ret != OBP_SUCCESS && !is_inited_) {
     reset();
   }
-  OBP_LOG_INFO("thai ftparser init done. ret=%d", ret);
+  THAI_LOG_TRACE("thai ftparser init done. ret=%d", ret);
   return ret;
 }
 
-int ObThaiFTParser::initialize_python_safe()
+template <typename Segmenter, typename Alloc, typename Norm>
+int ObThaiFTParser<Segmenter, Alloc, Norm>::get_next_token(
+    const char *&word,
+    int64_t &word_len,
+    int64_t &char_len,
+    int64_t &word_freq)
+{
+  int ret = OBP_SUCCESS;
+  word = nullptr;
+  word_len = 0;
+  char_len = 0;
+  word_freq = 0;
+
+  if (g_emergency_shutdown) {
+    return OBP_ITER_END;
+  }
+
+  const int64_t begin_ns = thai_monotonic_ns();
+  if (!is_inited_) {
+    ret = OBP_PLUGIN_ERROR;
+    THAI_LOG_WARN("thai ft parser isn't initialized. ret=%d, is_inited=%d", ret, is_inited_);
+  } else {
+    // 与 Python 分词结果相同的单 token 上限，超长的 token 丢弃并计数
+    while (OBP_SUCCESS == (ret = next_engine_token(word, word_len, char_len, word_freq))
+           && THAI_UNLIKELY(word_len >= THAI_MAX_TOKEN_BYTES)) {
+      ObThaiStats::instance().record_truncation(OB_THAI_TRUNC_TOKEN_LENGTH);
+      THAI_PROBE2(truncate, (int)OB_THAI_TRUNC_TOKEN_LENGTH, word_len);
+    }
+  }
+
+  if (OBP_SUCCESS == ret) {
+    tokens_emitted_++;
+  }
+  if (nullptr != shadow_) {
+    if (OBP_SUCCESS == ret) {
+      shadow_->primary_.add(word, word_len);
+    } else {
+      shadow_->complete_ = OBP_ITER_END == ret;
+    }
+  }
+  const int64_t elapsed_ns = thai_monotonic_ns() - begin_ns;
+  doc_ns_ += elapsed_ns;
+  segment_ns_ += elapsed_ns;
+  ObThaiLatency::instance().record(OB_THAI_STAGE_NEXT_TOKEN, elapsed_ns);
+  return ret;
+}
+
+template <typename Segmenter, typename Alloc, typename Norm>
+inline int ObThaiFTParser<Segmenter, Alloc, Norm>::next_engine_token(
+    const char *&word,
+    int64_t &word_len,
+    int64_t &char_len,
+    int64_t &word_freq)
+{
+  int ret = OBP_SUCCESS;
+  if (!charset_fallback_ && segmenter_.next(word, word_len)) {
+    engine_tokens_ = true;
+    char_len = Norm::char_len(word, word_len);
+    word_freq = 1;
+  } else if (charset_fallback_ || (!engine_tokens_ && use_charset_fallback(segmenter_))) {
+    // 引擎没有产出任何 token 时才用原始字符扫描逻辑（fallback），一直扫到原文结束；
+    // 否则分词结果取完后会把整篇文档再切一遍，token 重复输出
+    charset_fallback_ = true;
+    ret = next_charset_token(word, word_len, char_len, word_freq);
+  } else {
+    ret = OBP_ITER_END;
+  }
+  return ret;
+}
+
+#ifndef THAI_FTPARSER_DISABLE_PYTHON
+bool ObThaiPythonSegmenter::check_python_health() {
+  // 检查 Python 解释器健康状态
+  if (!Py_IsInitialized()) {
+    THAI_LOG_WARN("Python interpreter not initialized");
+    return false;
+  }
+  
+  // Python 3.12 中 PyGILState_Check() 返回 int，不是 PyGILState_STATE
+  // 简化健康检查，避免使用已弃用的 API
+  try {
+    // 尝试获取 GIL 状态来验证 Python 环境
+    PyGILState_STATE gstate = PyGILState_Ensure();
+    PyGILState_Release(gstate);
+    return true;
+  } catch (...) {
+    THAI_LOG_WARN("Python GIL state check failed");
+    return false;
+  }
+}
+
+#endif
+
+#ifndef THAI_FTPARSER_DISABLE_PYTHON
+int ObThaiPythonSegmenter::initialize_python_safe()
 {
   // 确保互斥锁初始化
   pthread_once(&g_mutex_once, init_mutex);
   
+  ObThaiLockTimer mutex_timer(OB_THAI_LOCK_PYTHON_MUTEX);
+  mutex_timer.begin();
   if (pthread_mutex_lock(&g_python_mutex) != 0) {
-    OBP_LOG_WARN("Failed to acquire Python mutex");
+    THAI_LOG_WARN("Failed to acquire Python mutex");
     return OBP_PLUGIN_ERROR;
   }
+  mutex_timer.acquired();
   
   try {
     // 检查紧急关闭状态
@@ -215,7 +668,7 @@ int ObThaiFTParser::initialize_python_safe()
         
         Py_Initialize();
         if (!Py_IsInitialized()) {
-          OBP_LOG_WARN("Failed to initialize Python interpreter");
+          THAI_LOG_WARN("Failed to initialize Python interpreter");
           pthread_mutex_unlock(&g_python_mutex);
           return OBP_PLUGIN_ERROR;
         }
@@ -226,7 +679,10 @@ int ObThaiFTParser::initialize_python_safe()
       }
       
       // 获取 GIL 进行模块导入
+      ObThaiLockTimer import_gil_timer(OB_THAI_LOCK_GIL);
+      import_gil_timer.begin();
       PyGILState_STATE gstate = PyGILState_Ensure();
+      import_gil_timer.acquired();
       
       // 设置 Python 路径
       PyRun_SimpleString("import sys");
@@ -236,7 +692,7 @@ int ObThaiFTParser::initialize_python_safe()
       // 导入thai_tokenizer模块
       g_pModule = PyImport_ImportModule("thai_tokenizer");
       if (!g_pModule) {
-        OBP_LOG_WARN("Failed to import thai_tokenizer module");
+        THAI_LOG_WARN("Failed to import thai_tokenizer module");
         PyErr_Clear(); // 清除 Python 错误状态
         PyGILState_Release(gstate);
         pthread_mutex_unlock(&g_python_mutex);
@@ -246,7 +702,7 @@ int ObThaiFTParser::initialize_python_safe()
       // 获取Tokenizer类
       g_pTokenizerClass = PyObject_GetAttrString(g_pModule, "Tokenizer");
       if (!g_pTokenizerClass) {
-        OBP_LOG_WARN("Failed to get Tokenizer class");
+        THAI_LOG_WARN("Failed to get Tokenizer class");
         PyErr_Clear();
         Py_DECREF(g_pModule);
         g_pModule = nullptr;
@@ -260,7 +716,10 @@ int ObThaiFTParser::initialize_python_safe()
     }
     
     // 为当前实例创建Tokenizer实例
+    ObThaiLockTimer gil_timer(OB_THAI_LOCK_GIL);
+    gil_timer.begin();
     PyGILState_STATE gstate = PyGILState_Ensure();
+    gil_timer.acquired();
     
     // 检查 Python 健康状态
     if (!check_python_health()) {
@@ -271,7 +730,7 @@ int ObThaiFTParser::initialize_python_safe()
     
     pTokenizer_ = PyObject_CallObject(g_pTokenizerClass, nullptr);
     if (!pTokenizer_) {
-      OBP_LOG_WARN("Failed to create Tokenizer instance");
+      THAI_LOG_WARN("Failed to create Tokenizer instance");
       PyErr_Clear();
       PyGILState_Release(gstate);
       pthread_mutex_unlock(&g_python_mutex);
@@ -281,7 +740,7 @@ int ObThaiFTParser::initialize_python_safe()
     // 获取split方法
     pSplitFunc_ = PyObject_GetAttrString(pTokenizer_, "split");
     if (!pSplitFunc_) {
-      OBP_LOG_WARN("Failed to get split method");
+      THAI_LOG_WARN("Failed to get split method");
       PyErr_Clear();
       Py_DECREF(pTokenizer_);
       pTokenizer_ = nullptr;
@@ -293,23 +752,112 @@ int ObThaiFTParser::initialize_python_safe()
     g_ref_count++;
     instance_has_python_ = true;
     PyGILState_Release(gstate);
+    gil_timer.released();
     pthread_mutex_unlock(&g_python_mutex);
+    mutex_timer.released();
     return OBP_SUCCESS;
     
   } catch (const std::exception& e) {
-    OBP_LOG_WARN("Exception in Python initialization: %s", e.what());
+    THAI_LOG_WARN("Exception in Python initialization: %s", e.what());
     pthread_mutex_unlock(&g_python_mutex);
     return OBP_PLUGIN_ERROR;
   } catch (...) {
-    OBP_LOG_WARN("Unknown exception in Python initialization");
+    THAI_LOG_WARN("Unknown exception in Python initialization");
     pthread_mutex_unlock(&g_python_mutex);
     return OBP_PLUGIN_ERROR;
   }
 }
 
-int ObThaiFTParser::tokenize_text_safe()
+bool ObThaiPythonSegmenter::begin_document(const ObThaiSegmentParam &param)
+{
+  const int64_t ft_length = param.end_ - param.begin_;
+  THAI_LOG_TRACE("Attempting safe Python initialization");
+  if (OBP_SUCCESS != initialize_python_safe()) {
+    THAI_LOG_WARN("Safe Python initialization failed");
+    ObThaiStats::instance().record_fallback(OB_THAI_FALLBACK_PYTHON_INIT);
+    THAI_PROBE2(fallback, (int)OB_THAI_FALLBACK_PYTHON_INIT, ft_length);
+    return false;
+  }
+  THAI_LOG_TRACE("Python initialized successfully, attempting safe tokenization");
+  degrade_ = param.degrade_;
+  doc_begin_ = param.begin_;
+  // 限制交给 Python 的长度以避免内存问题
+  text_end_ = param.end_;
+  if (ft_length > MAX_TEXT_BYTES) {
+    text_end_ = param.begin_ + MAX_TEXT_BYTES;
+    THAI_LOG_WARN("Text too long, truncating to 10000 characters");
+    ObThaiStats::instance().record_truncation(OB_THAI_TRUNC_TEXT_BYTES);
+    THAI_PROBE2(truncate, (int)OB_THAI_TRUNC_TEXT_BYTES, ft_length);
+  }
+  window_begin_ = param.begin_;
+  if (OBP_SUCCESS != tokenize_next_window()) {
+    THAI_LOG_WARN("Safe tokenization failed");
+    ObThaiStats::instance().record_fallback(OB_THAI_FALLBACK_PYTHON_TOKENIZE);
+    THAI_PROBE2(fallback, (int)OB_THAI_FALLBACK_PYTHON_TOKENIZE, ft_length);
+    return false;
+  }
+  return true;
+}
+
+bool ObThaiPythonSegmenter::next(const char *&word, int64_t &word_len)
 {
-  if (!g_python_initialized || !is_inited_ || !pTokenizer_ || !pSplitFunc_) {
+  bool found = false;
+  // 分窗模式下当前窗口的结果取完后再切分下一个窗口
+  while (!found) {
+    if (current_token_index_ < tokens_.count()) {
+      word = tokens_.word(current_token_index_);
+      word_len = tokens_.length(current_token_index_);
+      current_token_index_++;
+      found = true;
+    } else if (space_window_ && space_.next(word, word_len)) {
+      found = true;
+    } else if (window_begin_ < text_end_) {
+      const char* window = window_begin_;
+      space_window_ = false;
+      if (OBP_SUCCESS != tokenize_next_window()) {
+        THAI_LOG_WARN("Window tokenization failed, falling back to space tokenization. offset=%ld",
+                      window - doc_begin_);
+        tokens_.reset();
+        ObThaiSegmentParam window_param;
+        window_param.begin_ = window;
+        window_param.end_ = window_begin_;
+        space_window_ = space_.begin_document(window_param);
+      }
+    } else {
+      break;
+    }
+  }
+  return found;
+}
+
+void ObThaiPythonSegmenter::end_document()
+{
+  cleanup_python_safe();
+  tokens_.reset();
+  current_token_index_ = 0;
+  doc_mem_bytes_ = 0;
+  doc_begin_ = nullptr;
+  window_begin_ = nullptr;
+  text_end_ = nullptr;
+  space_window_ = false;
+}
+
+int ObThaiPythonSegmenter::tokenize_next_window()
+{
+  const char* begin = window_begin_;
+  const char* end = text_end_;
+  if (OB_THAI_DEGRADE_WINDOWED == degrade_) {
+    end = find_window_end(begin, text_end_, ObThaiMemBudget::instance().window_bytes());
+  }
+  window_begin_ = end;
+  current_token_index_ = 0;
+  return tokenize_text_safe(begin, end);
+}
+
+int ObThaiPythonSegmenter::tokenize_text_safe(const char* begin, const char* end)
+{
+  // 耗时由解析器按文档计入 segment 阶段
+  if (!g_python_initialized || !pTokenizer_ || !pSplitFunc_) {
     return OBP_PLUGIN_ERROR;
   }
   
@@ -317,7 +865,10 @@ int ObThaiFTParser::tokenize_text_safe()
     return OBP_PLUGIN_ERROR;
   }
   
+  ObThaiLockTimer gil_timer(OB_THAI_LOCK_GIL);
+  gil_timer.begin();
   PyGILState_STATE gstate = PyGILState_Ensure();
+  gil_timer.acquired();
   
   try {
     // 再次检查 Python 健康状态
@@ -326,37 +877,39 @@ int ObThaiFTParser::tokenize_text_safe()
       return OBP_PLUGIN_ERROR;
     }
     
-    // 创建Python字符串 - 限制长度以避免内存问题
-    int64_t text_len = end_ - start_;
-    if (text_len > 10000) { // 限制最大长度
-      text_len = 10000;
-      OBP_LOG_WARN("Text too long, truncating to 10000 characters");
-    }
+    // 创建Python字符串，长度已在 init 中限制
+    int64_t text_len = end - begin;
     
-    PyObject* pText = PyUnicode_FromStringAndSize(start_, (Py_ssize_t)text_len);
+    // Python 对象的大小按字符宽度估算，退出作用域时扣回
+    ObThaiMemTracker py_mem(OB_THAI_MEM_PYTHON);
+    PyObject* pText = PyUnicode_FromStringAndSize(begin, (Py_ssize_t)text_len);
     if (!pText) {
-      OBP_LOG_WARN("Failed to create Python string");
+      THAI_LOG_WARN("Failed to create Python string");
       PyErr_Clear();
       PyGILState_Release(gstate);
       return OBP_PLUGIN_ERROR;
     }
+    py_mem.add(estimate_unicode_size(pText));
     
     // 调用split函数
     PyObject* pArgs = PyTuple_Pack(1, pText);
     if (!pArgs) {
-      OBP_LOG_WARN("Failed to create arguments tuple");
+      THAI_LOG_WARN("Failed to create arguments tuple");
       Py_DECREF(pText);
       PyGILState_Release(gstate);
       return OBP_PLUGIN_ERROR;
     }
     
+    THAI_PROBE1(python__enter, text_len);
+    const int64_t split_begin_ns = thai_monotonic_ns();
     PyObject* pResult = PyObject_CallObject(pSplitFunc_, pArgs);
+    THAI_PROBE3(python__exit, text_len, nullptr != pResult ? 1 : 0, thai_monotonic_ns() - split_begin_ns);
     
     Py_DECREF(pText);
     Py_DECREF(pArgs);
     
     if (!pResult) {
-      OBP_LOG_WARN("Failed to call split function");
+      THAI_LOG_WARN("Failed to call split function");
       PyErr_Clear();
       PyGILState_Release(gstate);
       return OBP_PLUGIN_ERROR;
@@ -364,7 +917,7 @@ int ObThaiFTParser::tokenize_text_safe()
     
     // 解析结果
     if (!PyList_Check(pResult)) {
-      OBP_LOG_WARN("Split result is not a list");
+      THAI_LOG_WARN("Split result is not a list");
       Py_DECREF(pResult);
       PyGILState_Release(gstate);
       return OBP_PLUGIN_ERROR;
@@ -373,15 +926,33 @@ int ObThaiFTParser::tokenize_text_safe()
     Py_ssize_t size = PyList_Size(pResult);
     if (size > 1000) { // 限制 token 数量
       size = 1000;
-      OBP_LOG_WARN("Too many tokens, limiting to 1000");
+      THAI_LOG_WARN("Too many tokens, limiting to 1000");
+      ObThaiStats::instance().record_truncation(OB_THAI_TRUNC_TOKEN_COUNT);
+      THAI_PROBE2(truncate, (int)OB_THAI_TRUNC_TOKEN_COUNT, PyList_Size(pResult));
     }
     
-    token_count_ = (int)size;
+    // 第一遍只统计有效 token 的总长度，确定 arena 大小
+    int64_t token_bytes = 0;
+    py_mem.add(estimate_list_size(pResult));
+    for (Py_ssize_t i = 0; i < size; i++) {
+      PyObject* pItem = PyList_GetItem(pResult, i);
+      if (PyUnicode_Check(pItem)) {
+        Py_ssize_t str_len;
+        const char* str = PyUnicode_AsUTF8AndSize(pItem, &str_len);
+        py_mem.add(estimate_unicode_size(pItem));
+        if (str && str_len > 0 && str_len < THAI_MAX_TOKEN_BYTES) { // 限制单个 token 长度
+          token_bytes += str_len + 1;
+        } else if (str && str_len >= THAI_MAX_TOKEN_BYTES) {
+          ObThaiStats::instance().record_truncation(OB_THAI_TRUNC_TOKEN_LENGTH);
+          THAI_PROBE2(truncate, (int)OB_THAI_TRUNC_TOKEN_LENGTH, str_len);
+        } else if (!str) {
+          PyErr_Clear();
+        }
+      }
+    }
     
-    // 分配内存
-    tokens_ = (char**)calloc(size, sizeof(char*));
-    if (!tokens_) {
-      OBP_LOG_WARN("Failed to allocate memory for tokens");
+    if (!tokens_.reserve(size, token_bytes)) {
+      THAI_LOG_WARN("Failed to allocate memory for tokens");
       Py_DECREF(pResult);
       PyGILState_Release(gstate);
       return OBP_PLUGIN_ERROR;
@@ -391,105 +962,40 @@ int ObThaiFTParser::tokenize_text_safe()
       PyObject* pItem = PyList_GetItem(pResult, i);
       if (PyUnicode_Check(pItem)) {
         Py_ssize_t str_len;
+        // 第一遍已缓存 UTF-8 表示，这里不再转换
         const char* str = PyUnicode_AsUTF8AndSize(pItem, &str_len);
-        if (str && str_len > 0 && str_len < 1000) { // 限制单个 token 长度
-          tokens_[i] = (char*)malloc(str_len + 1);
-          if (tokens_[i]) {
-            memcpy(tokens_[i], str, str_len);
-            tokens_[i][str_len] = '\0';
-          }
+        if (str && str_len > 0 && str_len < THAI_MAX_TOKEN_BYTES) {
+          tokens_.append(str, str_len);
+        } else if (!str) {
+          PyErr_Clear();
         }
       }
     }
+    doc_mem_bytes_ = tokens_.allocated() + py_mem.bytes();
     
     Py_DECREF(pResult);
+    py_mem.release();
     PyGILState_Release(gstate);
+    gil_timer.released();
+    ObThaiContention::instance().record_batch(OB_THAI_LOCK_GIL, text_len, size);
     return OBP_SUCCESS;
     
   } catch (const std::exception& e) {
-    OBP_LOG_WARN("Exception in tokenize_text_safe: %s", e.what());
+    THAI_LOG_WARN("Exception in tokenize_text_safe: %s", e.what());
     PyGILState_Release(gstate);
     return OBP_PLUGIN_ERROR;
   } catch (...) {
-    OBP_LOG_WARN("Unknown exception in tokenize_text_safe");
+    THAI_LOG_WARN("Unknown exception in tokenize_text_safe");
     PyGILState_Release(gstate);
     return OBP_PLUGIN_ERROR;
   }
 }
 
-int ObThaiFTParser::tokenize_with_spaces()
-{
-  // 简单的空格分词，作为fallback
-  tokens_ = nullptr;
-  token_count_ = 0;
-  
-  const char* current = start_;
-  const char* end = end_;
-  int count = 0;
-  
-  // 计算token数量
-  while (current < end) {
-    while (current < end && (*current == ' ' || *current == '\t' || *current == '\n')) {
-      current++;
-    }
-    
-    if (current >= end) break;
-    
-    const char* word_start = current;
-    
-    while (current < end && *current != ' ' && *current != '\t' && *current != '\n') {
-      current++;
-    }
-    
-    if (current > word_start) {
-      count++;
-    }
-  }
-  
-  if (count == 0) {
-    return OBP_SUCCESS;
-  }
-  
-  // 分配内存
-  tokens_ = (char**)calloc(count, sizeof(char*));
-  if (!tokens_) {
-    return OBP_PLUGIN_ERROR;
-  }
-  
-  // 重新扫描并存储tokens
-  current = start_;
-  int index = 0;
-  
-  while (current < end && index < count) {
-    while (current < end && (*current == ' ' || *current == '\t' || *current == '\n')) {
-      current++;
-    }
-    
-    if (current >= end) break;
-    
-    const char* word_start = current;
-    
-    while (current < end && *current != ' ' && *current != '\t' && *current != '\n') {
-      current++;
-    }
-    
-    if (current > word_start) {
-      int64_t word_len = current - word_start;
-      tokens_[index] = (char*)malloc(word_len + 1);
-      if (tokens_[index]) {
-        memcpy(tokens_[index], word_start, word_len);
-        tokens_[index][word_len] = '\0';
-        index++;
-      }
-    }
-  }
-  
-  token_count_ = index;
-  return OBP_SUCCESS;
-}
+#endif // THAI_FTPARSER_DISABLE_PYTHON
 
-int ObThaiFTParser::is_thai_text(const char* text, int64_t len)
+static int is_thai_text(const char* text, int64_t len, int32_t &thai_permille)
 {
+  thai_permille = 0;
   if (!text || len <= 0) {
     return 0;
   }
@@ -516,6 +1022,8 @@ int ObThaiFTParser::is_thai_text(const char* text, int64_t len)
     }
   }
   
+  thai_permille = total_char_count > 0 ? (int32_t)((int64_t)thai_char_count * 1000 / total_char_count) : 0;
+
   // 如果泰语字符占比超过30%，认为是泰语文本
   if (total_char_count > 0 && (thai_char_count * 100 / total_char_count) > 30) {
     return 1;
@@ -524,13 +1032,17 @@ int ObThaiFTParser::is_thai_text(const char* text, int64_t len)
   return 0;
 }
 
-void ObThaiFTParser::cleanup_python_safe()
+#ifndef THAI_FTPARSER_DISABLE_PYTHON
+void ObThaiPythonSegmenter::cleanup_python_safe()
 {
   if (!instance_has_python_) {
     return;
   }
   
+  ObThaiLockTimer gil_timer(OB_THAI_LOCK_GIL);
+  gil_timer.begin();
   PyGILState_STATE gstate = PyGILState_Ensure();
+  gil_timer.acquired();
   
   // 清理实例级别的Python对象
   if (pSplitFunc_) {
@@ -544,14 +1056,21 @@ void ObThaiFTParser::cleanup_python_safe()
   }
   
   PyGILState_Release(gstate);
+  gil_timer.released();
   
+  ObThaiLockTimer mutex_timer(OB_THAI_LOCK_PYTHON_MUTEX);
+  mutex_timer.begin();
   if (pthread_mutex_lock(&g_python_mutex) == 0) {
+    mutex_timer.acquired();
     g_ref_count--;
     instance_has_python_ = false;
     
     // 只有当没有实例在使用时才清理全局资源
     if (g_ref_count <= 0) {
+      ObThaiLockTimer gil2_timer(OB_THAI_LOCK_GIL);
+      gil2_timer.begin();
       PyGILState_STATE gstate2 = PyGILState_Ensure();
+      gil2_timer.acquired();
       
       if (g_pTokenizerClass) {
         Py_DECREF(g_pTokenizerClass);
@@ -567,116 +1086,238 @@ void ObThaiFTParser::cleanup_python_safe()
       g_ref_count = 0;
       
       PyGILState_Release(gstate2);
+      gil2_timer.released();
     }
     
     pthread_mutex_unlock(&g_python_mutex);
+    mutex_timer.released();
   }
 }
 
-int ObThaiFTParser::get_next_token(
+#endif // THAI_FTPARSER_DISABLE_PYTHON
+
+int ObIThaiFTParser::next_charset_token(
     const char *&word,
     int64_t &word_len,
     int64_t &char_len,
     int64_t &word_freq)
 {
   int ret = OBP_SUCCESS;
-  word = nullptr;
-  word_len = 0;
-  char_len = 0;
-  word_freq = 0;
-  
-  if (g_emergency_shutdown) {
-    return OBP_ITER_END;
-  }
+  const char *start = start_;
+  const char *next = next_;
+  const char *end = end_;
+  const ObPluginCharsetInfoPtr cs = cs_;
   
-  if (!is_inited_) {
-    ret = OBP_PLUGIN_ERROR;
-    OBP_LOG_WARN("thai ft parser isn't initialized. ret=%d, is_inited=%d", ret, is_inited_);
-  } else if (tokens_ && current_token_index_ < token_count_) {
-    // 使用分词结果
-    while (current_token_index_ < token_count_ && !tokens_[current_token_index_]) {
-      current_token_index_++; // 跳过nullptr的token
+  do {
+    while (next < end) {
+      int ctype;
+      int mbl = obp_charset_ctype(cs, &ctype, (unsigned char *)next, (unsigned char *)end);
+      if (ctype & (OBP_CHAR_TYPE_UPPER | OBP_CHAR_TYPE_LOWER | OBP_CHAR_TYPE_NUMBER) || *next == '_') {
+        break;
+      }
+      next += mbl > 0 ? mbl : (mbl < 0 ? -mbl : 1);
     }
-    
-    if (current_token_index_ < token_count_ && tokens_[current_token_index_]) {
-      word = tokens_[current_token_index_];
-      word_len = strlen(tokens_[current_token_index_]);
-      char_len = word_len;
-      word_freq = 1;
-      current_token_index_++;
-    } else {
+    if (next >= end) {
       ret = OBP_ITER_END;
-    }
-  } else if (next_ < end_) {
-    // 使用原始字符扫描逻辑（fallback）
-    const char *start = start_;
-    const char *next = next_;
-    const char *end = end_;
-    const ObPluginCharsetInfoPtr cs = cs_;
-    
-    do {
+    } else {
+      int64_t c_nums = 0;
+      start = next;
       while (next < end) {
         int ctype;
         int mbl = obp_charset_ctype(cs, &ctype, (unsigned char *)next, (unsigned char *)end);
-        if (ctype & (OBP_CHAR_TYPE_UPPER | OBP_CHAR_TYPE_LOWER | OBP_CHAR_TYPE_NUMBER) || *next == '_') {
+        if (!(ctype & (OBP_CHAR_TYPE_UPPER | OBP_CHAR_TYPE_LOWER | OBP_CHAR_TYPE_NUMBER) || *next == '_')) {
           break;
         }
+        ++c_nums;
         next += mbl > 0 ? mbl : (mbl < 0 ? -mbl : 1);
       }
-      if (next >= end) {
-        ret = OBP_ITER_END;
+      if (0 < c_nums) {
+        word = start;
+        word_len = next - start;
+        char_len = c_nums;
+        word_freq = 1;
+        start = next;
+        break;
       } else {
-        int64_t c_nums = 0;
         start = next;
-        while (next < end) {
-          int ctype;
-          int mbl = obp_charset_ctype(cs, &ctype, (unsigned char *)next, (unsigned char *)end);
-          if (!(ctype & (OBP_CHAR_TYPE_UPPER | OBP_CHAR_TYPE_LOWER | OBP_CHAR_TYPE_NUMBER) || *next == '_')) {
-            break;
-          }
-          ++c_nums;
-          next += mbl > 0 ? mbl : (mbl < 0 ? -mbl : 1);
-        }
-        if (0 < c_nums) {
-          word = start;
-          word_len = next - start;
-          char_len = c_nums;
-          word_freq = 1;
-          start = next;
-          break;
-        } else {
-          start = next;
-        }
       }
-    } while (ret == OBP_SUCCESS && next < end);
-    if (OBP_ITER_END == ret || OBP_SUCCESS == ret) {
-      start_ = start;
-      next_ = next;
-      end_ = end;
     }
-  } else {
-    ret = OBP_ITER_END;
+  } while (ret == OBP_SUCCESS && next < end);
+  if (OBP_ITER_END == ret || OBP_SUCCESS == ret) {
+    start_ = start;
+    next_ = next;
+    end_ = end;
   }
-  
   return ret;
 }
 
+/// 按配置和文档内容选引擎，在构造解析器之前调用，参数不合法时留给 init() 报错
+static void route_document(ObPluginFTParserParamPtr param, ObThaiEngineType engine, ObThaiDocRoute &route)
+{
+  const char *fulltext = obp_ftparser_fulltext(param);
+  int64_t ft_length = obp_ftparser_fulltext_length(param);
+  route.begin_ns_ = thai_monotonic_ns();
+  THAI_PROBE1(doc__start, ft_length);
+  if (g_emergency_shutdown || 0 == param || nullptr == fulltext || 0 >= ft_length) {
+    return;
+  }
+
+  // 检查是否为泰语文本，只有 auto 引擎需要
+  if (OB_THAI_ENGINE_AUTO == engine) {
+    ObThaiLatencyGuard detect_guard(OB_THAI_STAGE_SCRIPT_DETECT);
+    if (is_thai_text(fulltext, ft_length, route.thai_permille_)) {
+      engine = ObThaiConfig::instance().thai_engine_;
+    } else {
+      THAI_LOG_TRACE("Non-Thai text detected, using space tokenization");
+      ObThaiStats::instance().record_fallback(OB_THAI_FALLBACK_NON_THAI);
+      THAI_PROBE2(fallback, (int)OB_THAI_FALLBACK_NON_THAI, ft_length);
+      engine = OB_THAI_ENGINE_SPACE;
+    }
+  }
+  const ObThaiSegmenterRegistry &registry = ObThaiSegmenterRegistry::instance();
+  // 不带 Python 的构建没有注册 Python 桥接，交给词典分词
+  if (OB_THAI_ENGINE_PYTHON == engine && !registry.has(engine)) {
+    engine = OB_THAI_ENGINE_DICT;
+  }
+  // 按引擎自己估算的开销预留，流式引擎为 0，不占预算
+  const int64_t cost = registry.projected_bytes(engine, ft_length, false);
+  route.degrade_ = ObThaiMemBudget::instance().acquire_level(
+      cost, registry.projected_bytes(engine, ft_length, true), route.reserved_bytes_);
+  if (OB_THAI_DEGRADE_TCC_ONLY == route.degrade_ && cost > 0) {
+    // 内存预算耗尽时流式切分，不分配任何内存
+    THAI_LOG_WARN("Memory budget exhausted, using TCC tokenization. length=%ld, allocated=%ld",
+                  ft_length, ObThaiMemStat::instance().total());
+    engine = OB_THAI_ENGINE_TCC;
+  }
+  route.engine_ = engine;
+}
+
+// 原生引擎各自特化，token 循环里没有虚调用；Python 和外部进程本身开销远大于分派，走动态查表
+template <typename Norm>
+static ObIThaiFTParser *create_parser(ObThaiEngineType engine)
+{
+  typedef ObThaiThreadCacheAlloc Alloc;
+  ObIThaiFTParser *parser = nullptr;
+  switch (engine) {
+    case OB_THAI_ENGINE_SPACE:
+      parser = ObThaiFTParser<ObThaiSpaceSegmenter, Alloc, Norm>::create(engine);
+      break;
+    case OB_THAI_ENGINE_TCC:
+      parser = ObThaiFTParser<ObThaiTccSegmenter, Alloc, Norm>::create(engine);
+      break;
+    case OB_THAI_ENGINE_DICT:
+      parser = ObThaiFTParser<ObThaiDictSegmenter<OB_THAI_DICT_MAXIMAL>, Alloc, Norm>::create(engine);
+      break;
+    case OB_THAI_ENGINE_VITERBI:
+      parser = ObThaiFTParser<ObThaiDictSegmenter<OB_THAI_DICT_VITERBI>, Alloc, Norm>::create(engine);
+      break;
+    case OB_THAI_ENGINE_NGRAM:
+      parser = ObThaiFTParser<ObThaiNgramSegmenter, Alloc, Norm>::create(engine);
+      break;
+    case OB_THAI_ENGINE_ASCII:
+      parser = ObThaiFTParser<ObThaiAsciiSegmenter, Alloc, Norm>::create(engine);
+      break;
+    default:
+      parser = ObThaiFTParser<ObThaiDynamicSegmenter, ObThaiHeapAlloc, Norm>::create(engine);
+      break;
+  }
+  return parser;
+}
+
+/**
+ * @brief One parser name registered by the plugin.
+ * @details Each name has a fixed engine and its own add word flags, so a
+ * DBA picks the tokenizer per index with WITH PARSER and the plugin does
+ * not branch on it per document. The memory budget may still move a
+ * document of a dictionary engine to tcc.
+ */
+struct ObThaiParserSpec
+{
+  const char *     name_;
+  ObThaiEngineType engine_;        // OB_THAI_ENGINE_MAX 表示按 OB_THAI_FTPARSER_ENGINE
+  bool             char_count_;    // char_len 按 UTF-8 字符数，否则按字节数
+  uint64_t         add_word_flag_;
+  const char *     description_;
+};
+
+static const uint64_t THAI_AWF_WORD = OBP_FTPARSER_AWF_MIN_MAX_WORD
+                                    | OBP_FTPARSER_AWF_STOPWORD
+                                    | OBP_FTPARSER_AWF_CASEDOWN
+                                    | OBP_FTPARSER_AWF_GROUPBY_WORD;
+// 字符簇和 bigram 比最小 token 长度短，也不在停用词表里
+static const uint64_t THAI_AWF_SUBWORD = OBP_FTPARSER_AWF_CASEDOWN | OBP_FTPARSER_AWF_GROUPBY_WORD;
+
+// 第一个是缺省解析器，保持原来的名字和行为
+static const ObThaiParserSpec THAI_PARSER_SPECS[] = {
+  {"thai_ftparser", OB_THAI_ENGINE_MAX, false, THAI_AWF_WORD,
+   "Emergency fix version for Thai language ftparser."},
+  {"thai_word", OB_THAI_ENGINE_VITERBI, true, THAI_AWF_WORD,
+   "Thai words, dictionary with word frequencies (viterbi)."},
+  {"thai_word_maxmin", OB_THAI_ENGINE_DICT, true, THAI_AWF_WORD,
+   "Thai words, dictionary maximal matching with the fewest words."},
+  {"thai_ngram", OB_THAI_ENGINE_NGRAM, true, THAI_AWF_SUBWORD,
+   "Thai character cluster bigrams, no dictionary needed."},
+  {"thai_syllable", OB_THAI_ENGINE_TCC, true, THAI_AWF_SUBWORD,
+   "Thai character clusters, no dictionary needed."},
+  {"thai_query", OB_THAI_ENGINE_VITERBI, true, THAI_AWF_SUBWORD,
+   "Thai words of short text such as titles and search keys, no stopword or length filter."},
+  {"thai_ascii", OB_THAI_ENGINE_ASCII, false, THAI_AWF_WORD,
+   "ASCII letters, digits and underscore only, e.g. codes and English columns."},
+};
+static const int THAI_PARSER_SPEC_COUNT = sizeof(THAI_PARSER_SPECS) / sizeof(THAI_PARSER_SPECS[0]);
+
 } // namespace thai
 } // namespace oceanbase
 
 using namespace oceanbase::thai;
 
+// 周期性打印统计汇总，由到期后第一个结束扫描的线程负责
+static void report_stats_if_due()
+{
+  static const int64_t STATS_BUF_LEN = 16384;
+  ObThaiStats &stats = ObThaiStats::instance();
+  if (stats.report_due(ObThaiConfig::instance().stats_interval_sec_)) {
+    char *buf = (char *)malloc(STATS_BUF_LEN);
+    if (buf) {
+      ObThaiStatsSnapshot snap;
+      stats.snapshot(snap);
+      snap.to_string(buf, STATS_BUF_LEN);
+      OBP_LOG_INFO("thai ftparser stats: %s", buf);
+      ObThaiLatency::instance().report(buf, STATS_BUF_LEN);
+      OBP_LOG_INFO("thai ftparser latency(us): %s", buf);
+      ObThaiContention::instance().report(buf, STATS_BUF_LEN, 5, true);
+      OBP_LOG_INFO("thai ftparser contention: %s", buf);
+      ObThaiSlowDocSampler::instance().report(buf, STATS_BUF_LEN, true);
+      OBP_LOG_INFO("thai ftparser slow docs: %s", buf);
+      thai_ftparser_memory_snapshot(buf, STATS_BUF_LEN);
+      OBP_LOG_INFO("thai ftparser memory: %s", buf);
+      free(buf);
+    }
+    thai_log_flush_suppressed();
+  }
+}
+
+template <int SPEC>
 int ftparser_scan_begin(ObPluginFTParserParamPtr param)
 {
   int ret = OBP_SUCCESS;
-  ObThaiFTParser *parser = new (std::nothrow) ObThaiFTParser;
+  const ObThaiParserSpec &spec = THAI_PARSER_SPECS[SPEC];
+  ObThaiLatencyGuard scan_begin_guard(OB_THAI_STAGE_SCAN_BEGIN);
+  ObThaiDocRoute route;
+  route_document(param,
+                 OB_THAI_ENGINE_MAX == spec.engine_ ? ObThaiConfig::instance().engine_ : spec.engine_,
+                 route);
+  ObIThaiFTParser *parser = spec.char_count_
+      ? create_parser<ObThaiUtf8CharNorm>(route.engine_)
+      : create_parser<ObThaiByteLenNorm>(route.engine_);
   if (!parser) {
+    ObThaiMemBudget::instance().release(route.reserved_bytes_);
     return OBP_PLUGIN_ERROR;
   }
   
-  ret = parser->init(param);
+  ret = parser->init(param, route);
   if (OBP_SUCCESS != ret) {
-    delete parser;
+    parser->destroy();
     return ret;
   }
   obp_ftparser_set_user_data(param, (parser));
@@ -685,11 +1326,12 @@ int ftparser_scan_begin(ObPluginFTParserParamPtr param)
 
 int ftparser_scan_end(ObPluginFTParserParamPtr param)
 {
-  ObThaiFTParser *parser = (ObThaiFTParser *)(obp_ftparser_user_data(param));
+  ObIThaiFTParser *parser = (ObIThaiFTParser *)(obp_ftparser_user_data(param));
   if (parser) {
-    delete parser;
+    parser->destroy();
     obp_ftparser_set_user_data(param, 0);
   }
+  report_stats_if_due();
   return OBP_SUCCESS;
 }
 
@@ -703,8 +1345,9 @@ int ftparser_next_token(ObPluginFTParserParamPtr param,
   if (word == nullptr || word_len == nullptr || char_cnt == nullptr || word_freq == nullptr) {
     ret = OBP_INVALID_ARGUMENT;
   } else {
-    ObThaiFTParser *parser = (ObThaiFTParser *)(obp_ftparser_user_data(param));
+    ObIThaiFTParser *parser = (ObIThaiFTParser *)(obp_ftparser_user_data(param));
     if (parser) {
+      // 计时在解析器里，耗时同时计入文档和分词阶段
       ret = parser->get_next_token((const char *&)(*word), *word_len, *char_cnt, *word_freq);
     } else {
       ret = OBP_PLUGIN_ERROR;
@@ -713,51 +1356,97 @@ int ftparser_next_token(ObPluginFTParserParamPtr param,
   return ret;
 }
 
+template <int SPEC>
 int ftparser_get_add_word_flag(uint64_t *flag)
 {
   int ret = OBP_SUCCESS;
   if (flag == nullptr) {
     ret = OBP_INVALID_ARGUMENT;
   } else {
-    *flag = OBP_FTPARSER_AWF_MIN_MAX_WORD
-            | OBP_FTPARSER_AWF_STOPWORD
-            | OBP_FTPARSER_AWF_CASEDOWN
-            | OBP_FTPARSER_AWF_GROUPBY_WORD;
+    *flag = THAI_PARSER_SPECS[SPEC].add_word_flag_;
   }
   return ret;
 }
 
-/**
- * plugin init function
- */
-int plugin_init(ObPluginParamPtr plugin)
+/// 依次注册 THAI_PARSER_SPECS 里的每个名字，每个名字有自己的 scan_begin 和 add word 标志
+template <int SPEC>
+static int register_parsers(ObPluginParamPtr plugin)
 {
-  int ret = OBP_SUCCESS;
   /// A ftparser plugin descriptor
   ObPluginFTParser parser = {
     .init              = nullptr,
     .deinit            = nullptr,
-    .scan_begin        = ftparser_scan_begin,
+    .scan_begin        = ftparser_scan_begin<SPEC>,
     .scan_end          = ftparser_scan_end,
     .next_token        = ftparser_next_token,
-    .get_add_word_flag = ftparser_get_add_word_flag
+    .get_add_word_flag = ftparser_get_add_word_flag<SPEC>
   };
+  int ret = OBP_REGISTER_FTPARSER(plugin,
+                                  THAI_PARSER_SPECS[SPEC].name_,
+                                  parser,
+                                  THAI_PARSER_SPECS[SPEC].description_);
+  if (OBP_SUCCESS != ret) {
+    OBP_LOG_WARN("failed to register ftparser %s, ret=%d", THAI_PARSER_SPECS[SPEC].name_, ret);
+  } else {
+    ret = register_parsers<SPEC + 1>(plugin);
+  }
+  return ret;
+}
+
+template <>
+int register_parsers<THAI_PARSER_SPEC_COUNT>(ObPluginParamPtr plugin)
+{
+  return OBP_SUCCESS;
+}
+
+/**
+ * plugin init function
+ */
+int plugin_init(ObPluginParamPtr plugin)
+{
+  int ret = OBP_SUCCESS;
+
+#ifndef THAI_FTPARSER_DISABLE_PYTHON
+  // Python 桥接依赖 libpython，只在插件里注册，其余引擎由核心库内置
+  ObThaiSegmenterRegistry::instance().add<ObThaiPythonSegmenter>(OB_THAI_ENGINE_PYTHON, OB_THAI_PATH_PYTHON);
+#endif
+
+  /// register the ftparser plugins
+  ret = register_parsers<0>(plugin);
 
-  /// register the ftparser plugin
-  ret = OBP_REGISTER_FTPARSER(plugin,
-                              "thai_ftparser",
-                              parser,
-                              "Emergency fix version for Thai language ftparser.");
+  // 指标导出失败不影响分词
+  if (OBP_SUCCESS == ret) {
+    int err = ObThaiMetricsExporter::instance().start();
+    if (0 != err) {
+      OBP_LOG_WARN("failed to start thai ftparser metrics exporter, errno=%d", err);
+    }
+    // 影子模式同样不影响分词
+    err = ObThaiShadow::instance().start(get_dictionary);
+    if (0 != err) {
+      OBP_LOG_WARN("failed to start thai ftparser shadow mode, engine=%s, errno=%d",
+                   get_engine_name(ObThaiConfig::instance().shadow_engine_), err);
+    }
+  }
   return ret;
 }
 
+/**
+ * plugin deinit function
+ */
+int plugin_deinit(ObPluginParamPtr plugin)
+{
+  ObThaiShadow::instance().stop();
+  ObThaiMetricsExporter::instance().stop();
+  return OBP_SUCCESS;
+}
+
 OBP_DECLARE_PLUGIN(thai_ftparser)
 {
   OBP_AUTHOR_OCEANBASE,       
   OBP_MAKE_VERSION(1, 0, 1),  // 版本号升级
   OBP_LICENSE_MULAN_PSL_V2,   
   plugin_init,
-  nullptr,
+  plugin_deinit,
 } OBP_DECLARE_PLUGIN_END;
 
 /** @} */
\ No newline at end of file
@@ -18,6 +18,7 @@
 #include <pthread.h>
 
 #include "oceanbase/ob_plugin_ftparser.h"
+#include "thai_ftparser_log.h"
 
 /**
  * @defgroup ThaiFtParser Thai Fulltext Parser Plugin
@@ -110,13 +111,13 @@ int ObThaiFTParser::init(ObPluginFTParserParamPtr param)
 
   if (is_inited_) {
     ret = OBP_INIT_TWICE;
-    OBP_LOG_WARN("init twice. ret=%d, param=%p, this=%p", ret, param, this);
+    THAI_LOG_WARN("init twice. ret=%d, param=%p, this=%p", ret, param, this);
   } else if (0 == param
       || 0 == cs
       || nullptr == fulltext
       || 0 >= ft_length) {
     ret = OBP_INVALID_ARGUMENT;
-    OBP_LOG_WARN("invalid arguments, ret=%d, param=%p", ret, param);
+    THAI_LOG_WARN("invalid arguments, ret=%d, param=%p", ret, param);
   } else {
     cs_ = cs;
     start_ = fulltext;
@@ -127,25 +128,25 @@ int ObThaiFTParser::init(ObPluginFTParserParamPtr param)
     
     // 检查是否为泰语文本
     if (is_thai_text(fulltext, ft_length)) {
-      OBP_LOG_INFO("Detected Thai text, initializing Python tokenizer");
+      THAI_LOG_TRACE("Detected Thai text, initializing Python tokenizer");
       ret = initialize_python_global();
       if (ret == OBP_SUCCESS) {
-        OBP_LOG_INFO("Python initialized successfully, tokenizing text");
+        THAI_LOG_TRACE("Python initialized successfully, tokenizing text");
         ret = tokenize_text();
       } else {
         // Python初始化失败，使用空格分词作为回退
-        OBP_LOG_WARN("Python initialization failed, falling back to space tokenization");
+        THAI_LOG_WARN("Python initialization failed, falling back to space tokenization");
         ret = tokenize_with_spaces();
       }
     } else {
-      OBP_LOG_INFO("Non-Thai text detected, using space tokenization");
+      THAI_LOG_TRACE("Non-Thai text detected, using space tokenization");
       ret = tokenize_with_spaces();
     }
   }
   if (ret != OBP_SUCCESS && !is_inited_) {
     reset();
   }
-  OBP_LOG_INFO("thai ftparser init done. ret=%d", ret);
+  THAI_LOG_TRACE("thai ftparser init done. ret=%d", ret);
   return ret;
 }
 
@@ -159,7 +160,7 @@ int ObThaiFTParser::initialize_python_global()
       if (!Py_IsInitialized()) {
         Py_Initialize();
         if (!Py_IsInitialized()) {
-          OBP_LOG_WARN("Failed to initialize Python interpreter");
+          THAI_LOG_WARN("Failed to initialize Python interpreter");
           pthread_mutex_unlock(&g_python_mutex);
           return OBP_PLUGIN_ERROR;
         }
@@ -168,7 +169,7 @@ int ObThaiFTParser::initialize_python_global()
       // 导入thai_tokenizer模块
       g_pModule = PyImport_ImportModule("thai_tokenizer");
       if (!g_pModule) {
-        OBP_LOG_WARN("Failed to import thai_tokenizer module");
+        THAI_LOG_WARN("Failed to import thai_tokenizer module");
         PyErr_Print(); // 打印Python错误信息
         pthread_mutex_unlock(&g_python_mutex);
         return OBP_PLUGIN_ERROR;
@@ -177,7 +178,7 @@ int ObThaiFTParser::initialize_python_global()
       // 获取Tokenizer类
       g_pTokenizerClass = PyObject_GetAttrString(g_pModule, "Tokenizer");
       if (!g_pTokenizerClass) {
-        OBP_LOG_WARN("Failed to get Tokenizer class");
+        THAI_LOG_WARN("Failed to get Tokenizer class");
         PyErr_Print();
         Py_DECREF(g_pModule);
         g_pModule = nullptr;
@@ -193,7 +194,7 @@ int ObThaiFTParser::initialize_python_global()
     
     pTokenizer_ = PyObject_CallObject(g_pTokenizerClass, nullptr);
     if (!pTokenizer_) {
-      OBP_LOG_WARN("Failed to create Tokenizer instance");
+      THAI_LOG_WARN("Failed to create Tokenizer instance");
       PyErr_Print();
       PyGILState_Release(gstate);
       pthread_mutex_unlock(&g_python_mutex);
@@ -203,7 +204,7 @@ int ObThaiFTParser::initialize_python_global()
     // 获取split方法
     pSplitFunc_ = PyObject_GetAttrString(pTokenizer_, "split");
     if (!pSplitFunc_) {
-      OBP_LOG_WARN("Failed to get split method");
+      THAI_LOG_WARN("Failed to get split method");
       PyErr_Print();
       Py_DECREF(pTokenizer_);
       pTokenizer_ = nullptr;
@@ -218,11 +219,11 @@ int ObThaiFTParser::initialize_python_global()
     return OBP_SUCCESS;
     
   } catch (const std::exception& e) {
-    OBP_LOG_WARN("Python initialization failed: %s", e.what());
+    THAI_LOG_WARN("Python initialization failed: %s", e.what());
     pthread_mutex_unlock(&g_python_mutex);
     return OBP_PLUGIN_ERROR;
   } catch (...) {
-    OBP_LOG_WARN("Python initialization failed with unknown exception");
+    THAI_LOG_WARN("Python initialization failed with unknown exception");
     pthread_mutex_unlock(&g_python_mutex);
     return OBP_PLUGIN_ERROR;
   }
@@ -240,7 +241,7 @@ int ObThaiFTParser::tokenize_text()
     // 创建Python字符串
     PyObject* pText = PyUnicode_FromStringAndSize(start_, (Py_ssize_t)(end_ - start_));
     if (!pText) {
-      OBP_LOG_WARN("Failed to create Python string");
+      THAI_LOG_WARN("Failed to create Python string");
       PyErr_Print();
       PyGILState_Release(gstate);
       return OBP_PLUGIN_ERROR;
@@ -249,7 +250,7 @@ int ObThaiFTParser::tokenize_text()
     // 调用split函数
     PyObject* pArgs = PyTuple_Pack(1, pText);
     if (!pArgs) {
-      OBP_LOG_WARN("Failed to create arguments tuple");
+      THAI_LOG_WARN("Failed to create arguments tuple");
       Py_DECREF(pText);
       PyGILState_Release(gstate);
       return OBP_PLUGIN_ERROR;
@@ -261,7 +262,7 @@ int ObThaiFTParser::tokenize_text()
     Py_DECREF(pArgs);
     
     if (!pResult) {
-      OBP_LOG_WARN("Failed to call split function");
+      THAI_LOG_WARN("Failed to call split function");
       PyErr_Print();
       PyGILState_Release(gstate);
       return OBP_PLUGIN_ERROR;
@@ -269,7 +270,7 @@ int ObThaiFTParser::tokenize_text()
     
     // 解析结果
     if (!PyList_Check(pResult)) {
-      OBP_LOG_WARN("Split result is not a list");
+      THAI_LOG_WARN("Split result is not a list");
       Py_DECREF(pResult);
       PyGILState_Release(gstate);
       return OBP_PLUGIN_ERROR;
@@ -281,7 +282,7 @@ int ObThaiFTParser::tokenize_text()
     // 分配内存
     tokens_ = (char**)calloc(size, sizeof(char*)); // 使用calloc自动初始化为nullptr
     if (!tokens_) {
-      OBP_LOG_WARN("Failed to allocate memory for tokens");
+      THAI_LOG_WARN("Failed to allocate memory for tokens");
       Py_DECREF(pResult);
       PyGILState_Release(gstate);
       return OBP_PLUGIN_ERROR;
@@ -297,9 +298,9 @@ int ObThaiFTParser::tokenize_text()
           if (tokens_[i]) {
             memcpy(tokens_[i], str, str_len);
             tokens_[i][str_len] = '\0';
-            OBP_LOG_INFO("Token[%d]: '%s' (len=%d)", (int)i, tokens_[i], (int)str_len);
+            THAI_LOG_TRACE("Token[%d]: '%s' (len=%d)", (int)i, tokens_[i], (int)str_len);
           } else {
-            OBP_LOG_WARN("Failed to allocate memory for token %d", (int)i);
+            THAI_LOG_WARN("Failed to allocate memory for token %d", (int)i);
           }
         }
       }
@@ -310,11 +311,11 @@ int ObThaiFTParser::tokenize_text()
     return OBP_SUCCESS;
     
   } catch (const std::exception& e) {
-    OBP_LOG_WARN("Exception in tokenize_text: %s", e.what());
+    THAI_LOG_WARN("Exception in tokenize_text: %s", e.what());
     PyGILState_Release(gstate);
     return OBP_PLUGIN_ERROR;
   } catch (...) {
-    OBP_LOG_WARN("Unknown exception in tokenize_text");
+    THAI_LOG_WARN("Unknown exception in tokenize_text");
     PyGILState_Release(gstate);
     return OBP_PLUGIN_ERROR;
   }
@@ -484,7 +485,7 @@ int ObThaiFTParser::get_next_token(
   
   if (!is_inited_) {
     ret = OBP_PLUGIN_ERROR;
-    OBP_LOG_WARN("thai ft parser isn't initialized. ret=%d, is_inited=%d", ret, is_inited_);
+    THAI_LOG_WARN("thai ft parser isn't initialized. ret=%d, is_inited=%d", ret, is_inited_);
   } else if (tokens_ && current_token_index_ < token_count_) {
     // 使用Python分词结果
     while (current_token_index_ < token_count_ && !tokens_[current_token_index_]) {
@@ -496,7 +497,7 @@ int ObThaiFTParser::get_next_token(
       word_len = strlen(tokens_[current_token_index_]);
       char_len = word_len;
       word_freq = 1;
-      OBP_LOG_INFO("Returning token[%d]: '%s' (len=%d)", current_token_index_, word, (int)word_len);
+      THAI_LOG_TRACE("Returning token[%d]: '%s' (len=%d)", current_token_index_, word, (int)word_len);
       current_token_index_++;
     } else {
       ret = OBP_ITER_END;
@@ -552,7 +553,7 @@ int ObThaiFTParser::get_next_token(
     ret = OBP_ITER_END;
   }
   
-  OBP_LOG_TRACE("next word. start=%p, next=%p, end=%p", start_, next_, end_);
+  THAI_LOG_TRACE("next word. start=%p, next=%p, end=%p", start_, next_, end_);
   return ret;
 }
 
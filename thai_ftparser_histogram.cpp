@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "thai_ftparser_histogram.h"
+
+#include <string.h>
+
+namespace oceanbase {
+namespace thai {
+
+static const char *STAGE_NAMES[OB_THAI_STAGE_MAX] = {
+  "scan_begin",
+  "script_detect",
+  "segment",
+  "next_token",
+};
+
+const char *get_stage_name(ObThaiStage stage)
+{
+  return (stage >= 0 && stage < OB_THAI_STAGE_MAX) ? STAGE_NAMES[stage] : "unknown";
+}
+
+void ObThaiHistogram::reset()
+{
+  memset(buckets_, 0, sizeof(buckets_));
+  count_ = 0;
+  sum_ = 0;
+  max_ = 0;
+}
+
+void ObThaiHistogram::subtract(const ObThaiHistogram &other)
+{
+  // 累计值单调递增，other 总是较早的快照
+  for (int i = 0; i < ObThaiHistogramLayout::BUCKET_COUNT; i++) {
+    buckets_[i] -= other.buckets_[i];
+  }
+  count_ -= other.count_;
+  sum_ -= other.sum_;
+  // max 无法做差，取本周期非空的最高桶上界，且不超过累计最大值
+  uint64_t bound = 0;
+  for (int i = ObThaiHistogramLayout::BUCKET_COUNT - 1; i >= 0 && 0 == bound; i--) {
+    if (buckets_[i] > 0) {
+      bound = ObThaiHistogramLayout::upper_bound_of(i);
+    }
+  }
+  if (bound < max_) {
+    max_ = bound;
+  }
+}
+
+uint64_t ObThaiHistogram::value_at(double percentile) const
+{
+  uint64_t value = 0;
+  if (count_ > 0) {
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)count_ + 0.5);
+    if (rank < 1) {
+      rank = 1;
+    } else if (rank > count_) {
+      rank = count_;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < ObThaiHistogramLayout::BUCKET_COUNT; i++) {
+      seen += buckets_[i];
+      if (seen >= rank) {
+        value = ObThaiHistogramLayout::upper_bound_of(i);
+        break;
+      }
+    }
+    if (max_ > 0 && value > max_) {
+      value = max_;
+    }
+  }
+  return value;
+}
+
+ObThaiLatencySlot::ObThaiLatencySlot()
+{
+  for (int s = 0; s < OB_THAI_STAGE_MAX; s++) {
+    for (int i = 0; i < ObThaiHistogramLayout::BUCKET_COUNT; i++) {
+      stages_[s].buckets_[i].store(0, std::memory_order_relaxed);
+    }
+    stages_[s].count_.store(0, std::memory_order_relaxed);
+    stages_[s].sum_.store(0, std::memory_order_relaxed);
+    stages_[s].max_.store(0, std::memory_order_relaxed);
+  }
+}
+
+ObThaiLatency &ObThaiLatency::instance()
+{
+  static ObThaiLatency latency;
+  return latency;
+}
+
+void ObThaiLatency::merge(ObThaiStage stage, ObThaiHistogram &hist) const
+{
+  hist.reset();
+  ObThaiThreadSlots<ObThaiLatencySlot>::for_each(
+      [stage, &hist](const ObThaiLatencySlot &slot, bool) {
+        const ObThaiLatencySlot::Stage &s = slot.stages_[stage];
+        for (int i = 0; i < ObThaiHistogramLayout::BUCKET_COUNT; i++) {
+          hist.buckets_[i] += s.buckets_[i].load(std::memory_order_relaxed);
+        }
+        hist.count_ += s.count_.load(std::memory_order_relaxed);
+        hist.sum_ += s.sum_.load(std::memory_order_relaxed);
+        const uint64_t max = s.max_.load(std::memory_order_relaxed);
+        if (max > hist.max_) {
+          hist.max_ = max;
+        }
+      });
+}
+
+int64_t ObThaiLatency::report(char *buf, int64_t buf_len)
+{
+  int64_t pos = 0;
+  if (nullptr == buf || buf_len <= 0) {
+    return 0;
+  }
+  buf[0] = '\0';
+  std::lock_guard<std::mutex> guard(report_lock_);
+  for (int s = 0; s < OB_THAI_STAGE_MAX; s++) {
+    ObThaiHistogram current;
+    merge((ObThaiStage)s, current);
+    ObThaiHistogram interval = current;
+    interval.subtract(last_[s]);
+    last_[s] = current;
+    thai_databuff_printf(buf, buf_len, pos,
+                         "%s%s={cnt=%lu, avg=%.1f, p50=%.1f, p90=%.1f, p99=%.1f, p999=%.1f, max=%.1f}",
+                         s > 0 ? ", " : "", STAGE_NAMES[s], interval.count_,
+                         (double)interval.mean() / 1000.0,
+                         (double)interval.value_at(50) / 1000.0,
+                         (double)interval.value_at(90) / 1000.0,
+                         (double)interval.value_at(99) / 1000.0,
+                         (double)interval.value_at(99.9) / 1000.0,
+                         (double)interval.max_ / 1000.0);
+  }
+  return pos;
+}
+
+int64_t ObThaiLatency::dump(char *buf, int64_t buf_len) const
+{
+  int64_t pos = 0;
+  if (nullptr == buf || buf_len <= 0) {
+    return 0;
+  }
+  buf[0] = '\0';
+  for (int s = 0; s < OB_THAI_STAGE_MAX; s++) {
+    ObThaiHistogram hist;
+    merge((ObThaiStage)s, hist);
+    thai_databuff_printf(buf, buf_len, pos, "%s: count=%lu, sum_ns=%lu, max_ns=%lu, buckets={",
+                         STAGE_NAMES[s], hist.count_, hist.sum_, hist.max_);
+    bool first = true;
+    for (int i = 0; i < ObThaiHistogramLayout::BUCKET_COUNT; i++) {
+      if (hist.buckets_[i] > 0) {
+        thai_databuff_printf(buf, buf_len, pos, "%s%lu=%lu", first ? "" : ", ",
+                             ObThaiHistogramLayout::upper_bound_of(i), hist.buckets_[i]);
+        first = false;
+      }
+    }
+    thai_databuff_printf(buf, buf_len, pos, "}\n");
+  }
+  return pos;
+}
+
+} // namespace thai
+} // namespace oceanbase
+
+int64_t thai_ftparser_latency_dump(char *buf, int64_t buf_len)
+{
+  return oceanbase::thai::ObThaiLatency::instance().dump(buf, buf_len);
+}
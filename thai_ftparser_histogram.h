@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_HISTOGRAM_H_
+#define OB_THAI_FTPARSER_HISTOGRAM_H_
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+#include "thai_ftparser_common.h"
+#include "thai_ftparser_tls.h"
+
+namespace oceanbase {
+namespace thai {
+
+/**
+ * @brief HDR style log-linear bucketing of nanosecond values.
+ * @details Values below 2*SUB_COUNT get one bucket each, every following
+ * power of two is split into SUB_COUNT buckets, so the relative error of a
+ * reported percentile is at most 1/SUB_COUNT (12.5%). Values are clamped to
+ * 2^MAX_EXP ns (about 68 s).
+ */
+class ObThaiHistogramLayout final
+{
+public:
+  static const int SUB_BITS = 3;
+  static const int SUB_COUNT = 1 << SUB_BITS;
+  static const int MAX_EXP = 36;
+  static const int BUCKET_COUNT = (MAX_EXP - SUB_BITS + 1) * SUB_COUNT;
+
+  static int index_of(uint64_t value)
+  {
+    int idx = 0;
+    if (value >= (1ULL << MAX_EXP)) {
+      value = (1ULL << MAX_EXP) - 1;
+    }
+    if (value < 2 * SUB_COUNT) {
+      idx = (int)value;
+    } else {
+      const int shift = 63 - __builtin_clzll(value) - SUB_BITS;
+      idx = (shift + 1) * SUB_COUNT + (int)((value >> shift) - SUB_COUNT);
+    }
+    return idx;
+  }
+  /// 桶的上界(含)，用于报告分位数
+  static uint64_t upper_bound_of(int idx)
+  {
+    uint64_t bound = 0;
+    if (idx < 2 * SUB_COUNT) {
+      bound = (uint64_t)idx;
+    } else {
+      const int shift = idx / SUB_COUNT - 1;
+      const uint64_t mantissa = (uint64_t)(idx % SUB_COUNT + SUB_COUNT);
+      bound = ((mantissa + 1) << shift) - 1;
+    }
+    return bound;
+  }
+};
+
+/// 合并后的直方图，普通整数，只在读取侧使用
+struct ObThaiHistogram
+{
+  uint64_t buckets_[ObThaiHistogramLayout::BUCKET_COUNT];
+  uint64_t count_;
+  uint64_t sum_;
+  uint64_t max_;
+
+  ObThaiHistogram() { reset(); }
+  void reset();
+  void subtract(const ObThaiHistogram &other);
+  /// @param percentile 取值 [0, 100]
+  uint64_t value_at(double percentile) const;
+  uint64_t mean() const { return count_ > 0 ? sum_ / count_ : 0; }
+};
+
+/// 需要计时的阶段
+enum ObThaiStage
+{
+  OB_THAI_STAGE_SCAN_BEGIN = 0,   // ftparser_scan_begin 整体
+  OB_THAI_STAGE_SCRIPT_DETECT,    // is_thai_text
+  OB_THAI_STAGE_SEGMENT,          // 每篇文档启动引擎加上取 token 的分词耗时
+  OB_THAI_STAGE_NEXT_TOKEN,       // 每次 next_token
+  OB_THAI_STAGE_MAX
+};
+
+const char *get_stage_name(ObThaiStage stage);
+
+/// 单线程写入的直方图，读取侧合并
+struct ObThaiLatencySlot
+{
+  struct Stage
+  {
+    std::atomic<uint64_t> buckets_[ObThaiHistogramLayout::BUCKET_COUNT];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+  };
+  Stage stages_[OB_THAI_STAGE_MAX];
+
+  ObThaiLatencySlot();
+};
+
+/**
+ * @brief Per thread latency histograms of the tokenizer stages.
+ * @details Recording is a relaxed load+store on the thread's own slot.
+ * report() merges all slots and prints percentiles of the interval since
+ * the previous report; dump() prints the cumulative buckets.
+ */
+class ObThaiLatency final
+{
+public:
+  static ObThaiLatency &instance();
+
+  void record(ObThaiStage stage, int64_t ns)
+  {
+    ObThaiLatencySlot *slot = ObThaiThreadSlots<ObThaiLatencySlot>::local();
+    if (THAI_LIKELY(nullptr != slot && ns >= 0)) {
+      ObThaiLatencySlot::Stage &s = slot->stages_[stage];
+      const uint64_t v = (uint64_t)ns;
+      thai_counter_add(s.buckets_[ObThaiHistogramLayout::index_of(v)], 1);
+      thai_counter_add(s.count_, 1);
+      thai_counter_add(s.sum_, v);
+      if (v > s.max_.load(std::memory_order_relaxed)) {
+        s.max_.store(v, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// 合并所有线程的累计直方图
+  void merge(ObThaiStage stage, ObThaiHistogram &hist) const;
+
+  /// 本周期(自上次 report 起)各阶段的分位数，单位微秒
+  int64_t report(char *buf, int64_t buf_len);
+
+  /// 各阶段累计的非空桶，格式 stage: upper_ns=count ...
+  int64_t dump(char *buf, int64_t buf_len) const;
+
+private:
+  ObThaiLatency() = default;
+
+  std::mutex      report_lock_;
+  ObThaiHistogram last_[OB_THAI_STAGE_MAX];
+};
+
+/// RAII 计时
+class ObThaiLatencyGuard final
+{
+public:
+  explicit ObThaiLatencyGuard(ObThaiStage stage) : stage_(stage), begin_ns_(thai_monotonic_ns()) {}
+  ~ObThaiLatencyGuard() { ObThaiLatency::instance().record(stage_, thai_monotonic_ns() - begin_ns_); }
+
+private:
+  ObThaiStage stage_;
+  int64_t     begin_ns_;
+};
+
+} // namespace thai
+} // namespace oceanbase
+
+/**
+ * On-demand dump of the cumulative stage histograms.
+ * @return bytes written, excluding the trailing '\0'
+ */
+THAI_EXPORT int64_t thai_ftparser_latency_dump(char *buf, int64_t buf_len);
+
+#endif // OB_THAI_FTPARSER_HISTOGRAM_H_
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "thai_ftparser_log.h"
+
+#include "thai_ftparser_config.h"
+
+namespace oceanbase {
+namespace thai {
+
+std::atomic<ObThaiLogLimiter *> ObThaiLogLimiter::head_{nullptr};
+
+bool ObThaiLogLimiter::acquire(int64_t &suppressed)
+{
+  bool accepted = true;
+  const ObThaiConfig &config = ObThaiConfig::instance();
+  suppressed = 0;
+  if (config.log_rate_per_sec_ > 0) {
+    const int64_t interval = 1000000000LL / config.log_rate_per_sec_;
+    const int64_t tolerance = interval * (config.log_burst_ > 0 ? config.log_burst_ : 1);
+    const int64_t now = thai_monotonic_ns();
+    int64_t tat = tat_ns_.load(std::memory_order_relaxed);
+    bool done = false;
+    while (!done) {
+      const int64_t base = tat > now ? tat : now;
+      if (base + interval - now > tolerance) {
+        // 桶已空
+        accepted = false;
+        done = true;
+      } else {
+        done = tat_ns_.compare_exchange_weak(tat, base + interval, std::memory_order_relaxed);
+      }
+    }
+  }
+  if (!accepted) {
+    if (0 == suppressed_.fetch_add(1, std::memory_order_relaxed)
+        && !registered_.load(std::memory_order_relaxed)) {
+      register_self();
+    }
+  } else if (suppressed_.load(std::memory_order_relaxed) > 0) {
+    suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+  }
+  return accepted;
+}
+
+void ObThaiLogLimiter::register_self()
+{
+  bool expected = false;
+  if (registered_.compare_exchange_strong(expected, true, std::memory_order_relaxed)) {
+    ObThaiLogLimiter *head = head_.load(std::memory_order_relaxed);
+    do {
+      next_ = head;
+    } while (!head_.compare_exchange_weak(head, this, std::memory_order_release,
+                                          std::memory_order_relaxed));
+  }
+}
+
+} // namespace thai
+} // namespace oceanbase
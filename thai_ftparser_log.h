@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_LOG_H_
+#define OB_THAI_FTPARSER_LOG_H_
+
+#include <atomic>
+#include <stdint.h>
+
+#include "oceanbase/ob_plugin_ftparser.h"
+#include "thai_ftparser_common.h"
+
+/**
+ * @defgroup ThaiFtParserLog Logging of the Thai ftparser
+ * @brief Wrappers of OBP_LOG_* that keep formatting off the per row path.
+ * @details
+ *  - THAI_LOG_TRACE/THAI_LOG_DEBUG are compiled out unless the build
+ *    defines THAI_FTPARSER_ENABLE_TRACE_LOG; per token and per document
+ *    messages belong here.
+ *  - THAI_LOG_INFO/THAI_LOG_WARN/THAI_LOG_ERROR go through a token bucket
+ *    owned by the call site. A rejected message costs one clock read and
+ *    one atomic increment; its arguments are not even evaluated. The next
+ *    accepted message of the site carries the number suppressed in between,
+ *    and thai_log_flush_suppressed() reports sites that went quiet.
+ * @{
+ */
+
+namespace oceanbase {
+namespace thai {
+
+/**
+ * @brief Token bucket of one log call site (GCRA form, one atomic word).
+ * @details Constant initialized, so the function local static in the
+ * macros below needs no guard variable.
+ */
+class ObThaiLogLimiter final
+{
+public:
+  constexpr ObThaiLogLimiter(const char *file, int line)
+    : file_(file), line_(line), tat_ns_(0), suppressed_(0), registered_(false), next_(nullptr)
+  {}
+
+  /**
+   * @param [out] suppressed messages dropped since the last accepted one
+   * @return true if the message should be printed
+   */
+  bool acquire(int64_t &suppressed);
+
+  const char *file() const { return file_; }
+  int line() const { return line_; }
+
+  /// 遍历曾经丢弃过日志的调用点，fn(ObThaiLogLimiter &)
+  template <typename Fn>
+  static void for_each_suppressed(Fn fn)
+  {
+    for (ObThaiLogLimiter *l = head_.load(std::memory_order_acquire); nullptr != l; l = l->next_) {
+      fn(*l);
+    }
+  }
+  int64_t take_suppressed() { return suppressed_.exchange(0, std::memory_order_relaxed); }
+
+private:
+  void register_self();
+
+  const char *          file_;
+  int                   line_;
+  std::atomic<int64_t>  tat_ns_;       // 理论到达时间
+  std::atomic<int64_t>  suppressed_;
+  std::atomic<bool>     registered_;
+  ObThaiLogLimiter *    next_;
+
+  static std::atomic<ObThaiLogLimiter *> head_;
+};
+
+} // namespace thai
+} // namespace oceanbase
+
+#define THAI_LOG_LIMITED(LOG_MACRO, fmt, args...)                                            \
+  do {                                                                                       \
+    static ::oceanbase::thai::ObThaiLogLimiter thai_log_limiter_(__FILE__, __LINE__);        \
+    int64_t thai_log_suppressed_ = 0;                                                        \
+    if (thai_log_limiter_.acquire(thai_log_suppressed_)) {                                   \
+      if (THAI_LIKELY(0 == thai_log_suppressed_)) {                                          \
+        LOG_MACRO(fmt, ##args);                                                              \
+      } else {                                                                               \
+        LOG_MACRO(fmt " [%ld similar messages suppressed]", ##args, thai_log_suppressed_);   \
+      }                                                                                      \
+    }                                                                                        \
+  } while (0)
+
+#define THAI_LOG_INFO(fmt, args...)  THAI_LOG_LIMITED(OBP_LOG_INFO, fmt, ##args)
+#define THAI_LOG_WARN(fmt, args...)  THAI_LOG_LIMITED(OBP_LOG_WARN, fmt, ##args)
+#define THAI_LOG_ERROR(fmt, args...) THAI_LOG_LIMITED(OBP_LOG_ERROR, fmt, ##args)
+
+#ifdef THAI_FTPARSER_ENABLE_TRACE_LOG
+#define THAI_LOG_DEBUG(fmt, args...) THAI_LOG_LIMITED(OBP_LOG_DEBUG, fmt, ##args)
+#define THAI_LOG_TRACE(fmt, args...) THAI_LOG_LIMITED(OBP_LOG_TRACE, fmt, ##args)
+#else
+// 参数仍做格式检查，但不会生成任何代码
+#define THAI_LOG_DEBUG(fmt, args...) do { if (false) { OBP_LOG_DEBUG(fmt, ##args); } } while (0)
+#define THAI_LOG_TRACE(fmt, args...) do { if (false) { OBP_LOG_TRACE(fmt, ##args); } } while (0)
+#endif
+
+namespace oceanbase {
+namespace thai {
+
+/// 汇总打印静默调用点被丢弃的日志条数，随周期统计调用
+inline void thai_log_flush_suppressed()
+{
+  ObThaiLogLimiter::for_each_suppressed([](ObThaiLogLimiter &limiter) {
+    int64_t suppressed = limiter.take_suppressed();
+    if (suppressed > 0) {
+      OBP_LOG_INFO("thai ftparser log: %ld similar messages suppressed at %s:%d",
+                   suppressed, limiter.file(), limiter.line());
+    }
+  });
+}
+
+} // namespace thai
+} // namespace oceanbase
+
+/** @} */
+
+#endif // OB_THAI_FTPARSER_LOG_H_
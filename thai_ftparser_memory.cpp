@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "thai_ftparser_memory.h"
+
+#include "thai_ftparser_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace oceanbase {
+namespace thai {
+
+static const char *MEM_CATEGORY_NAMES[OB_THAI_MEM_MAX] = {
+  "token_arena",
+  "cache",
+  "dictionary",
+  "python",
+  "lattice",
+  "shadow",
+  "parser",
+  "thread_slots",
+};
+
+const char *get_mem_category_name(ObThaiMemCategory category)
+{
+  return (category >= 0 && category < OB_THAI_MEM_MAX) ? MEM_CATEGORY_NAMES[category] : "unknown";
+}
+
+static const char *DEGRADE_LEVEL_NAMES[OB_THAI_DEGRADE_MAX] = {
+  "none",
+  "no_cache",
+  "windowed",
+  "tcc_only",
+};
+
+const char *get_degrade_level_name(ObThaiDegradeLevel level)
+{
+  return (level >= 0 && level < OB_THAI_DEGRADE_MAX) ? DEGRADE_LEVEL_NAMES[level] : "unknown";
+}
+
+int64_t ObThaiMemSnapshot::to_string(char *buf, int64_t buf_len) const
+{
+  int64_t pos = 0;
+  if (nullptr == buf || buf_len <= 0) {
+    return 0;
+  }
+  buf[0] = '\0';
+  thai_databuff_printf(buf, buf_len, pos, "total={current=%ld, peak=%ld}, max_parser=%ld",
+                       total_current_, total_peak_, max_parser_bytes_);
+  for (int i = 0; i < OB_THAI_MEM_MAX; i++) {
+    thai_databuff_printf(buf, buf_len, pos, ", %s={current=%ld, peak=%ld, allocs=%ld}",
+                         MEM_CATEGORY_NAMES[i], current_[i], peak_[i], allocs_[i]);
+  }
+  thai_databuff_printf(buf, buf_len, pos, ", budget=%ld, reserved=%ld, degraded={", budget_bytes_, reserved_bytes_);
+  for (int i = OB_THAI_DEGRADE_NO_CACHE; i < OB_THAI_DEGRADE_MAX; i++) {
+    thai_databuff_printf(buf, buf_len, pos, "%s%s=%ld", i > OB_THAI_DEGRADE_NO_CACHE ? ", " : "",
+                         DEGRADE_LEVEL_NAMES[i], degraded_[i]);
+  }
+  thai_databuff_printf(buf, buf_len, pos, "}");
+  return pos;
+}
+
+ObThaiMemStat &ObThaiMemStat::instance()
+{
+  static ObThaiMemStat stat;
+  return stat;
+}
+
+void ObThaiMemStat::snapshot(ObThaiMemSnapshot &snap) const
+{
+  for (int i = 0; i < OB_THAI_MEM_MAX; i++) {
+    snap.current_[i] = counters_[i].current_.load(std::memory_order_relaxed);
+    snap.peak_[i] = counters_[i].peak_.load(std::memory_order_relaxed);
+    snap.allocs_[i] = counters_[i].allocs_.load(std::memory_order_relaxed);
+  }
+  snap.total_current_ = total_.load(std::memory_order_relaxed);
+  snap.total_peak_ = total_peak_.load(std::memory_order_relaxed);
+  snap.max_parser_bytes_ = max_parser_bytes_.load(std::memory_order_relaxed);
+  ObThaiMemBudget &budget = ObThaiMemBudget::instance();
+  snap.budget_bytes_ = budget.limit();
+  snap.reserved_bytes_ = budget.reserved();
+  for (int i = 0; i < OB_THAI_DEGRADE_MAX; i++) {
+    snap.degraded_[i] = (int64_t)budget.degraded((ObThaiDegradeLevel)i);
+  }
+}
+
+ObThaiMemBudget &ObThaiMemBudget::instance()
+{
+  static ObThaiMemBudget budget;
+  return budget;
+}
+
+ObThaiMemBudget::ObThaiMemBudget()
+  : limit_(ObThaiConfig::instance().memory_budget_mb_ * 1024 * 1024),
+    window_bytes_(ObThaiConfig::instance().window_bytes_)
+{
+  for (int i = 0; i < OB_THAI_DEGRADE_MAX; i++) {
+    degraded_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+ObThaiDegradeLevel ObThaiMemBudget::acquire_level(int64_t cost, int64_t window_cost, int64_t &reserved_bytes)
+{
+  ObThaiDegradeLevel level = OB_THAI_DEGRADE_NONE;
+  reserved_bytes = 0;
+  if (limit_ > 0) {
+    // 先按整篇预留，同时开始的扫描立刻能看到彼此，选定档位后再退回多出的部分
+    const int64_t others = reserved_.fetch_add(cost, std::memory_order_relaxed);
+    const int64_t used = ObThaiMemStat::instance().total() + others;
+    if (used + cost <= limit_ / 10 * 6) {
+      level = OB_THAI_DEGRADE_NONE;
+      reserved_bytes = cost;
+    } else if (used + cost <= limit_ / 10 * 8) {
+      level = OB_THAI_DEGRADE_NO_CACHE;
+      reserved_bytes = cost;
+    } else if (used + window_cost <= limit_) {
+      level = OB_THAI_DEGRADE_WINDOWED;
+      reserved_bytes = window_cost;
+    } else {
+      level = OB_THAI_DEGRADE_TCC_ONLY;
+    }
+    if (reserved_bytes != cost) {
+      reserved_.fetch_sub(cost - reserved_bytes, std::memory_order_relaxed);
+    }
+  }
+  degraded_[level].fetch_add(1, std::memory_order_relaxed);
+  return level;
+}
+
+namespace {
+// 16 字节头部，保持 malloc 的对齐保证
+struct MemHeader
+{
+  int64_t size_;
+  int64_t category_;
+};
+static_assert(sizeof(MemHeader) == 16, "header must keep 16 byte alignment");
+} // namespace
+
+void *thai_malloc(size_t size, ObThaiMemCategory category)
+{
+  void *ptr = nullptr;
+  MemHeader *header = (MemHeader *)malloc(sizeof(MemHeader) + size);
+  if (nullptr != header) {
+    header->size_ = (int64_t)size;
+    header->category_ = category;
+    ObThaiMemStat::instance().add(category, (int64_t)size);
+    ptr = header + 1;
+  }
+  return ptr;
+}
+
+void thai_free(void *ptr)
+{
+  if (nullptr != ptr) {
+    MemHeader *header = (MemHeader *)ptr - 1;
+    ObThaiMemStat::instance().sub((ObThaiMemCategory)header->category_, header->size_);
+    free(header);
+  }
+}
+
+bool ObThaiTokenArena::reserve(int64_t max_tokens, int64_t max_bytes)
+{
+  bool ret = true;
+  reset();
+  if (max_tokens > 0) {
+    const int64_t words_size = max_tokens * (int64_t)sizeof(const char *);
+    const int64_t lens_size = max_tokens * (int64_t)sizeof(int32_t);
+    const int64_t size = words_size + lens_size + max_bytes;
+    block_ = (char *)thai_malloc(size, OB_THAI_MEM_TOKEN_ARENA);
+    if (nullptr == block_) {
+      ret = false;
+    } else {
+      words_ = (const char **)block_;
+      lens_ = (int32_t *)(block_ + words_size);
+      data_ = block_ + words_size + lens_size;
+      cap_tokens_ = max_tokens;
+      cap_bytes_ = max_bytes;
+      allocated_ = size;
+    }
+  }
+  return ret;
+}
+
+bool ObThaiTokenArena::append(const char *word, int64_t len)
+{
+  bool ret = false;
+  if (count_ < cap_tokens_ && used_bytes_ + len + 1 <= cap_bytes_) {
+    char *dst = data_ + used_bytes_;
+    memcpy(dst, word, len);
+    dst[len] = '\0';
+    words_[count_] = dst;
+    lens_[count_] = (int32_t)len;
+    count_++;
+    used_bytes_ += len + 1;
+    ret = true;
+  }
+  return ret;
+}
+
+void ObThaiTokenArena::reset()
+{
+  if (nullptr != block_) {
+    thai_free(block_);
+  }
+  block_ = nullptr;
+  words_ = nullptr;
+  lens_ = nullptr;
+  data_ = nullptr;
+  cap_tokens_ = 0;
+  cap_bytes_ = 0;
+  count_ = 0;
+  used_bytes_ = 0;
+  allocated_ = 0;
+}
+
+} // namespace thai
+} // namespace oceanbase
+
+int64_t thai_ftparser_memory_snapshot(char *buf, int64_t buf_len)
+{
+  oceanbase::thai::ObThaiMemSnapshot snap;
+  oceanbase::thai::ObThaiMemStat::instance().snapshot(snap);
+  return snap.to_string(buf, buf_len);
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_MEMORY_H_
+#define OB_THAI_FTPARSER_MEMORY_H_
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "thai_ftparser_common.h"
+
+namespace oceanbase {
+namespace thai {
+
+/// 内存分类，插件的每一次分配都必须归入其中之一
+enum ObThaiMemCategory
+{
+  OB_THAI_MEM_TOKEN_ARENA = 0,   // 每篇文档的分词结果
+  OB_THAI_MEM_CACHE,             // 分词结果缓存
+  OB_THAI_MEM_DICTIONARY,        // 词典
+  OB_THAI_MEM_PYTHON,            // Python 桥接(对象大小为估算值)
+  OB_THAI_MEM_LATTICE,           // 分词网格
+  OB_THAI_MEM_SHADOW,            // 影子模式抽样文档的副本
+  OB_THAI_MEM_PARSER,            // 解析器对象，包括线程缓存里空闲的
+  OB_THAI_MEM_THREAD_SLOTS,      // 每线程的统计槽位，只增不减
+  OB_THAI_MEM_MAX
+};
+
+const char *get_mem_category_name(ObThaiMemCategory category);
+
+/// 超出内存预算时的降级档位，逐级加重
+enum ObThaiDegradeLevel
+{
+  OB_THAI_DEGRADE_NONE = 0,
+  OB_THAI_DEGRADE_NO_CACHE,      // 解析器对象用完直接释放，不留在线程缓存里
+  OB_THAI_DEGRADE_WINDOWED,      // 分窗分词，单个解析器只持有一个窗口的结果
+  OB_THAI_DEGRADE_TCC_ONLY,      // 只按字符簇流式切分，不分配内存
+  OB_THAI_DEGRADE_MAX
+};
+
+const char *get_degrade_level_name(ObThaiDegradeLevel level);
+
+struct ObThaiMemSnapshot
+{
+  int64_t current_[OB_THAI_MEM_MAX];
+  int64_t peak_[OB_THAI_MEM_MAX];
+  int64_t allocs_[OB_THAI_MEM_MAX];
+  int64_t total_current_;
+  int64_t total_peak_;
+  int64_t max_parser_bytes_;     // 单个解析器实例的最大占用
+  int64_t budget_bytes_;
+  int64_t reserved_bytes_;       // 进行中的扫描预留的字节数
+  int64_t degraded_[OB_THAI_DEGRADE_MAX];
+
+  int64_t to_string(char *buf, int64_t buf_len) const;
+};
+
+/**
+ * @brief Current and peak bytes per category, process wide.
+ * @details One cache line per category; updates are a fetch_add plus a
+ * rarely taken CAS for the peak.
+ */
+class ObThaiMemStat final
+{
+public:
+  static ObThaiMemStat &instance();
+
+  void add(ObThaiMemCategory category, int64_t bytes)
+  {
+    Counter &c = counters_[category];
+    const int64_t current = c.current_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (bytes > 0) {
+      c.allocs_.fetch_add(1, std::memory_order_relaxed);
+      update_max(c.peak_, current);
+      const int64_t total = total_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+      update_max(total_peak_, total);
+    } else {
+      total_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+  }
+  void sub(ObThaiMemCategory category, int64_t bytes) { add(category, -bytes); }
+  int64_t total() const { return total_.load(std::memory_order_relaxed); }
+  void record_parser_bytes(int64_t bytes) { update_max(max_parser_bytes_, bytes); }
+
+  void snapshot(ObThaiMemSnapshot &snap) const;
+
+private:
+  struct alignas(64) Counter
+  {
+    std::atomic<int64_t> current_{0};
+    std::atomic<int64_t> peak_{0};
+    std::atomic<int64_t> allocs_{0};
+  };
+
+  ObThaiMemStat() = default;
+  static void update_max(std::atomic<int64_t> &target, int64_t value)
+  {
+    int64_t old = target.load(std::memory_order_relaxed);
+    while (value > old && !target.compare_exchange_weak(old, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  Counter                          counters_[OB_THAI_MEM_MAX];
+  alignas(64) std::atomic<int64_t> total_{0};
+  std::atomic<int64_t>             total_peak_{0};
+  std::atomic<int64_t>             max_parser_bytes_{0};
+};
+
+/**
+ * @brief Plugin wide memory budget (OB_THAI_FTPARSER_MEMORY_BUDGET_MB).
+ * @details Each scan projects its cost with its engine's projected_bytes()
+ * (streaming engines 0, dict and viterbi one lattice, Python the text it is
+ * handed times DOC_COST_FACTOR) on top of what is allocated now and what
+ * the scans in flight have reserved, and
+ * picks the lightest level that still fits: above 60% of the budget parser
+ * objects are not kept in the thread caches, above 80% the text is
+ * segmented window by window, and if not even one window fits the scan
+ * streams TCC clusters without allocating. A scan is never refused.
+ *
+ * The cost of the chosen level stays reserved until the scan ends, so a
+ * burst of scans that start together sees each other before any of them
+ * has allocated. Memory a scan has already allocated is then counted twice
+ * until release(), which errs on the side of degrading early.
+ */
+class ObThaiMemBudget final
+{
+public:
+  static ObThaiMemBudget &instance();
+
+  /**
+   * 按引擎估算的内存开销选择降级档位，同时计数
+   * @param cost 整篇文档预计占用的字节数，流式引擎为 0
+   * @param window_cost 分窗切分时预计占用的字节数
+   * @param reserved_bytes 为本文档预留的字节数，扫描结束时交给 release()
+   */
+  ObThaiDegradeLevel acquire_level(int64_t cost, int64_t window_cost, int64_t &reserved_bytes);
+  void release(int64_t reserved_bytes)
+  {
+    if (reserved_bytes > 0) {
+      reserved_.fetch_sub(reserved_bytes, std::memory_order_relaxed);
+    }
+  }
+  int64_t reserved() const { return reserved_.load(std::memory_order_relaxed); }
+  int64_t limit() const { return limit_; }
+  int64_t window_bytes() const { return window_bytes_; }
+  uint64_t degraded(ObThaiDegradeLevel level) const
+  {
+    return degraded_[level].load(std::memory_order_relaxed);
+  }
+
+  /// Python 引擎的分词结果与 Python 对象合计约为交给它的原文的倍数
+  static const int64_t DOC_COST_FACTOR = 4;
+
+private:
+  ObThaiMemBudget();
+
+  int64_t               limit_;
+  int64_t               window_bytes_;
+  std::atomic<int64_t>  reserved_{0};
+  std::atomic<uint64_t> degraded_[OB_THAI_DEGRADE_MAX];
+};
+
+/// 带分类标记的 malloc/free，头部记录大小和分类
+void *thai_malloc(size_t size, ObThaiMemCategory category);
+void thai_free(void *ptr);
+
+/**
+ * @brief Accounts memory that is not allocated by thai_malloc, e.g.
+ * estimated sizes of Python objects, and releases it on scope exit.
+ */
+class ObThaiMemTracker final
+{
+public:
+  explicit ObThaiMemTracker(ObThaiMemCategory category) : category_(category) {}
+  ~ObThaiMemTracker() { release(); }
+  void add(int64_t bytes)
+  {
+    bytes_ += bytes;
+    ObThaiMemStat::instance().add(category_, bytes);
+  }
+  int64_t bytes() const { return bytes_; }
+  void release()
+  {
+    if (0 != bytes_) {
+      ObThaiMemStat::instance().sub(category_, bytes_);
+      bytes_ = 0;
+    }
+  }
+
+private:
+  ObThaiMemCategory category_;
+  int64_t           bytes_ = 0;
+};
+
+/**
+ * @brief Token storage of one document in a single allocation.
+ * @details Layout: word pointers, word lengths, then the NUL terminated
+ * words. reserve() sizes the block once from an upper bound, append()
+ * never allocates.
+ */
+class ObThaiTokenArena final
+{
+public:
+  ObThaiTokenArena() = default;
+  ~ObThaiTokenArena() { reset(); }
+
+  /// @return false if the block could not be allocated
+  bool reserve(int64_t max_tokens, int64_t max_bytes);
+  /// @return false if the reserved capacity is exhausted
+  bool append(const char *word, int64_t len);
+  void reset();
+
+  int64_t count() const { return count_; }
+  const char *word(int64_t idx) const { return words_[idx]; }
+  int64_t length(int64_t idx) const { return lens_[idx]; }
+  int64_t allocated() const { return allocated_; }
+
+private:
+  char *        block_ = nullptr;
+  const char ** words_ = nullptr;
+  int32_t *     lens_ = nullptr;
+  char *        data_ = nullptr;
+  int64_t       cap_tokens_ = 0;
+  int64_t       cap_bytes_ = 0;
+  int64_t       count_ = 0;
+  int64_t       used_bytes_ = 0;
+  int64_t       allocated_ = 0;
+};
+
+} // namespace thai
+} // namespace oceanbase
+
+/**
+ * Current and peak bytes per memory category.
+ * @return bytes written, excluding the trailing '\0'
+ */
+THAI_EXPORT int64_t thai_ftparser_memory_snapshot(char *buf, int64_t buf_len);
+
+#endif // OB_THAI_FTPARSER_MEMORY_H_
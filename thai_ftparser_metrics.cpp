@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "thai_ftparser_metrics.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "thai_ftparser_config.h"
+#include "thai_ftparser_contention.h"
+#include "thai_ftparser_histogram.h"
+#include "thai_ftparser_memory.h"
+#include "thai_ftparser_stats.h"
+
+namespace oceanbase {
+namespace thai {
+
+// 直方图导出时的 le 边界(秒)，内部桶按上界归入不小于它的第一个边界
+static const double HISTOGRAM_BOUNDS[] = {
+  1e-6, 5e-6, 1e-5, 5e-5, 1e-4, 5e-4, 1e-3, 5e-3, 1e-2, 5e-2, 1e-1, 5e-1, 1.0, 5.0,
+};
+static const int HISTOGRAM_BOUND_COUNT = sizeof(HISTOGRAM_BOUNDS) / sizeof(HISTOGRAM_BOUNDS[0]);
+// 一次应答的发送上限，客户端不读时放弃
+static const int64_t METRICS_SEND_TIMEOUT_MS = 1000;
+
+static void append(std::string &out, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static void append(std::string &out, const char *fmt, ...)
+{
+  char line[512];
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(line, sizeof(line), fmt, args);
+  va_end(args);
+  if (n > 0) {
+    out.append(line, n < (int)sizeof(line) ? n : (int)sizeof(line) - 1);
+  }
+}
+
+static void header(std::string &out, const char *name, const char *type, const char *help)
+{
+  append(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+ObThaiMetricsExporter &ObThaiMetricsExporter::instance()
+{
+  static ObThaiMetricsExporter exporter;
+  return exporter;
+}
+
+void ObThaiMetricsExporter::render(std::string &out)
+{
+  ObThaiStatsSnapshot snap;
+  ObThaiStats::instance().snapshot(snap);
+  out.reserve(out.size() + 8192);
+
+  header(out, "thai_ftparser_documents_total", "counter", "Documents tokenized, by path.");
+  for (int i = 0; i < OB_THAI_PATH_MAX; i++) {
+    append(out, "thai_ftparser_documents_total{path=\"%s\"} %lu\n", get_path_name((ObThaiPath)i), snap.docs_[i]);
+  }
+  header(out, "thai_ftparser_bytes_total", "counter", "Input bytes tokenized, by path.");
+  for (int i = 0; i < OB_THAI_PATH_MAX; i++) {
+    append(out, "thai_ftparser_bytes_total{path=\"%s\"} %lu\n", get_path_name((ObThaiPath)i), snap.bytes_[i]);
+  }
+  header(out, "thai_ftparser_tokens_total", "counter", "Tokens emitted, by path.");
+  for (int i = 0; i < OB_THAI_PATH_MAX; i++) {
+    append(out, "thai_ftparser_tokens_total{path=\"%s\"} %lu\n", get_path_name((ObThaiPath)i), snap.tokens_[i]);
+  }
+  header(out, "thai_ftparser_doc_seconds_total", "counter", "Time spent in scan_begin and next_token, by path.");
+  for (int i = 0; i < OB_THAI_PATH_MAX; i++) {
+    append(out, "thai_ftparser_doc_seconds_total{path=\"%s\"} %.9f\n", get_path_name((ObThaiPath)i),
+           (double)snap.ns_[i] / 1e9);
+  }
+  header(out, "thai_ftparser_fallbacks_total", "counter", "Documents that used the space tokenizer, by reason.");
+  for (int i = 0; i < OB_THAI_FALLBACK_MAX; i++) {
+    append(out, "thai_ftparser_fallbacks_total{reason=\"%s\"} %lu\n",
+           get_fallback_name((ObThaiFallbackReason)i), snap.fallbacks_[i]);
+  }
+  header(out, "thai_ftparser_truncations_total", "counter", "Hits of the size caps, by cap.");
+  for (int i = 0; i < OB_THAI_TRUNC_MAX; i++) {
+    append(out, "thai_ftparser_truncations_total{cap=\"%s\"} %lu\n",
+           get_truncation_name((ObThaiTruncation)i), snap.truncations_[i]);
+  }
+
+  header(out, "thai_ftparser_shadow_documents_total", "counter", "Documents sampled for the shadow engine, by result.");
+  append(out, "thai_ftparser_shadow_documents_total{result=\"compared\"} %lu\n", snap.shadow_[OB_THAI_SHADOW_DOCS]);
+  append(out, "thai_ftparser_shadow_documents_total{result=\"disagree\"} %lu\n", snap.shadow_[OB_THAI_SHADOW_DISAGREE]);
+  append(out, "thai_ftparser_shadow_documents_total{result=\"dropped\"} %lu\n", snap.shadow_[OB_THAI_SHADOW_DROPPED]);
+  append(out, "thai_ftparser_shadow_documents_total{result=\"failed\"} %lu\n", snap.shadow_[OB_THAI_SHADOW_FAILED]);
+  header(out, "thai_ftparser_shadow_tokens_total", "counter", "Distinct tokens of compared documents, by engine.");
+  append(out, "thai_ftparser_shadow_tokens_total{side=\"primary\"} %lu\n", snap.shadow_[OB_THAI_SHADOW_PRIMARY_TOKENS]);
+  append(out, "thai_ftparser_shadow_tokens_total{side=\"shadow\"} %lu\n", snap.shadow_[OB_THAI_SHADOW_SHADOW_TOKENS]);
+  append(out, "thai_ftparser_shadow_tokens_total{side=\"common\"} %lu\n", snap.shadow_[OB_THAI_SHADOW_COMMON_TOKENS]);
+  header(out, "thai_ftparser_shadow_seconds_total", "counter", "Segmentation time of compared documents, by engine.");
+  append(out, "thai_ftparser_shadow_seconds_total{side=\"primary\"} %.9f\n",
+         (double)snap.shadow_[OB_THAI_SHADOW_PRIMARY_NS] / 1e9);
+  append(out, "thai_ftparser_shadow_seconds_total{side=\"shadow\"} %.9f\n",
+         (double)snap.shadow_[OB_THAI_SHADOW_SHADOW_NS] / 1e9);
+
+  header(out, "thai_ftparser_stage_duration_seconds", "histogram", "Latency of the tokenizer stages.");
+  for (int s = 0; s < OB_THAI_STAGE_MAX; s++) {
+    ObThaiHistogram hist;
+    ObThaiLatency::instance().merge((ObThaiStage)s, hist);
+    const char *stage = get_stage_name((ObThaiStage)s);
+    uint64_t cumulative = 0;
+    int idx = 0;
+    for (int b = 0; b < HISTOGRAM_BOUND_COUNT; b++) {
+      const uint64_t bound_ns = (uint64_t)(HISTOGRAM_BOUNDS[b] * 1e9);
+      for (; idx < ObThaiHistogramLayout::BUCKET_COUNT
+             && ObThaiHistogramLayout::upper_bound_of(idx) <= bound_ns; idx++) {
+        cumulative += hist.buckets_[idx];
+      }
+      append(out, "thai_ftparser_stage_duration_seconds_bucket{stage=\"%s\",le=\"%g\"} %lu\n",
+             stage, HISTOGRAM_BOUNDS[b], cumulative);
+    }
+    append(out, "thai_ftparser_stage_duration_seconds_bucket{stage=\"%s\",le=\"+Inf\"} %lu\n", stage, hist.count_);
+    append(out, "thai_ftparser_stage_duration_seconds_sum{stage=\"%s\"} %.9f\n", stage, (double)hist.sum_ / 1e9);
+    append(out, "thai_ftparser_stage_duration_seconds_count{stage=\"%s\"} %lu\n", stage, hist.count_);
+  }
+
+  uint64_t acquisitions[OB_THAI_LOCK_MAX] = {};
+  uint64_t wait_ns[OB_THAI_LOCK_MAX] = {};
+  uint64_t hold_ns[OB_THAI_LOCK_MAX] = {};
+  ObThaiThreadSlots<ObThaiContentionSlot>::for_each([&](const ObThaiContentionSlot &slot, bool) {
+    for (int i = 0; i < OB_THAI_LOCK_MAX; i++) {
+      acquisitions[i] += slot.locks_[i].acquisitions_.load(std::memory_order_relaxed);
+      wait_ns[i] += slot.locks_[i].wait_ns_.load(std::memory_order_relaxed);
+      hold_ns[i] += slot.locks_[i].hold_ns_.load(std::memory_order_relaxed);
+    }
+  });
+  header(out, "thai_ftparser_lock_acquisitions_total", "counter", "Acquisitions of the Python locks.");
+  for (int i = 0; i < OB_THAI_LOCK_MAX; i++) {
+    append(out, "thai_ftparser_lock_acquisitions_total{lock=\"%s\"} %lu\n", get_lock_name((ObThaiLockId)i), acquisitions[i]);
+  }
+  header(out, "thai_ftparser_lock_wait_seconds_total", "counter", "Time spent waiting for the Python locks.");
+  for (int i = 0; i < OB_THAI_LOCK_MAX; i++) {
+    append(out, "thai_ftparser_lock_wait_seconds_total{lock=\"%s\"} %.9f\n", get_lock_name((ObThaiLockId)i),
+           (double)wait_ns[i] / 1e9);
+  }
+  header(out, "thai_ftparser_lock_hold_seconds_total", "counter", "Time the Python locks were held.");
+  for (int i = 0; i < OB_THAI_LOCK_MAX; i++) {
+    append(out, "thai_ftparser_lock_hold_seconds_total{lock=\"%s\"} %.9f\n", get_lock_name((ObThaiLockId)i),
+           (double)hold_ns[i] / 1e9);
+  }
+  header(out, "thai_ftparser_threads", "gauge", "Threads that currently own a statistics slot.");
+  append(out, "thai_ftparser_threads %ld\n", snap.threads_);
+
+  ObThaiMemSnapshot mem;
+  ObThaiMemStat::instance().snapshot(mem);
+  header(out, "thai_ftparser_memory_bytes", "gauge", "Bytes currently allocated, by category.");
+  for (int i = 0; i < OB_THAI_MEM_MAX; i++) {
+    append(out, "thai_ftparser_memory_bytes{category=\"%s\"} %ld\n",
+           get_mem_category_name((ObThaiMemCategory)i), mem.current_[i]);
+  }
+  header(out, "thai_ftparser_memory_peak_bytes", "gauge", "Highest bytes allocated since start, by category.");
+  for (int i = 0; i < OB_THAI_MEM_MAX; i++) {
+    append(out, "thai_ftparser_memory_peak_bytes{category=\"%s\"} %ld\n",
+           get_mem_category_name((ObThaiMemCategory)i), mem.peak_[i]);
+  }
+  header(out, "thai_ftparser_parser_memory_peak_bytes", "gauge", "Largest footprint of a single parser instance.");
+  append(out, "thai_ftparser_parser_memory_peak_bytes %ld\n", mem.max_parser_bytes_);
+  header(out, "thai_ftparser_memory_budget_bytes", "gauge", "Configured memory budget, 0 if unlimited.");
+  append(out, "thai_ftparser_memory_budget_bytes %ld\n", mem.budget_bytes_);
+  header(out, "thai_ftparser_memory_reserved_bytes", "gauge", "Bytes reserved by scans in flight against the budget.");
+  append(out, "thai_ftparser_memory_reserved_bytes %ld\n", mem.reserved_bytes_);
+  header(out, "thai_ftparser_degraded_documents_total", "counter", "Documents scanned at each degradation level.");
+  for (int i = 0; i < OB_THAI_DEGRADE_MAX; i++) {
+    append(out, "thai_ftparser_degraded_documents_total{level=\"%s\"} %ld\n",
+           get_degrade_level_name((ObThaiDegradeLevel)i), mem.degraded_[i]);
+  }
+}
+
+int ObThaiMetricsExporter::start()
+{
+  int ret = 0;
+  const ObThaiConfig &config = ObThaiConfig::instance();
+  if (started_) {
+    // 多个解析器共享同一个导出线程
+  } else if (config.metrics_socket_path_.empty() && config.metrics_file_path_.empty()) {
+    // 未配置
+  } else {
+    socket_path_ = config.metrics_socket_path_;
+    file_path_ = config.metrics_file_path_;
+    interval_sec_ = config.metrics_interval_sec_;
+    if (!socket_path_.empty()) {
+      ret = open_socket(socket_path_.c_str());
+    }
+    if (0 == ret) {
+      stop_.store(false);
+      try {
+        thread_ = std::thread(&ObThaiMetricsExporter::run, this);
+        started_ = true;
+      } catch (...) {
+        ret = EAGAIN;
+      }
+    }
+    if (0 != ret && listen_fd_ >= 0) {
+      close(listen_fd_);
+      listen_fd_ = -1;
+      unlink(socket_path_.c_str());
+    }
+  }
+  return ret;
+}
+
+void ObThaiMetricsExporter::stop()
+{
+  if (started_) {
+    stop_.store(true);
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    if (listen_fd_ >= 0) {
+      close(listen_fd_);
+      listen_fd_ = -1;
+      unlink(socket_path_.c_str());
+    }
+    started_ = false;
+  }
+}
+
+int ObThaiMetricsExporter::open_socket(const char *path)
+{
+  int ret = 0;
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    ret = ENAMETOOLONG;
+  } else if ((listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0) {
+    ret = errno;
+  } else {
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    // 清理上次进程遗留的 socket 文件
+    unlink(path);
+    if (bind(listen_fd_, (struct sockaddr *)&addr, sizeof(addr)) < 0
+        || listen(listen_fd_, 16) < 0) {
+      ret = errno;
+      close(listen_fd_);
+      listen_fd_ = -1;
+    }
+  }
+  return ret;
+}
+
+void ObThaiMetricsExporter::run()
+{
+  pthread_setname_np(pthread_self(), "ThaiMetrics");
+  int64_t next_write_ns = 0;
+  while (!stop_.load()) {
+    if (!file_path_.empty() && thai_monotonic_ns() >= next_write_ns) {
+      write_file();
+      next_write_ns = thai_monotonic_ns() + interval_sec_ * 1000000000LL;
+    }
+    if (listen_fd_ >= 0) {
+      serve_once();
+    } else {
+      usleep(200 * 1000);
+    }
+  }
+}
+
+void ObThaiMetricsExporter::serve_once()
+{
+  // 短超时轮询，保证 stop() 能及时返回
+  struct pollfd pfd;
+  pfd.fd = listen_fd_;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  if (poll(&pfd, 1, 200) > 0 && (pfd.revents & POLLIN)) {
+    // 非阻塞连接，不读数据的客户端最多占住导出线程一个发送超时
+    int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+    if (fd >= 0) {
+      // 请求内容无关紧要，读掉已到达的部分即可
+      char request[1024];
+      struct pollfd rfd;
+      rfd.fd = fd;
+      rfd.events = POLLIN;
+      rfd.revents = 0;
+      if (poll(&rfd, 1, 100) > 0) {
+        ssize_t n = recv(fd, request, sizeof(request), MSG_DONTWAIT);
+        (void)n;
+      }
+      std::string body;
+      render(body);
+      std::string response;
+      append(response, "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                       "Content-Length: %zu\r\nConnection: close\r\n\r\n", body.size());
+      response += body;
+      const char *p = response.data();
+      size_t left = response.size();
+      const int64_t deadline_ns = thai_monotonic_ns() + METRICS_SEND_TIMEOUT_MS * 1000000LL;
+      while (left > 0 && !stop_.load()) {
+        ssize_t n = send(fd, p, left, MSG_NOSIGNAL);
+        if (n > 0) {
+          p += n;
+          left -= (size_t)n;
+        } else if (n < 0 && (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno)) {
+          const int64_t left_ns = deadline_ns - thai_monotonic_ns();
+          struct pollfd wfd;
+          wfd.fd = fd;
+          wfd.events = POLLOUT;
+          wfd.revents = 0;
+          // 分段等待，stop() 不用等满整个超时
+          if (left_ns <= 0
+              || (poll(&wfd, 1, (int)std::min<int64_t>(200, (left_ns + 999999) / 1000000)) < 0 && EINTR != errno)) {
+            break;
+          }
+        } else {
+          break;
+        }
+      }
+      close(fd);
+    }
+  }
+}
+
+int ObThaiMetricsExporter::write_file()
+{
+  int ret = 0;
+  std::string body;
+  render(body);
+  std::string tmp_path = file_path_ + ".tmp";
+  FILE *fp = fopen(tmp_path.c_str(), "w");
+  if (nullptr == fp) {
+    ret = errno;
+  } else {
+    if (fwrite(body.data(), 1, body.size(), fp) != body.size()) {
+      ret = EIO;
+    }
+    if (0 != fclose(fp) && 0 == ret) {
+      ret = errno;
+    }
+    // rename 保证读者看到的总是完整文件
+    if (0 == ret && 0 != rename(tmp_path.c_str(), file_path_.c_str())) {
+      ret = errno;
+    }
+    if (0 != ret) {
+      unlink(tmp_path.c_str());
+    }
+  }
+  return ret;
+}
+
+} // namespace thai
+} // namespace oceanbase
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_METRICS_H_
+#define OB_THAI_FTPARSER_METRICS_H_
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <thread>
+
+namespace oceanbase {
+namespace thai {
+
+/**
+ * @brief Prometheus text format export of the tokenizer statistics.
+ * @details An optional background thread either answers every connection
+ * on a Unix domain socket with a minimal HTTP response, e.g.
+ * `curl --unix-socket /path/sock http://localhost/metrics`, or rewrites a
+ * file (write to .tmp, then rename) every interval for the node_exporter
+ * textfile collector. Nothing runs unless one of the paths is configured.
+ */
+class ObThaiMetricsExporter final
+{
+public:
+  static ObThaiMetricsExporter &instance();
+
+  /**
+   * 按配置启动后台线程，未配置时什么也不做
+   * @return 0 on success, otherwise an errno value
+   */
+  int start();
+  void stop();
+
+  /// 生成完整的 Prometheus 文本
+  static void render(std::string &out);
+
+private:
+  ObThaiMetricsExporter() = default;
+  ~ObThaiMetricsExporter() { stop(); }
+
+  int open_socket(const char *path);
+  void run();
+  void serve_once();
+  int write_file();
+
+  std::thread       thread_;
+  std::atomic<bool> stop_{false};
+  bool              started_ = false;
+  int               listen_fd_ = -1;
+  std::string       socket_path_;
+  std::string       file_path_;
+  int64_t           interval_sec_ = 0;
+};
+
+} // namespace thai
+} // namespace oceanbase
+
+#endif // OB_THAI_FTPARSER_METRICS_H_
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_PROBES_H_
+#define OB_THAI_FTPARSER_PROBES_H_
+
+/**
+ * @defgroup ThaiFtParserProbes USDT probes of the Thai ftparser
+ * @brief Static tracepoints under provider `thai_ftparser`.
+ * @details With <sys/sdt.h> available each probe is a single NOP plus an
+ * ELF note, so it costs nothing until a tracer attaches, e.g.
+ *
+ *     bpftrace -e 'usdt:/path/libthai_ftparser.so:thai_ftparser:doc__end
+ *                  { @us[arg3] = hist(arg2 / 1000); }'
+ *     bpftrace -e 'usdt:/path/libthai_ftparser.so:thai_ftparser:python__exit
+ *                  { @split_us = hist(arg2 / 1000); }'
+ *
+ * Build without <sys/sdt.h>, or with THAI_FTPARSER_DISABLE_USDT, and the
+ * macros expand to nothing.
+ *
+ * | probe          | arguments                                       |
+ * |----------------|-------------------------------------------------|
+ * | doc__start     | bytes                                           |
+ * | doc__end       | bytes, tokens, elapsed_ns, path (ObThaiPath)    |
+ * | engine         | path (ObThaiPath), thai_permille                |
+ * | python__enter  | bytes                                           |
+ * | python__exit   | bytes, ok (1 if split() returned), elapsed_ns   |
+ * | fallback       | reason (ObThaiFallbackReason), bytes            |
+ * | truncate       | cap (ObThaiTruncation), value                   |
+ * @{
+ */
+
+#if !defined(THAI_FTPARSER_DISABLE_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define THAI_FTPARSER_HAS_USDT 1
+#endif
+#endif
+
+#ifdef THAI_FTPARSER_HAS_USDT
+#include <sys/sdt.h>
+#define THAI_PROBE1(name, a1)                     DTRACE_PROBE1(thai_ftparser, name, a1)
+#define THAI_PROBE2(name, a1, a2)                 DTRACE_PROBE2(thai_ftparser, name, a1, a2)
+#define THAI_PROBE3(name, a1, a2, a3)             DTRACE_PROBE3(thai_ftparser, name, a1, a2, a3)
+#define THAI_PROBE4(name, a1, a2, a3, a4)         DTRACE_PROBE4(thai_ftparser, name, a1, a2, a3, a4)
+#else
+// sizeof 不对参数求值，只是让只给探针用的变量不报未使用
+#define THAI_PROBE1(name, a1)                     do { (void)sizeof(a1); } while (0)
+#define THAI_PROBE2(name, a1, a2)                 do { (void)sizeof(a1); (void)sizeof(a2); } while (0)
+#define THAI_PROBE3(name, a1, a2, a3)             do { (void)sizeof(a1); (void)sizeof(a2); (void)sizeof(a3); } while (0)
+#define THAI_PROBE4(name, a1, a2, a3, a4)         \
+  do { (void)sizeof(a1); (void)sizeof(a2); (void)sizeof(a3); (void)sizeof(a4); } while (0)
+#endif
+
+/** @} */
+
+#endif // OB_THAI_FTPARSER_PROBES_H_
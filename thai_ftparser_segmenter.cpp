@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "thai_ftparser_segmenter.h"
+
+#include "thai_ftparser_worker.h"
+
+namespace oceanbase {
+namespace thai {
+
+bool ObThaiNgramSegmenter::next(const char *&word, int64_t &word_len)
+{
+  const char *token = nullptr;
+  int64_t token_len = 0;
+  while (true) {
+    if (nullptr != held_) {
+      token = held_;
+      token_len = held_len_;
+      held_ = nullptr;
+    } else if (!tcc_.next(token, token_len)) {
+      token = nullptr;
+    }
+    if (nullptr == token) {
+      // 文档结束，输出最后一个单独的字符簇
+      const bool found = nullptr != prev_ && !prev_emitted_;
+      if (found) {
+        word = prev_;
+        word_len = prev_len_;
+      }
+      prev_ = nullptr;
+      return found;
+    }
+    const bool thai = thai_is_thai_char(token, token + token_len);
+    if (thai && nullptr != prev_ && prev_ + prev_len_ == token) {
+      word = prev_;
+      word_len = token + token_len - prev_;
+      prev_ = token;
+      prev_len_ = token_len;
+      prev_emitted_ = true;
+      return true;
+    }
+    if (nullptr != prev_ && !prev_emitted_) {
+      // 只有一个簇的泰文串单独输出，当前 token 留到下次
+      held_ = token;
+      held_len_ = token_len;
+      word = prev_;
+      word_len = prev_len_;
+      prev_ = nullptr;
+      return true;
+    }
+    prev_ = nullptr;
+    if (thai) {
+      prev_ = token;
+      prev_len_ = token_len;
+      prev_emitted_ = false;
+    } else {
+      word = token;
+      word_len = token_len;
+      return true;
+    }
+  }
+}
+
+ObThaiSegmenterRegistry &ObThaiSegmenterRegistry::instance()
+{
+  static ObThaiSegmenterRegistry registry;
+  return registry;
+}
+
+ObThaiSegmenterRegistry::ObThaiSegmenterRegistry()
+{
+  for (int i = 0; i < OB_THAI_ENGINE_MAX; i++) {
+    creators_[i] = nullptr;
+    paths_[i] = OB_THAI_PATH_SPACE;
+    projectors_[i] = nullptr;
+  }
+  add<ObThaiSpaceSegmenter>(OB_THAI_ENGINE_SPACE, OB_THAI_PATH_SPACE);
+  add<ObThaiTccSegmenter>(OB_THAI_ENGINE_TCC, OB_THAI_PATH_TCC);
+  add<ObThaiDictSegmenter<OB_THAI_DICT_MAXIMAL>>(OB_THAI_ENGINE_DICT, OB_THAI_PATH_DICT);
+  add<ObThaiDictSegmenter<OB_THAI_DICT_VITERBI>>(OB_THAI_ENGINE_VITERBI, OB_THAI_PATH_VITERBI);
+  add<ObThaiWorkerSegmenter>(OB_THAI_ENGINE_WORKER, OB_THAI_PATH_WORKER);
+  add<ObThaiNgramSegmenter>(OB_THAI_ENGINE_NGRAM, OB_THAI_PATH_NGRAM);
+  add<ObThaiAsciiSegmenter>(OB_THAI_ENGINE_ASCII, OB_THAI_PATH_ASCII);
+}
+
+void ObThaiSegmenterRegistry::add(ObThaiEngineType engine, ObThaiPath path, Creator create, Projector project)
+{
+  // auto 不是引擎，由解析器按文档内容换成具体引擎
+  if (engine > OB_THAI_ENGINE_AUTO && engine < OB_THAI_ENGINE_MAX) {
+    creators_[engine] = create;
+    paths_[engine] = path;
+    projectors_[engine] = project;
+  }
+}
+
+bool ObThaiDynamicSegmenter::begin_document(const ObThaiSegmentParam &param)
+{
+  end_document();
+  const ObThaiSegmenterRegistry &registry = ObThaiSegmenterRegistry::instance();
+  bool ret = true;
+  segmenter_ = registry.create(engine_, buf_);
+  path_ = registry.path(engine_);
+  if (nullptr != segmenter_ && !segmenter_->begin_document(param)) {
+    end_document();
+    ret = false;
+  }
+  if (nullptr == segmenter_) {
+    // 空格分词总是成功
+    segmenter_ = registry.create(OB_THAI_ENGINE_SPACE, buf_);
+    segmenter_->begin_document(param);
+    path_ = OB_THAI_PATH_SPACE;
+  }
+  return ret;
+}
+
+void ObThaiDynamicSegmenter::end_document()
+{
+  if (nullptr != segmenter_) {
+    segmenter_->end_document();
+    segmenter_->~ObThaiSegmenter();
+    segmenter_ = nullptr;
+  }
+}
+
+} // namespace thai
+} // namespace oceanbase
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_SEGMENTER_H_
+#define OB_THAI_FTPARSER_SEGMENTER_H_
+
+#include <stdint.h>
+#include <new>
+
+#include "thai_ftparser_config.h"
+#include "thai_ftparser_dict.h"
+#include "thai_ftparser_memory.h"
+#include "thai_ftparser_stats.h"
+#include "thai_ftparser_tcc.h"
+
+namespace oceanbase {
+namespace thai {
+
+/// 一篇文档的分词参数
+struct ObThaiSegmentParam
+{
+  const char *       begin_ = nullptr;
+  const char *       end_ = nullptr;
+  ObThaiDegradeLevel degrade_ = OB_THAI_DEGRADE_NONE;     // 本文档的内存预算档位
+  /// dict 和 viterbi 引擎第一次用到时才调用，词典由插件入口加载并打印日志
+  const ObThaiDictionary &(*get_dict_)() = nullptr;
+};
+
+/// 单个 token 的字节数上限，达到的 token 由解析器丢弃并记为 token_length 截断
+static const int64_t THAI_MAX_TOKEN_BYTES = 1000;
+
+/**
+ * @brief One segmentation engine, driven one document at a time.
+ * @details begin_document(), then next() until it returns false, then
+ * end_document(). Tokens point into the text or into memory the segmenter
+ * owns, and stay valid until the next call. A segmenter is constructed in
+ * a buffer inside the parser, so it should not allocate before the first
+ * document and must free everything in end_document() or its destructor.
+ * A segmenter may return tokens of any length; the parser drops those of
+ * THAI_MAX_TOKEN_BYTES or more.
+ */
+class ObThaiSegmenter
+{
+public:
+  virtual ~ObThaiSegmenter() {}
+
+  /**
+   * @return false if this engine cannot handle the document (e.g. the
+   * external process is unreachable); the parser then falls back to the
+   * space segmenter. The segmenter records its own fallback reason.
+   */
+  virtual bool begin_document(const ObThaiSegmentParam &param) = 0;
+  /// @return false once the document is exhausted
+  virtual bool next(const char *&word, int64_t &word_len) = 0;
+  /// 可以重复调用，也可以在 begin_document() 之前调用
+  virtual void end_document() {}
+  /// 当前持有的内存，计入解析器的内存统计
+  virtual int64_t allocated() const { return 0; }
+
+  /**
+   * 一篇文档预计占用的内存，扫描前按它向内存预算预留。流式引擎不分配，
+   * 沿用这里的 0；分配内存的引擎在派生类里用同名静态函数覆盖
+   * @param windowed 文档处于 OB_THAI_DEGRADE_WINDOWED 档位
+   */
+  static int64_t projected_bytes(int64_t doc_bytes, bool windowed) { return 0; }
+};
+
+/// 按空格、制表符和换行切分，不分配内存
+class ObThaiSpaceSegmenter final : public ObThaiSegmenter
+{
+public:
+  bool begin_document(const ObThaiSegmentParam &param) override
+  {
+    next_ = param.begin_;
+    end_ = param.end_;
+    return true;
+  }
+  bool next(const char *&word, int64_t &word_len) override
+  {
+    while (next_ < end_ && (' ' == *next_ || '\t' == *next_ || '\n' == *next_)) {
+      next_++;
+    }
+    if (next_ >= end_) {
+      return false;
+    }
+    word = next_;
+    while (next_ < end_ && ' ' != *next_ && '\t' != *next_ && '\n' != *next_) {
+      next_++;
+    }
+    word_len = next_ - word;
+    return true;
+  }
+
+private:
+  const char *next_ = nullptr;
+  const char *end_ = nullptr;
+};
+
+/// 按字符簇流式切分，不分配内存，见 thai_ftparser_tcc.h
+class ObThaiTccSegmenter final : public ObThaiSegmenter
+{
+public:
+  bool begin_document(const ObThaiSegmentParam &param) override
+  {
+    tcc_.reset(param.begin_, param.end_);
+    return true;
+  }
+  bool next(const char *&word, int64_t &word_len) override { return tcc_.next(word, word_len); }
+
+private:
+  ObThaiTccTokenizer tcc_;
+};
+
+/**
+ * @brief Overlapping pairs of adjacent Thai clusters.
+ * @details The Thai counterpart of the observer's ngram parser with
+ * ngram_token_size = 2: recall does not depend on a dictionary, at the
+ * cost of a larger index. A Thai run of a single cluster is emitted
+ * alone; non-Thai runs are emitted whole, as by the TCC segmenter.
+ */
+class ObThaiNgramSegmenter final : public ObThaiSegmenter
+{
+public:
+  bool begin_document(const ObThaiSegmentParam &param) override
+  {
+    tcc_.reset(param.begin_, param.end_);
+    prev_ = nullptr;
+    prev_len_ = 0;
+    prev_emitted_ = false;
+    held_ = nullptr;
+    held_len_ = 0;
+    return true;
+  }
+  bool next(const char *&word, int64_t &word_len) override;
+
+private:
+  ObThaiTccTokenizer tcc_;
+  const char *prev_ = nullptr;         // 上一个泰文字符簇，和下一个相邻时组成 bigram
+  int64_t     prev_len_ = 0;
+  bool        prev_emitted_ = false;   // prev_ 已经作为 bigram 的前半输出过
+  const char *held_ = nullptr;         // 先输出单独的 prev_，留到下次处理的 token
+  int64_t     held_len_ = 0;
+};
+
+/// ASCII 字母、数字和下划线，与 space_ftparser 的 true_word_char 在 ASCII 范围内一致
+inline bool thai_is_ascii_word_char(char c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || '_' == c;
+}
+
+/**
+ * @brief Runs of ASCII letters, digits and '_'; every other byte separates.
+ * @details What space_ftparser emits for ASCII text, without asking the
+ * charset for the type of every character. Meant for codes, SKUs and
+ * English columns of Thai applications; non-ASCII text yields no tokens.
+ */
+class ObThaiAsciiSegmenter final : public ObThaiSegmenter
+{
+public:
+  bool begin_document(const ObThaiSegmentParam &param) override
+  {
+    next_ = param.begin_;
+    end_ = param.end_;
+    return true;
+  }
+  bool next(const char *&word, int64_t &word_len) override
+  {
+    while (next_ < end_ && !thai_is_ascii_word_char(*next_)) {
+      next_++;
+    }
+    if (next_ >= end_) {
+      return false;
+    }
+    word = next_;
+    while (next_ < end_ && thai_is_ascii_word_char(*next_)) {
+      next_++;
+    }
+    word_len = next_ - word;
+    return true;
+  }
+
+private:
+  const char *next_ = nullptr;
+  const char *end_ = nullptr;
+};
+
+/// 词典分词，最大匹配或 Viterbi，见 thai_ftparser_dict.h
+template <ObThaiDictMode MODE>
+class ObThaiDictSegmenter final : public ObThaiSegmenter
+{
+public:
+  bool begin_document(const ObThaiSegmentParam &param) override
+  {
+    dict_.reset(nullptr != param.get_dict_ ? &param.get_dict_() : nullptr, param.begin_, param.end_, MODE);
+    return true;
+  }
+  bool next(const char *&word, int64_t &word_len) override { return dict_.next(word, word_len); }
+  void end_document() override { dict_.reset(nullptr, nullptr, nullptr, MODE); }
+  int64_t allocated() const override { return dict_.allocated(); }
+  /// token 指向原文，只有分词网格，与文档长度无关
+  static int64_t projected_bytes(int64_t doc_bytes, bool windowed) { return ObThaiDictTokenizer::LATTICE_BYTES; }
+
+private:
+  ObThaiDictTokenizer dict_;
+};
+
+/// 放得下任何已注册引擎的缓冲区大小
+static const int64_t THAI_SEGMENTER_BUF_BYTES = 512;
+static const int64_t THAI_SEGMENTER_BUF_ALIGN = 16;
+
+/**
+ * @brief Engine type to implementation.
+ * @details The core library registers space, tcc, dict, viterbi, worker,
+ * ngram and ascii; the plugin entry registers the Python bridge from plugin_init().
+ * Registration happens before the first scan and is not synchronized.
+ * An engine is constructed in place in a caller buffer of
+ * THAI_SEGMENTER_BUF_BYTES, so picking one costs no allocation.
+ */
+class ObThaiSegmenterRegistry final
+{
+public:
+  typedef ObThaiSegmenter *(*Creator)(void *buf);
+  typedef int64_t (*Projector)(int64_t doc_bytes, bool windowed);
+
+  static ObThaiSegmenterRegistry &instance();
+
+  template <typename T>
+  void add(ObThaiEngineType engine, ObThaiPath path)
+  {
+    static_assert(sizeof(T) <= THAI_SEGMENTER_BUF_BYTES, "segmenter too large for the parser buffer");
+    static_assert(alignof(T) <= THAI_SEGMENTER_BUF_ALIGN, "segmenter over-aligned for the parser buffer");
+    add(engine, path, &construct<T>, &T::projected_bytes);
+  }
+  void add(ObThaiEngineType engine, ObThaiPath path, Creator create, Projector project);
+
+  bool has(ObThaiEngineType engine) const
+  {
+    return engine >= 0 && engine < OB_THAI_ENGINE_MAX && nullptr != creators_[engine];
+  }
+  /// 统计里记到哪条路径
+  ObThaiPath path(ObThaiEngineType engine) const
+  {
+    return has(engine) ? paths_[engine] : OB_THAI_PATH_SPACE;
+  }
+  /// 在 buf 上构造引擎，未注册时返回 nullptr。用完调用析构函数，不要 delete
+  ObThaiSegmenter *create(ObThaiEngineType engine, void *buf) const
+  {
+    return has(engine) ? creators_[engine](buf) : nullptr;
+  }
+  /// 引擎处理一篇文档预计占用的内存，见 ObThaiSegmenter::projected_bytes
+  int64_t projected_bytes(ObThaiEngineType engine, int64_t doc_bytes, bool windowed) const
+  {
+    return has(engine) ? projectors_[engine](doc_bytes, windowed) : 0;
+  }
+
+private:
+  ObThaiSegmenterRegistry();
+
+  template <typename T>
+  static ObThaiSegmenter *construct(void *buf) { return new (buf) T(); }
+
+  Creator    creators_[OB_THAI_ENGINE_MAX];
+  ObThaiPath paths_[OB_THAI_ENGINE_MAX];
+  Projector  projectors_[OB_THAI_ENGINE_MAX];
+};
+
+/**
+ * @brief Looks the engine up in the registry for every document.
+ * @details For engines the parser has no specialization for, e.g. the
+ * Python bridge registered at plugin_init(). When the engine refuses a
+ * document, begin_document() switches to the space segmenter itself and
+ * returns false so the caller can log and count it.
+ */
+class ObThaiDynamicSegmenter final : public ObThaiSegmenter
+{
+public:
+  ObThaiDynamicSegmenter() = default;
+  ~ObThaiDynamicSegmenter() override { end_document(); }
+  ObThaiDynamicSegmenter(const ObThaiDynamicSegmenter &) = delete;
+  ObThaiDynamicSegmenter &operator=(const ObThaiDynamicSegmenter &) = delete;
+
+  void set_engine(ObThaiEngineType engine) { engine_ = engine; }
+  bool begin_document(const ObThaiSegmentParam &param) override;
+  bool next(const char *&word, int64_t &word_len) override
+  {
+    return nullptr != segmenter_ && segmenter_->next(word, word_len);
+  }
+  void end_document() override;
+  int64_t allocated() const override { return nullptr != segmenter_ ? segmenter_->allocated() : 0; }
+  /// 当前文档实际走的路径
+  ObThaiPath path() const { return path_; }
+
+private:
+  ObThaiEngineType engine_ = OB_THAI_ENGINE_SPACE;
+  ObThaiPath       path_ = OB_THAI_PATH_SPACE;
+  ObThaiSegmenter *segmenter_ = nullptr;
+  alignas(THAI_SEGMENTER_BUF_ALIGN) char buf_[THAI_SEGMENTER_BUF_BYTES];
+};
+
+} // namespace thai
+} // namespace oceanbase
+
+#endif // OB_THAI_FTPARSER_SEGMENTER_H_
@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "thai_ftparser_shadow.h"
+
+#include <algorithm>
+#include <chrono>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "thai_ftparser_memory.h"
+#include "thai_ftparser_segmenter.h"
+#include "thai_ftparser_slowlog.h"
+
+namespace oceanbase {
+namespace thai {
+
+namespace {
+
+// 每个线程独立的 xorshift 随机数，抽样不需要跨线程同步
+thread_local uint64_t t_shadow_seed = 0;
+
+uint64_t next_random()
+{
+  uint64_t x = t_shadow_seed;
+  if (0 == x) {
+    x = ((uint64_t)thai_monotonic_ns() ^ (uint64_t)(uintptr_t)&t_shadow_seed) | 1;
+  }
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  t_shadow_seed = x;
+  return x;
+}
+
+int64_t thread_cpu_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+bool entry_hash_less(const ObThaiShadowTokens::Entry &a, const ObThaiShadowTokens::Entry &b)
+{
+  return a.hash_ < b.hash_;
+}
+
+bool entry_hash_equal(const ObThaiShadowTokens::Entry &a, const ObThaiShadowTokens::Entry &b)
+{
+  return a.hash_ == b.hash_;
+}
+
+// 算出每个 token 的哈希，排序去重后 count_ 即不同 token 数
+void to_token_set(ObThaiShadowTokens &tokens)
+{
+  for (int64_t i = 0; i < tokens.count_; i++) {
+    ObThaiShadowTokens::Entry &e = tokens.entries_[i];
+    e.hash_ = thai_fnv1a64(tokens.bytes_ + e.offset_, e.len_);
+  }
+  std::sort(tokens.entries_, tokens.entries_ + tokens.count_, entry_hash_less);
+  tokens.count_ = std::unique(tokens.entries_, tokens.entries_ + tokens.count_, entry_hash_equal)
+                  - tokens.entries_;
+}
+
+// 两个有序集合的交集大小
+int64_t count_common(const ObThaiShadowTokens &a, const ObThaiShadowTokens &b)
+{
+  int64_t common = 0;
+  for (int64_t i = 0, j = 0; i < a.count_ && j < b.count_;) {
+    if (a.entries_[i].hash_ < b.entries_[j].hash_) {
+      i++;
+    } else if (a.entries_[i].hash_ > b.entries_[j].hash_) {
+      j++;
+    } else {
+      common++;
+      i++;
+      j++;
+    }
+  }
+  return common;
+}
+
+// 一个 token 一行，换行和反斜杠转义
+int64_t write_token(FILE *fp, char mark, const ObThaiShadowTokens &tokens, const ObThaiShadowTokens::Entry &e)
+{
+  int64_t n = 3;
+  fputc(mark, fp);
+  fputc(' ', fp);
+  const char *p = tokens.bytes_ + e.offset_;
+  for (uint32_t i = 0; i < e.len_; i++) {
+    if ('\n' == p[i] || '\\' == p[i]) {
+      fputc('\\', fp);
+      fputc('\n' == p[i] ? 'n' : '\\', fp);
+      n += 2;
+    } else {
+      fputc(p[i], fp);
+      n++;
+    }
+  }
+  fputc('\n', fp);
+  return n;
+}
+
+} // namespace
+
+ObThaiShadow &ObThaiShadow::instance()
+{
+  static ObThaiShadow shadow;
+  return shadow;
+}
+
+int ObThaiShadow::start(const ObThaiDictionary &(*get_dict)())
+{
+  int ret = 0;
+  const ObThaiConfig &config = ObThaiConfig::instance();
+  const ObThaiSegmenterRegistry &registry = ObThaiSegmenterRegistry::instance();
+  if (started_) {
+    // 多个解析器共享同一个影子线程
+  } else if (OB_THAI_ENGINE_AUTO == config.shadow_engine_ || 0 == config.shadow_sample_permille_) {
+    // 未配置
+  } else if (!registry.has(config.shadow_engine_)) {
+    // 例如不带 Python 的构建里配置了 python
+    ret = ENOENT;
+  } else {
+    engine_ = config.shadow_engine_;
+    path_ = registry.path(engine_);
+    sample_permille_ = config.shadow_sample_permille_;
+    cpu_permille_ = config.shadow_cpu_permille_;
+    get_dict_ = get_dict;
+    diff_path_ = config.shadow_diff_path_;
+    diff_max_bytes_ = config.shadow_diff_max_mb_ * 1024 * 1024;
+    if (!diff_path_.empty()) {
+      if (nullptr == (diff_fp_ = fopen(diff_path_.c_str(), "a"))) {
+        ret = errno;
+      } else {
+        diff_bytes_ = ftell(diff_fp_);
+      }
+    }
+    if (0 == ret) {
+      stop_ = false;
+      try {
+        thread_ = std::thread(&ObThaiShadow::run, this);
+        started_ = true;
+        enabled_.store(true);
+      } catch (...) {
+        ret = EAGAIN;
+      }
+    }
+    if (0 != ret && nullptr != diff_fp_) {
+      fclose(diff_fp_);
+      diff_fp_ = nullptr;
+    }
+  }
+  return ret;
+}
+
+void ObThaiShadow::stop()
+{
+  if (started_) {
+    enabled_.store(false);
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      stop_ = true;
+    }
+    cond_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    if (nullptr != diff_fp_) {
+      fclose(diff_fp_);
+      diff_fp_ = nullptr;
+    }
+    started_ = false;
+  }
+}
+
+bool ObThaiShadow::sampled()
+{
+  bool ret = false;
+  if ((int64_t)(next_random() % 1000) < sample_permille_) {
+    // 队列已满时连正文都不复制
+    ret = queued_.load(std::memory_order_relaxed) < SHADOW_QUEUE_DOCS;
+    if (!ret) {
+      ObThaiStats::instance().record_shadow(OB_THAI_SHADOW_DROPPED, 1);
+    }
+  }
+  return ret;
+}
+
+ObThaiShadowDoc *ObThaiShadow::create_doc(const char *text, int64_t len, ObThaiPath primary_path)
+{
+  typedef ObThaiShadowTokens::Entry Entry;
+  const int64_t bytes_cap = len * SHADOW_TOKEN_BYTES_FACTOR + SHADOW_TOKEN_SLACK;
+  const int64_t entries_cap = len / 2 + SHADOW_TOKEN_SLACK;
+  // 文档头 | 两侧的下标 | 正文 | 两侧的 token 字节，下标紧跟文档头以保证对齐
+  const int64_t entries_bytes = entries_cap * (int64_t)sizeof(Entry);
+  char *buf = (char *)thai_malloc(sizeof(ObThaiShadowDoc) + 2 * entries_bytes + len + 2 * bytes_cap,
+                                  OB_THAI_MEM_SHADOW);
+  ObThaiShadowDoc *doc = nullptr;
+  if (nullptr == buf) {
+    ObThaiStats::instance().record_shadow(OB_THAI_SHADOW_DROPPED, 1);
+  } else {
+    doc = new (buf) ObThaiShadowDoc();
+    char *p = buf + sizeof(ObThaiShadowDoc);
+    doc->primary_.entries_ = (Entry *)p;
+    doc->shadow_.entries_ = (Entry *)(p + entries_bytes);
+    p += 2 * entries_bytes;
+    memcpy(p, text, len);
+    doc->text_ = p;
+    doc->len_ = len;
+    p += len;
+    doc->primary_.bytes_ = p;
+    doc->shadow_.bytes_ = p + bytes_cap;
+    doc->primary_.bytes_cap_ = doc->shadow_.bytes_cap_ = bytes_cap;
+    doc->primary_.entries_cap_ = doc->shadow_.entries_cap_ = entries_cap;
+    doc->primary_path_ = primary_path;
+  }
+  return doc;
+}
+
+void ObThaiShadow::free_doc(ObThaiShadowDoc *doc)
+{
+  doc->~ObThaiShadowDoc();
+  thai_free(doc);
+}
+
+void ObThaiShadow::submit(ObThaiShadowDoc *doc)
+{
+  bool queued = false;
+  if (doc->complete_ && !doc->primary_.overflow_ && enabled_.load(std::memory_order_relaxed)) {
+    // 后台线程只在出入队时持锁，拿不到锁说明正忙，丢掉这篇也不让扫描线程等待
+    std::unique_lock<std::mutex> guard(lock_, std::try_to_lock);
+    if (guard.owns_lock() && !stop_ && queued_.load(std::memory_order_relaxed) < SHADOW_QUEUE_DOCS) {
+      doc->next_ = nullptr;
+      if (nullptr != tail_) {
+        tail_->next_ = doc;
+      } else {
+        head_ = doc;
+      }
+      tail_ = doc;
+      queued_.fetch_add(1, std::memory_order_relaxed);
+      queued = true;
+    }
+  }
+  if (queued) {
+    cond_.notify_one();
+  } else {
+    ObThaiStats::instance().record_shadow(OB_THAI_SHADOW_DROPPED, 1);
+    free_doc(doc);
+  }
+}
+
+void ObThaiShadow::run()
+{
+  pthread_setname_np(pthread_self(), "ThaiShadow");
+  std::unique_lock<std::mutex> guard(lock_);
+  while (!stop_) {
+    if (nullptr == head_) {
+      cond_.wait(guard);
+      continue;
+    }
+    ObThaiShadowDoc *doc = head_;
+    head_ = doc->next_;
+    if (nullptr == head_) {
+      tail_ = nullptr;
+    }
+    guard.unlock();
+    const int64_t cpu_begin = thread_cpu_ns();
+    compare(*doc);
+    free_doc(doc);
+    const int64_t cpu_ns = thread_cpu_ns() - cpu_begin;
+    guard.lock();
+    // 处理完才出队计数，休眠期间队列保持占满，新的抽样直接放弃
+    const int64_t idle_ns = cpu_ns * (1000 - cpu_permille_) / cpu_permille_;
+    if (idle_ns > 0) {
+      cond_.wait_for(guard, std::chrono::nanoseconds(idle_ns), [this] { return stop_; });
+    }
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  while (nullptr != head_) {
+    ObThaiShadowDoc *doc = head_;
+    head_ = doc->next_;
+    free_doc(doc);
+  }
+  tail_ = nullptr;
+  queued_.store(0, std::memory_order_relaxed);
+}
+
+void ObThaiShadow::compare(ObThaiShadowDoc &doc)
+{
+  ObThaiStats &stats = ObThaiStats::instance();
+  ObThaiSegmentParam param;
+  param.begin_ = doc.text_;
+  param.end_ = doc.text_ + doc.len_;
+  param.get_dict_ = get_dict_;
+  ObThaiDynamicSegmenter segmenter;
+  segmenter.set_engine(engine_);
+  const int64_t begin_ns = thai_monotonic_ns();
+  const bool ok = segmenter.begin_document(param);
+  const char *word = nullptr;
+  int64_t word_len = 0;
+  while (ok && !doc.shadow_.overflow_ && segmenter.next(word, word_len)) {
+    doc.shadow_.add(word, word_len);
+  }
+  segmenter.end_document();
+  const int64_t shadow_ns = thai_monotonic_ns() - begin_ns;
+
+  if (!ok) {
+    stats.record_shadow(OB_THAI_SHADOW_FAILED, 1);
+  } else if (doc.shadow_.overflow_) {
+    stats.record_shadow(OB_THAI_SHADOW_DROPPED, 1);
+  } else {
+    to_token_set(doc.primary_);
+    to_token_set(doc.shadow_);
+    const int64_t common = count_common(doc.primary_, doc.shadow_);
+    const bool disagree = common != doc.primary_.count_ || common != doc.shadow_.count_;
+    stats.record_shadow(OB_THAI_SHADOW_DOCS, 1);
+    stats.record_shadow(OB_THAI_SHADOW_PRIMARY_TOKENS, doc.primary_.count_);
+    stats.record_shadow(OB_THAI_SHADOW_SHADOW_TOKENS, doc.shadow_.count_);
+    stats.record_shadow(OB_THAI_SHADOW_COMMON_TOKENS, common);
+    stats.record_shadow(OB_THAI_SHADOW_PRIMARY_NS, doc.primary_ns_);
+    stats.record_shadow(OB_THAI_SHADOW_SHADOW_NS, shadow_ns);
+    if (disagree) {
+      stats.record_shadow(OB_THAI_SHADOW_DISAGREE, 1);
+      if (nullptr != diff_fp_) {
+        write_diff(doc, common);
+      }
+    }
+  }
+}
+
+void ObThaiShadow::write_diff(const ObThaiShadowDoc &doc, int64_t common)
+{
+  if (diff_bytes_ >= diff_max_bytes_) {
+    rotate_diff_file();
+  }
+  if (nullptr != diff_fp_) {
+    const ObThaiShadowTokens &a = doc.primary_;
+    const ObThaiShadowTokens &b = doc.shadow_;
+    int n = fprintf(diff_fp_, "doc hash=%016lx bytes=%ld primary=%s shadow=%s "
+                    "primary_tokens=%ld shadow_tokens=%ld common_tokens=%ld\n",
+                    thai_fnv1a64(doc.text_, doc.len_), doc.len_, get_path_name(doc.primary_path_),
+                    get_path_name(path_), a.count_, b.count_, common);
+    diff_bytes_ += n > 0 ? n : 0;
+    // 两个有序集合归并，'-' 只在主引擎，'+' 只在影子引擎
+    int64_t only_a = 0;
+    int64_t only_b = 0;
+    for (int64_t i = 0, j = 0; i < a.count_ || j < b.count_;) {
+      if (j >= b.count_ || (i < a.count_ && a.entries_[i].hash_ < b.entries_[j].hash_)) {
+        if (only_a++ < SHADOW_DIFF_MAX_TOKENS) {
+          diff_bytes_ += write_token(diff_fp_, '-', a, a.entries_[i]);
+        }
+        i++;
+      } else if (i >= a.count_ || a.entries_[i].hash_ > b.entries_[j].hash_) {
+        if (only_b++ < SHADOW_DIFF_MAX_TOKENS) {
+          diff_bytes_ += write_token(diff_fp_, '+', b, b.entries_[j]);
+        }
+        j++;
+      } else {
+        i++;
+        j++;
+      }
+    }
+    fputc('\n', diff_fp_);
+    diff_bytes_++;
+    fflush(diff_fp_);
+  }
+}
+
+void ObThaiShadow::rotate_diff_file()
+{
+  // 最多保留当前文件和一个 .1，磁盘占用不超过上限的两倍
+  fclose(diff_fp_);
+  const std::string old_path = diff_path_ + ".1";
+  rename(diff_path_.c_str(), old_path.c_str());
+  diff_fp_ = fopen(diff_path_.c_str(), "w");
+  diff_bytes_ = 0;
+}
+
+} // namespace thai
+} // namespace oceanbase
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_SHADOW_H_
+#define OB_THAI_FTPARSER_SHADOW_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <thread>
+
+#include "thai_ftparser_config.h"
+#include "thai_ftparser_dict.h"
+#include "thai_ftparser_stats.h"
+
+namespace oceanbase {
+namespace thai {
+
+/// 一侧引擎的输出，token 字节和下标都在所属文档的那一次分配里
+struct ObThaiShadowTokens
+{
+  struct Entry
+  {
+    uint64_t hash_;       // 比较时才计算
+    uint32_t offset_;     // 在 bytes_ 中的位置
+    uint32_t len_;
+  };
+
+  char *  bytes_ = nullptr;
+  int64_t bytes_cap_ = 0;
+  int64_t bytes_len_ = 0;
+  Entry * entries_ = nullptr;
+  int64_t entries_cap_ = 0;
+  int64_t count_ = 0;
+  bool    overflow_ = false;   // 超出容量，本文档不参与比较
+
+  void add(const char *word, int64_t len)
+  {
+    if (count_ >= entries_cap_ || len > bytes_cap_ - bytes_len_) {
+      overflow_ = true;
+    } else {
+      memcpy(bytes_ + bytes_len_, word, len);
+      entries_[count_].hash_ = 0;
+      entries_[count_].offset_ = (uint32_t)bytes_len_;
+      entries_[count_].len_ = (uint32_t)len;
+      bytes_len_ += len;
+      count_++;
+    }
+  }
+};
+
+/// 一篇抽样文档：正文副本和两侧引擎的 token，一次 thai_malloc 分配
+struct ObThaiShadowDoc
+{
+  const char *       text_ = nullptr;
+  int64_t            len_ = 0;
+  ObThaiPath         primary_path_ = OB_THAI_PATH_MAX;
+  int64_t            primary_ns_ = 0;     // 主引擎 scan_begin 加上取 token 的耗时
+  bool               complete_ = false;   // 主引擎的 token 已取完
+  ObThaiShadowTokens primary_;            // 解析器输出时记下
+  ObThaiShadowTokens shadow_;             // 后台线程填写
+  ObThaiShadowDoc *  next_ = nullptr;     // 队列链表
+};
+
+/**
+ * @brief Shadow mode: re-segments sampled documents with a second engine.
+ * @details Meant to collect evidence before moving a node from one engine
+ * to another, e.g. from python to viterbi. With
+ * OB_THAI_FTPARSER_SHADOW_ENGINE set, a sample of
+ * OB_THAI_FTPARSER_SHADOW_SAMPLE_PERMILLE documents keeps a copy of its
+ * text and of every token the primary engine emits; at scan_end the copy is
+ * queued for a background thread, which runs the shadow engine on it and
+ * compares the two token sets. Disagreeing documents, distinct tokens on
+ * each side and the cost of both engines go to the stats, and the tokens
+ * found by only one side are appended to OB_THAI_FTPARSER_SHADOW_DIFF_FILE,
+ * which rotates to <file>.1 at OB_THAI_FTPARSER_SHADOW_DIFF_MAX_MB.
+ *
+ * The scan path never waits for the shadow: after each document the thread
+ * sleeps long enough to stay within OB_THAI_FTPARSER_SHADOW_CPU_PERMILLE of
+ * one core, and samples that find the queue full or locked are dropped and
+ * counted. Documents above SHADOW_MAX_DOC_BYTES, documents scanned under
+ * memory pressure and documents the primary already routed to the shadow
+ * engine's path are not sampled.
+ */
+class ObThaiShadow final
+{
+public:
+  static const int64_t SHADOW_MAX_DOC_BYTES = 65536;
+  static const int64_t SHADOW_QUEUE_DOCS = 8;
+  /// 每侧 token 的容量：字节数为正文的倍数加余量，个数为正文字节数的一半加余量
+  static const int64_t SHADOW_TOKEN_BYTES_FACTOR = 2;
+  static const int64_t SHADOW_TOKEN_SLACK = 1024;
+  /// 差异文件里每侧最多列出的 token 数
+  static const int64_t SHADOW_DIFF_MAX_TOKENS = 32;
+
+  static ObThaiShadow &instance();
+
+  /**
+   * 按配置启动后台线程，未配置影子引擎时什么也不做
+   * @param get_dict dict 和 viterbi 引擎使用的词典
+   * @return 0 on success, otherwise an errno value
+   */
+  int start(const ObThaiDictionary &(*get_dict)());
+  void stop();
+
+  /**
+   * 决定是否抽样本文档，抽中时复制正文，主引擎输出的 token 记到返回的文档里
+   * @return nullptr if not sampled
+   */
+  ObThaiShadowDoc *sample(const char *text, int64_t len, ObThaiPath primary_path)
+  {
+    ObThaiShadowDoc *doc = nullptr;
+    if (enabled_.load(std::memory_order_relaxed) && len > 0 && len <= SHADOW_MAX_DOC_BYTES
+        && primary_path != path_ && sampled()) {
+      doc = create_doc(text, len, primary_path);
+    }
+    return doc;
+  }
+  /// 交给后台线程比较，接管 doc；队列已满或未取完的文档直接释放
+  void submit(ObThaiShadowDoc *doc);
+
+private:
+  ObThaiShadow() = default;
+  ~ObThaiShadow() { stop(); }
+
+  bool sampled();
+  ObThaiShadowDoc *create_doc(const char *text, int64_t len, ObThaiPath primary_path);
+  static void free_doc(ObThaiShadowDoc *doc);
+  void run();
+  void compare(ObThaiShadowDoc &doc);
+  void write_diff(const ObThaiShadowDoc &doc, int64_t common);
+  void rotate_diff_file();
+
+  std::atomic<bool>       enabled_{false};
+  std::atomic<int64_t>    queued_{0};
+  bool                    started_ = false;
+  ObThaiEngineType        engine_ = OB_THAI_ENGINE_AUTO;
+  ObThaiPath              path_ = OB_THAI_PATH_MAX;
+  int64_t                 sample_permille_ = 0;
+  int64_t                 cpu_permille_ = 0;
+  const ObThaiDictionary &(*get_dict_)() = nullptr;
+
+  std::thread             thread_;
+  std::mutex              lock_;
+  std::condition_variable cond_;
+  bool                    stop_ = false;
+  ObThaiShadowDoc *       head_ = nullptr;
+  ObThaiShadowDoc *       tail_ = nullptr;
+
+  // 只由后台线程访问
+  std::string             diff_path_;
+  int64_t                 diff_max_bytes_ = 0;
+  int64_t                 diff_bytes_ = 0;
+  FILE *                  diff_fp_ = nullptr;
+};
+
+} // namespace thai
+} // namespace oceanbase
+
+#endif // OB_THAI_FTPARSER_SHADOW_H_
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "thai_ftparser_slowlog.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include "thai_ftparser_config.h"
+
+namespace oceanbase {
+namespace thai {
+
+static bool slower_on_top(const ObThaiSlowDoc &a, const ObThaiSlowDoc &b)
+{
+  // std::*_heap 默认大顶堆，反过来比较得到小顶堆
+  return a.elapsed_ns_ > b.elapsed_ns_;
+}
+
+uint64_t thai_fnv1a64(const char *data, int64_t len)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (int64_t i = 0; i < len; i++) {
+    hash ^= (unsigned char)data[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// std::min 按引用取参数，C++11 下需要类外定义
+const int64_t ObThaiSlowDoc::MAX_PREFIX_LEN;
+
+ObThaiSlowDocSampler &ObThaiSlowDocSampler::instance()
+{
+  static ObThaiSlowDocSampler sampler;
+  return sampler;
+}
+
+ObThaiSlowDocSampler::ObThaiSlowDocSampler()
+{
+  const ObThaiConfig &config = ObThaiConfig::instance();
+  top_k_ = config.slow_doc_top_k_;
+  prefix_len_ = std::min(config.slow_doc_prefix_len_, ObThaiSlowDoc::MAX_PREFIX_LEN);
+  if (top_k_ > 0) {
+    heap_.reserve(top_k_);
+  }
+}
+
+void ObThaiSlowDocSampler::add(const char *text, int64_t len, int32_t thai_permille,
+                               ObThaiPath path, int64_t elapsed_ns)
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  const bool full = (int64_t)heap_.size() >= top_k_;
+  if (!full || elapsed_ns > heap_.front().elapsed_ns_) {
+    ObThaiSlowDoc doc;
+    doc.elapsed_ns_ = elapsed_ns;
+    doc.hash_ = nullptr != text ? thai_fnv1a64(text, len) : 0;
+    doc.bytes_ = len;
+    doc.thai_permille_ = thai_permille;
+    doc.path_ = path;
+    if (nullptr != text && prefix_len_ > 0) {
+      int64_t n = std::min(len, prefix_len_);
+      // 不截断 UTF-8 多字节字符
+      while (n > 0 && n < len && 0x80 == ((unsigned char)text[n] & 0xC0)) {
+        n--;
+      }
+      memcpy(doc.prefix_, text, n);
+      doc.prefix_len_ = (int32_t)n;
+    }
+    if (full) {
+      std::pop_heap(heap_.begin(), heap_.end(), slower_on_top);
+      heap_.back() = doc;
+    } else {
+      heap_.push_back(doc);
+    }
+    std::push_heap(heap_.begin(), heap_.end(), slower_on_top);
+    if ((int64_t)heap_.size() >= top_k_) {
+      threshold_ns_.store(heap_.front().elapsed_ns_, std::memory_order_relaxed);
+    }
+  }
+}
+
+int64_t ObThaiSlowDocSampler::report(char *buf, int64_t buf_len, bool reset)
+{
+  int64_t pos = 0;
+  if (nullptr == buf || buf_len <= 0) {
+    return 0;
+  }
+  buf[0] = '\0';
+  std::vector<ObThaiSlowDoc> docs;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (reset) {
+      docs.swap(heap_);
+      heap_.reserve(top_k_ > 0 ? top_k_ : 0);
+      threshold_ns_.store(-1, std::memory_order_relaxed);
+    } else {
+      docs = heap_;
+    }
+  }
+  std::sort(docs.begin(), docs.end(), slower_on_top);
+  thai_databuff_printf(buf, buf_len, pos, "[");
+  for (size_t i = 0; i < docs.size(); i++) {
+    const ObThaiSlowDoc &doc = docs[i];
+    thai_databuff_printf(buf, buf_len, pos,
+                         "%s{elapsed_us=%.1f, hash=%016lx, bytes=%ld, thai_ratio=%.3f, engine=%s",
+                         i > 0 ? ", " : "", (double)doc.elapsed_ns_ / 1000.0, doc.hash_, doc.bytes_,
+                         (double)doc.thai_permille_ / 1000.0, get_path_name(doc.path_));
+    if (doc.prefix_len_ > 0) {
+      // 控制字符和引号转义，保证日志单行
+      thai_databuff_printf(buf, buf_len, pos, ", prefix=\"");
+      for (int32_t j = 0; j < doc.prefix_len_; j++) {
+        const unsigned char c = (unsigned char)doc.prefix_[j];
+        if (c < 0x20 || c == 0x7F || c == '"' || c == '\\') {
+          thai_databuff_printf(buf, buf_len, pos, "\\x%02x", c);
+        } else {
+          thai_databuff_printf(buf, buf_len, pos, "%c", c);
+        }
+      }
+      thai_databuff_printf(buf, buf_len, pos, "\"");
+    }
+    thai_databuff_printf(buf, buf_len, pos, "}");
+  }
+  thai_databuff_printf(buf, buf_len, pos, "]");
+  return pos;
+}
+
+} // namespace thai
+} // namespace oceanbase
+
+int64_t thai_ftparser_slow_docs(char *buf, int64_t buf_len)
+{
+  return oceanbase::thai::ObThaiSlowDocSampler::instance().report(buf, buf_len, false);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_SLOWLOG_H_
+#define OB_THAI_FTPARSER_SLOWLOG_H_
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+#include "thai_ftparser_common.h"
+#include "thai_ftparser_stats.h"
+
+namespace oceanbase {
+namespace thai {
+
+/// 一篇慢文档的记录
+struct ObThaiSlowDoc
+{
+  static const int64_t MAX_PREFIX_LEN = 128;
+
+  int64_t    elapsed_ns_ = 0;
+  uint64_t   hash_ = 0;          // 全文 FNV-1a 64
+  int64_t    bytes_ = 0;
+  int32_t    thai_permille_ = 0; // 泰文字符占比，千分比
+  ObThaiPath path_ = OB_THAI_PATH_MAX;
+  int32_t    prefix_len_ = 0;
+  char       prefix_[MAX_PREFIX_LEN];
+};
+
+/**
+ * @brief Keeps the K slowest documents of the current interval.
+ * @details The hot path is one relaxed load: a document is only considered
+ * when it is slower than the fastest entry of a full heap. Hashing and the
+ * prefix copy happen only for admitted documents. report() prints the
+ * entries slowest first; with reset it also starts a new interval.
+ */
+class ObThaiSlowDocSampler final
+{
+public:
+  static ObThaiSlowDocSampler &instance();
+
+  void sample(const char *text, int64_t len, int32_t thai_permille, ObThaiPath path, int64_t elapsed_ns)
+  {
+    if (top_k_ > 0 && elapsed_ns > threshold_ns_.load(std::memory_order_relaxed)) {
+      add(text, len, thai_permille, path, elapsed_ns);
+    }
+  }
+
+  int64_t report(char *buf, int64_t buf_len, bool reset);
+
+private:
+  ObThaiSlowDocSampler();
+  void add(const char *text, int64_t len, int32_t thai_permille, ObThaiPath path, int64_t elapsed_ns);
+
+  int64_t                    top_k_;
+  int64_t                    prefix_len_;
+  std::atomic<int64_t>       threshold_ns_{-1};
+  std::mutex                 lock_;
+  std::vector<ObThaiSlowDoc> heap_;          // 以 elapsed_ns_ 为键的小顶堆
+};
+
+/// 全文哈希，离线复现时用来定位原始行
+uint64_t thai_fnv1a64(const char *data, int64_t len);
+
+} // namespace thai
+} // namespace oceanbase
+
+/**
+ * Slowest documents of the current interval, without resetting it.
+ * @return bytes written, excluding the trailing '\0'
+ */
+THAI_EXPORT int64_t thai_ftparser_slow_docs(char *buf, int64_t buf_len);
+
+#endif // OB_THAI_FTPARSER_SLOWLOG_H_
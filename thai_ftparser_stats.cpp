@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "thai_ftparser_stats.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace oceanbase {
+namespace thai {
+
+static const char *PATH_NAMES[OB_THAI_PATH_MAX] = {
+  "python",
+  "space",
+  "emergency",
+  "tcc",
+  "dict",
+  "viterbi",
+  "worker",
+  "ngram",
+  "ascii",
+};
+
+static const char *FALLBACK_NAMES[OB_THAI_FALLBACK_MAX] = {
+  "non_thai",
+  "python_init",
+  "python_tokenize",
+  "emergency",
+  "worker",
+  "worker_breaker",
+};
+
+static const char *TRUNCATION_NAMES[OB_THAI_TRUNC_MAX] = {
+  "text_bytes",
+  "token_count",
+  "token_length",
+};
+
+static const char *SHADOW_STAT_NAMES[OB_THAI_SHADOW_MAX] = {
+  "docs",
+  "dropped",
+  "failed",
+  "disagree",
+  "primary_tokens",
+  "shadow_tokens",
+  "common_tokens",
+  "primary_ns",
+  "shadow_ns",
+};
+
+const char *get_path_name(ObThaiPath path)
+{
+  return (path >= 0 && path < OB_THAI_PATH_MAX) ? PATH_NAMES[path] : "unknown";
+}
+
+const char *get_fallback_name(ObThaiFallbackReason reason)
+{
+  return (reason >= 0 && reason < OB_THAI_FALLBACK_MAX) ? FALLBACK_NAMES[reason] : "unknown";
+}
+
+const char *get_truncation_name(ObThaiTruncation type)
+{
+  return (type >= 0 && type < OB_THAI_TRUNC_MAX) ? TRUNCATION_NAMES[type] : "unknown";
+}
+
+const char *get_shadow_stat_name(ObThaiShadowStat id)
+{
+  return (id >= 0 && id < OB_THAI_SHADOW_MAX) ? SHADOW_STAT_NAMES[id] : "unknown";
+}
+
+void ObThaiStatsSnapshot::reset()
+{
+  memset(docs_, 0, sizeof(docs_));
+  memset(bytes_, 0, sizeof(bytes_));
+  memset(tokens_, 0, sizeof(tokens_));
+  memset(ns_, 0, sizeof(ns_));
+  memset(fallbacks_, 0, sizeof(fallbacks_));
+  memset(truncations_, 0, sizeof(truncations_));
+  memset(shadow_, 0, sizeof(shadow_));
+  threads_ = 0;
+}
+
+uint64_t ObThaiStatsSnapshot::total_docs() const
+{
+  uint64_t total = 0;
+  for (int i = 0; i < OB_THAI_PATH_MAX; i++) {
+    total += docs_[i];
+  }
+  return total;
+}
+
+int64_t ObThaiStatsSnapshot::to_string(char *buf, int64_t buf_len) const
+{
+  int64_t pos = 0;
+  if (nullptr == buf || buf_len <= 0) {
+    return 0;
+  }
+  buf[0] = '\0';
+  thai_databuff_printf(buf, buf_len, pos, "threads=%ld, docs=%lu", threads_, total_docs());
+  for (int i = 0; i < OB_THAI_PATH_MAX; i++) {
+    thai_databuff_printf(buf, buf_len, pos, ", %s={docs=%lu, bytes=%lu, tokens=%lu, avg_us=%lu}",
+                         PATH_NAMES[i], docs_[i], bytes_[i], tokens_[i],
+                         docs_[i] > 0 ? ns_[i] / docs_[i] / 1000 : 0);
+  }
+  thai_databuff_printf(buf, buf_len, pos, ", fallback={");
+  for (int i = 0; i < OB_THAI_FALLBACK_MAX; i++) {
+    thai_databuff_printf(buf, buf_len, pos, "%s%s=%lu", i > 0 ? ", " : "", FALLBACK_NAMES[i], fallbacks_[i]);
+  }
+  thai_databuff_printf(buf, buf_len, pos, "}, truncation={");
+  for (int i = 0; i < OB_THAI_TRUNC_MAX; i++) {
+    thai_databuff_printf(buf, buf_len, pos, "%s%s=%lu", i > 0 ? ", " : "", TRUNCATION_NAMES[i], truncations_[i]);
+  }
+  thai_databuff_printf(buf, buf_len, pos, "}");
+  if (shadow_[OB_THAI_SHADOW_DOCS] + shadow_[OB_THAI_SHADOW_DROPPED] + shadow_[OB_THAI_SHADOW_FAILED] > 0) {
+    // 不一致率和影子引擎相对主引擎的耗时，都是千分比
+    const uint64_t docs = shadow_[OB_THAI_SHADOW_DOCS];
+    const uint64_t primary_ns = shadow_[OB_THAI_SHADOW_PRIMARY_NS];
+    thai_databuff_printf(buf, buf_len, pos, ", shadow={docs=%lu, dropped=%lu, failed=%lu, disagree=%lu, "
+                         "primary_tokens=%lu, shadow_tokens=%lu, common_tokens=%lu, "
+                         "disagree_permille=%lu, cost_permille=%lu}",
+                         docs, shadow_[OB_THAI_SHADOW_DROPPED], shadow_[OB_THAI_SHADOW_FAILED],
+                         shadow_[OB_THAI_SHADOW_DISAGREE], shadow_[OB_THAI_SHADOW_PRIMARY_TOKENS],
+                         shadow_[OB_THAI_SHADOW_SHADOW_TOKENS], shadow_[OB_THAI_SHADOW_COMMON_TOKENS],
+                         docs > 0 ? shadow_[OB_THAI_SHADOW_DISAGREE] * 1000 / docs : 0,
+                         primary_ns > 0 ? shadow_[OB_THAI_SHADOW_SHADOW_NS] * 1000 / primary_ns : 0);
+  }
+  return pos;
+}
+
+ObThaiStats &ObThaiStats::instance()
+{
+  static ObThaiStats stats;
+  return stats;
+}
+
+void ObThaiStats::snapshot(ObThaiStatsSnapshot &snap) const
+{
+  uint64_t values[OB_THAI_STAT_MAX];
+  memset(values, 0, sizeof(values));
+  snap.reset();
+  ObThaiThreadSlots<ObThaiStatsSlot>::for_each(
+      [&values, &snap](const ObThaiStatsSlot &slot, bool in_use) {
+        for (int i = 0; i < OB_THAI_STAT_MAX; i++) {
+          values[i] += slot.values_[i].load(std::memory_order_relaxed);
+        }
+        if (in_use) {
+          snap.threads_++;
+        }
+      });
+  for (int i = 0; i < OB_THAI_PATH_MAX; i++) {
+    snap.docs_[i] = values[OB_THAI_STAT_DOCS + i];
+    snap.bytes_[i] = values[OB_THAI_STAT_BYTES + i];
+    snap.tokens_[i] = values[OB_THAI_STAT_TOKENS + i];
+    snap.ns_[i] = values[OB_THAI_STAT_NS + i];
+  }
+  for (int i = 0; i < OB_THAI_FALLBACK_MAX; i++) {
+    snap.fallbacks_[i] = values[OB_THAI_STAT_FALLBACK + i];
+  }
+  for (int i = 0; i < OB_THAI_TRUNC_MAX; i++) {
+    snap.truncations_[i] = values[OB_THAI_STAT_TRUNC + i];
+  }
+  for (int i = 0; i < OB_THAI_SHADOW_MAX; i++) {
+    snap.shadow_[i] = values[OB_THAI_STAT_SHADOW + i];
+  }
+}
+
+bool ObThaiStats::report_due(int64_t interval_sec)
+{
+  bool due = false;
+  if (interval_sec > 0) {
+    const int64_t now = thai_monotonic_ns();
+    int64_t next = next_report_ns_.load(std::memory_order_relaxed);
+    if (0 == next) {
+      // 第一次调用只设定起点
+      next_report_ns_.compare_exchange_strong(next, now + interval_sec * 1000000000LL,
+                                              std::memory_order_relaxed);
+    } else if (now >= next) {
+      due = next_report_ns_.compare_exchange_strong(next, now + interval_sec * 1000000000LL,
+                                                    std::memory_order_relaxed);
+    }
+  }
+  return due;
+}
+
+} // namespace thai
+} // namespace oceanbase
+
+int64_t thai_ftparser_stats_snapshot(char *buf, int64_t buf_len)
+{
+  oceanbase::thai::ObThaiStatsSnapshot snap;
+  oceanbase::thai::ObThaiStats::instance().snapshot(snap);
+  return snap.to_string(buf, buf_len);
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_STATS_H_
+#define OB_THAI_FTPARSER_STATS_H_
+
+#include <atomic>
+#include <stdint.h>
+
+#include "thai_ftparser_common.h"
+#include "thai_ftparser_tls.h"
+
+namespace oceanbase {
+namespace thai {
+
+/// 文档最终走的分词路径
+enum ObThaiPath
+{
+  OB_THAI_PATH_PYTHON = 0,   // thai_tokenizer 分词
+  OB_THAI_PATH_SPACE,        // 空格分词 (非泰语或 Python 失败)
+  OB_THAI_PATH_EMERGENCY,    // 紧急关闭模式
+  OB_THAI_PATH_TCC,          // 超出内存预算，按字符簇流式切分
+  OB_THAI_PATH_DICT,         // 词典分词
+  OB_THAI_PATH_VITERBI,      // 词典加词频分词
+  OB_THAI_PATH_WORKER,       // 外部分词进程
+  OB_THAI_PATH_NGRAM,        // 字符簇 bigram
+  OB_THAI_PATH_ASCII,        // 只取 ASCII 单词
+  OB_THAI_PATH_MAX
+};
+
+/// 回退到空格分词的原因
+enum ObThaiFallbackReason
+{
+  OB_THAI_FALLBACK_NON_THAI = 0,
+  OB_THAI_FALLBACK_PYTHON_INIT,
+  OB_THAI_FALLBACK_PYTHON_TOKENIZE,
+  OB_THAI_FALLBACK_EMERGENCY,
+  OB_THAI_FALLBACK_WORKER,         // 外部分词进程连接、超时或应答出错
+  OB_THAI_FALLBACK_WORKER_BREAKER, // 外部分词进程连续超时，熔断期间直接跳过
+  OB_THAI_FALLBACK_MAX
+};
+
+/// 触发的截断上限
+enum ObThaiTruncation
+{
+  OB_THAI_TRUNC_TEXT_BYTES = 0,   // 输入超过 10000 字节
+  OB_THAI_TRUNC_TOKEN_COUNT,      // 结果超过 1000 个 token
+  OB_THAI_TRUNC_TOKEN_LENGTH,     // 单个 token 超过 1000 字节被丢弃
+  OB_THAI_TRUNC_MAX
+};
+
+/// 影子模式的计数，见 thai_ftparser_shadow.h
+enum ObThaiShadowStat
+{
+  OB_THAI_SHADOW_DOCS = 0,           // 两个引擎都分完并比较过的文档
+  OB_THAI_SHADOW_DROPPED,            // 抽中但因队列已满、token 超出容量等原因放弃
+  OB_THAI_SHADOW_FAILED,             // 影子引擎拒绝了文档 (例如外部进程不可用)
+  OB_THAI_SHADOW_DISAGREE,           // token 集合不一致的文档
+  OB_THAI_SHADOW_PRIMARY_TOKENS,     // 主引擎的不同 token 数
+  OB_THAI_SHADOW_SHADOW_TOKENS,      // 影子引擎的不同 token 数
+  OB_THAI_SHADOW_COMMON_TOKENS,      // 两边都有的 token 数
+  OB_THAI_SHADOW_PRIMARY_NS,
+  OB_THAI_SHADOW_SHADOW_NS,
+  OB_THAI_SHADOW_MAX
+};
+
+/// 各计数器在每个线程槽位中的下标
+enum ObThaiStatId
+{
+  OB_THAI_STAT_DOCS = 0,
+  OB_THAI_STAT_BYTES = OB_THAI_STAT_DOCS + OB_THAI_PATH_MAX,
+  OB_THAI_STAT_TOKENS = OB_THAI_STAT_BYTES + OB_THAI_PATH_MAX,
+  OB_THAI_STAT_NS = OB_THAI_STAT_TOKENS + OB_THAI_PATH_MAX,
+  OB_THAI_STAT_FALLBACK = OB_THAI_STAT_NS + OB_THAI_PATH_MAX,
+  OB_THAI_STAT_TRUNC = OB_THAI_STAT_FALLBACK + OB_THAI_FALLBACK_MAX,
+  OB_THAI_STAT_SHADOW = OB_THAI_STAT_TRUNC + OB_THAI_TRUNC_MAX,
+  OB_THAI_STAT_MAX = OB_THAI_STAT_SHADOW + OB_THAI_SHADOW_MAX
+};
+
+const char *get_path_name(ObThaiPath path);
+const char *get_fallback_name(ObThaiFallbackReason reason);
+const char *get_truncation_name(ObThaiTruncation type);
+const char *get_shadow_stat_name(ObThaiShadowStat id);
+
+/**
+ * @brief Aggregated view of all thread slots at one moment.
+ */
+struct ObThaiStatsSnapshot
+{
+  uint64_t docs_[OB_THAI_PATH_MAX];
+  uint64_t bytes_[OB_THAI_PATH_MAX];
+  uint64_t tokens_[OB_THAI_PATH_MAX];
+  uint64_t ns_[OB_THAI_PATH_MAX];
+  uint64_t fallbacks_[OB_THAI_FALLBACK_MAX];
+  uint64_t truncations_[OB_THAI_TRUNC_MAX];
+  uint64_t shadow_[OB_THAI_SHADOW_MAX];
+  int64_t  threads_;
+
+  ObThaiStatsSnapshot() { reset(); }
+  void reset();
+  uint64_t total_docs() const;
+  /// 以 key=value 形式输出，返回写入长度(不含结尾的'\0')
+  int64_t to_string(char *buf, int64_t buf_len) const;
+};
+
+/// 每线程一个的计数器槽位
+struct ObThaiStatsSlot
+{
+  std::atomic<uint64_t> values_[OB_THAI_STAT_MAX];
+
+  ObThaiStatsSlot()
+  {
+    for (int i = 0; i < OB_THAI_STAT_MAX; i++) {
+      values_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+};
+
+/**
+ * @brief Per thread tokenizer counters, aggregated on read.
+ * @details Every thread owns one slot and is the only writer of it, so the
+ * hot path is a relaxed load and store without any lock or atomic RMW.
+ */
+class ObThaiStats final
+{
+public:
+  static ObThaiStats &instance();
+
+  void record_doc(ObThaiPath path, int64_t bytes, int64_t tokens, int64_t ns)
+  {
+    ObThaiStatsSlot *slot = ObThaiThreadSlots<ObThaiStatsSlot>::local();
+    if (THAI_LIKELY(nullptr != slot)) {
+      thai_counter_add(slot->values_[OB_THAI_STAT_DOCS + path], 1);
+      thai_counter_add(slot->values_[OB_THAI_STAT_BYTES + path], (uint64_t)bytes);
+      thai_counter_add(slot->values_[OB_THAI_STAT_TOKENS + path], (uint64_t)tokens);
+      thai_counter_add(slot->values_[OB_THAI_STAT_NS + path], (uint64_t)ns);
+    }
+  }
+  void record_fallback(ObThaiFallbackReason reason) { add(OB_THAI_STAT_FALLBACK + reason, 1); }
+  void record_truncation(ObThaiTruncation type) { add(OB_THAI_STAT_TRUNC + type, 1); }
+  void record_shadow(ObThaiShadowStat id, int64_t delta) { add(OB_THAI_STAT_SHADOW + id, (uint64_t)delta); }
+
+  void snapshot(ObThaiStatsSnapshot &snap) const;
+
+  /**
+   * 周期汇总：到期时只有一个调用者返回 true，由它负责打印
+   * @param interval_sec 0 表示关闭
+   */
+  bool report_due(int64_t interval_sec);
+
+private:
+  ObThaiStats() = default;
+  void add(int id, uint64_t delta)
+  {
+    ObThaiStatsSlot *slot = ObThaiThreadSlots<ObThaiStatsSlot>::local();
+    if (THAI_LIKELY(nullptr != slot)) {
+      thai_counter_add(slot->values_[id], delta);
+    }
+  }
+
+  std::atomic<int64_t> next_report_ns_{0};
+};
+
+} // namespace thai
+} // namespace oceanbase
+
+/**
+ * Queryable snapshot for tools and debuggers, e.g.
+ * `call thai_ftparser_stats_snapshot(buf, 4096)` in gdb.
+ * @return bytes written, excluding the trailing '\0'
+ */
+THAI_EXPORT int64_t thai_ftparser_stats_snapshot(char *buf, int64_t buf_len);
+
+#endif // OB_THAI_FTPARSER_STATS_H_
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "thai_ftparser_tcc.h"
+
+namespace oceanbase {
+namespace thai {
+
+namespace {
+
+// 泰文字符在 TCC 规则中的类别
+enum ThaiCharClass
+{
+  THAI_CLASS_OTHER = 0,      // 非泰文或独立字符(数字、ฯ、ๆ 等)
+  THAI_CLASS_CONSONANT,      // ก..ฮ
+  THAI_CLASS_LEADING,        // เ แ โ ใ ไ
+  THAI_CLASS_FOLLOWING,      // ะ า ำ ๅ
+  THAI_CLASS_MARK,           // 上下元音与声调符号
+  THAI_CLASS_KARAN,          // ์ 不发音符号
+};
+
+inline int thai_code_point(const char *p)
+{
+  return 0x0E00 + (((unsigned char)p[1] - 0xB8) << 6) + ((unsigned char)p[2] & 0x3F);
+}
+
+inline ThaiCharClass thai_char_class(const char *p, const char *end)
+{
+  ThaiCharClass cls = THAI_CLASS_OTHER;
+  if (thai_is_thai_char(p, end)) {
+    const int cp = thai_code_point(p);
+    if (cp >= 0x0E01 && cp <= 0x0E2E) {
+      cls = THAI_CLASS_CONSONANT;
+    } else if (cp >= 0x0E40 && cp <= 0x0E44) {
+      cls = THAI_CLASS_LEADING;
+    } else if (0x0E30 == cp || 0x0E32 == cp || 0x0E33 == cp || 0x0E45 == cp) {
+      cls = THAI_CLASS_FOLLOWING;
+    } else if (0x0E4C == cp) {
+      cls = THAI_CLASS_KARAN;
+    } else if (0x0E31 == cp || (cp >= 0x0E34 && cp <= 0x0E3A) || (cp >= 0x0E47 && cp <= 0x0E4E)) {
+      cls = THAI_CLASS_MARK;
+    }
+  }
+  return cls;
+}
+
+} // namespace
+
+int64_t thai_utf8_char_len(const char *p, const char *end)
+{
+  const unsigned char c = (unsigned char)*p;
+  int64_t len = 1;
+  if (c >= 0xF0 && c < 0xF8) {
+    len = 4;
+  } else if (c >= 0xE0) {
+    len = c < 0xF0 ? 3 : 1;
+  } else if (c >= 0xC0) {
+    len = 2;
+  }
+  return len <= end - p ? len : 1;
+}
+
+int64_t thai_tcc_next(const char *p, const char *end)
+{
+  if (p >= end) {
+    return 0;
+  }
+  const char *cur = p;
+  ThaiCharClass cls = thai_char_class(cur, end);
+  if (THAI_CLASS_OTHER == cls) {
+    return thai_utf8_char_len(cur, end);
+  }
+  // 前置元音和它修饰的辅音不可分
+  while (THAI_CLASS_LEADING == cls) {
+    cur += 3;
+    cls = thai_char_class(cur, end);
+  }
+  if (THAI_CLASS_CONSONANT == cls || cur == p) {
+    cur += 3;
+  }
+  // 上下元音、声调和后置元音附着在辅音上
+  for (cls = thai_char_class(cur, end);
+       THAI_CLASS_MARK == cls || THAI_CLASS_FOLLOWING == cls || THAI_CLASS_KARAN == cls;
+       cls = thai_char_class(cur, end)) {
+    cur += 3;
+  }
+  // 后面跟着 ์ 的辅音不发音，并入当前簇
+  if (THAI_CLASS_CONSONANT == cls) {
+    const char *look = cur + 3;
+    ThaiCharClass next_cls = thai_char_class(look, end);
+    while (THAI_CLASS_MARK == next_cls) {
+      look += 3;
+      next_cls = thai_char_class(look, end);
+    }
+    if (THAI_CLASS_KARAN == next_cls) {
+      cur = look + 3;
+    }
+  }
+  return cur - p;
+}
+
+bool ObThaiTccTokenizer::next(const char *&word, int64_t &word_len)
+{
+  while (next_ < end_ && (' ' == *next_ || '\t' == *next_ || '\n' == *next_)) {
+    next_++;
+  }
+  if (next_ >= end_) {
+    return false;
+  }
+  const char *start = next_;
+  if (thai_is_thai_char(next_, end_)) {
+    next_ += thai_tcc_next(next_, end_);
+  } else {
+    while (next_ < end_ && ' ' != *next_ && '\t' != *next_ && '\n' != *next_
+           && !thai_is_thai_char(next_, end_)) {
+      next_ += thai_utf8_char_len(next_, end_);
+    }
+  }
+  word = start;
+  word_len = next_ - start;
+  return true;
+}
+
+} // namespace thai
+} // namespace oceanbase
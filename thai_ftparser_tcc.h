@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_TCC_H_
+#define OB_THAI_FTPARSER_TCC_H_
+
+#include <stdint.h>
+
+#include "thai_ftparser_common.h"
+
+namespace oceanbase {
+namespace thai {
+
+/**
+ * @brief Thai Character Cluster (TCC) segmentation.
+ * @details A TCC is the smallest unit that can never be split by a word
+ * boundary: leading vowels, the consonant they belong to, its above/below
+ * marks and following vowels, and a silent final consonant (thanthakhat).
+ * The rules here are the common simplified set; they need no dictionary
+ * and no allocation and run in a single forward pass.
+ */
+
+/// UTF-8 编码的泰文字符(U+0E00..U+0E7F)
+inline bool thai_is_thai_char(const char *p, const char *end)
+{
+  return end - p >= 3 && (unsigned char)p[0] == 0xE0
+      && ((unsigned char)p[1] == 0xB8 || (unsigned char)p[1] == 0xB9);
+}
+
+/// 按 UTF-8 首字节得到字符长度，非法或截断的序列按 1 字节处理
+int64_t thai_utf8_char_len(const char *p, const char *end);
+
+/**
+ * @return byte length of the cluster starting at p, >= 1 if p < end. A
+ * non-Thai character is a cluster of its own.
+ */
+int64_t thai_tcc_next(const char *p, const char *end);
+
+/**
+ * @brief Streams tokens out of a text without allocating.
+ * @details Whitespace (' ', '\t', '\n', as in the space tokenizer) separates
+ * tokens. A run of Thai text yields one token per cluster, any other run
+ * yields one token.
+ */
+class ObThaiTccTokenizer final
+{
+public:
+  void reset(const char *begin, const char *end)
+  {
+    next_ = begin;
+    end_ = end;
+  }
+  /// @return false once the text is exhausted
+  bool next(const char *&word, int64_t &word_len);
+
+private:
+  const char *next_ = nullptr;
+  const char *end_ = nullptr;
+};
+
+} // namespace thai
+} // namespace oceanbase
+
+#endif // OB_THAI_FTPARSER_TCC_H_
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_TLS_H_
+#define OB_THAI_FTPARSER_TLS_H_
+
+#include <atomic>
+#include <new>
+
+#include "thai_ftparser_common.h"
+#include "thai_ftparser_memory.h"
+
+namespace oceanbase {
+namespace thai {
+
+/**
+ * @brief One T per thread, reachable by a reader walking all of them.
+ * @details The owning thread is the only writer of its T, so T is expected
+ * to hold relaxed atomics updated by load+store. Slots are never freed:
+ * when a thread exits its slot, with everything it accumulated, is handed
+ * to the next new thread. T must be default constructible into a zero
+ * state. Slots are accounted under OB_THAI_MEM_THREAD_SLOTS.
+ */
+template <typename T>
+class ObThaiThreadSlots final
+{
+public:
+  /// 当前线程的槽位，内存不足时返回 nullptr
+  static T *local()
+  {
+    Node *node = guard_.node_;
+    return THAI_LIKELY(nullptr != node) ? &node->data_ : acquire();
+  }
+
+  /// 遍历所有槽位，fn(const T &data, bool in_use)
+  template <typename Fn>
+  static void for_each(Fn fn)
+  {
+    for (Node *n = head_.load(std::memory_order_acquire); nullptr != n; n = n->next_) {
+      fn(const_cast<const T &>(n->data_), n->in_use_.load(std::memory_order_relaxed));
+    }
+  }
+
+private:
+  struct Node
+  {
+    T                 data_{};
+    std::atomic<bool> in_use_{true};
+    Node *            next_ = nullptr;
+  };
+  struct Guard
+  {
+    Node *node_ = nullptr;
+    ~Guard()
+    {
+      if (nullptr != node_) {
+        node_->in_use_.store(false, std::memory_order_release);
+        node_ = nullptr;
+      }
+    }
+  };
+
+  static T *acquire()
+  {
+    Node *node = nullptr;
+    // 优先复用已退出线程的槽位
+    for (Node *n = head_.load(std::memory_order_acquire); nullptr != n && nullptr == node; n = n->next_) {
+      bool expected = false;
+      if (!n->in_use_.load(std::memory_order_relaxed)
+          && n->in_use_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        node = n;
+      }
+    }
+    if (nullptr == node) {
+      void *buf = thai_malloc(sizeof(Node), OB_THAI_MEM_THREAD_SLOTS);
+      node = nullptr != buf ? new (buf) Node : nullptr;
+      if (nullptr != node) {
+        // 只增不删，无锁头插
+        Node *head = head_.load(std::memory_order_relaxed);
+        do {
+          node->next_ = head;
+        } while (!head_.compare_exchange_weak(head, node, std::memory_order_release,
+                                              std::memory_order_relaxed));
+      }
+    }
+    guard_.node_ = node;
+    return nullptr != node ? &node->data_ : nullptr;
+  }
+
+  static std::atomic<Node *> head_;
+  static thread_local Guard guard_;
+};
+
+template <typename T>
+std::atomic<typename ObThaiThreadSlots<T>::Node *> ObThaiThreadSlots<T>::head_{nullptr};
+
+template <typename T>
+thread_local typename ObThaiThreadSlots<T>::Guard ObThaiThreadSlots<T>::guard_;
+
+/// 单写者计数器累加，不需要原子 RMW
+inline void thai_counter_add(std::atomic<uint64_t> &counter, uint64_t delta)
+{
+  counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+} // namespace thai
+} // namespace oceanbase
+
+#endif // OB_THAI_FTPARSER_TLS_H_
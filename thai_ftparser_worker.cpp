@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "thai_ftparser_worker.h"
+
+#include <atomic>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace oceanbase {
+namespace thai {
+
+namespace {
+
+// 每个线程一条到外部进程的连接，线程退出时关闭
+struct WorkerConnection
+{
+  int fd_ = -1;
+  ~WorkerConnection() { reset(); }
+  void reset()
+  {
+    if (fd_ >= 0) {
+      close(fd_);
+      fd_ = -1;
+    }
+  }
+};
+
+thread_local WorkerConnection t_connection;
+
+// 熔断状态，全节点共享：连续超时次数，熔断到期时间(0 表示未熔断)
+std::atomic<int64_t> g_worker_timeouts{0};
+std::atomic<int64_t> g_worker_open_until_ns{0};
+
+bool breaker_allows(const ObThaiConfig &config)
+{
+  int64_t until = g_worker_open_until_ns.load(std::memory_order_relaxed);
+  if (0 == until) {
+    return true;
+  }
+  const int64_t now = thai_monotonic_ns();
+  // 到期后只放一篇文档去试探，试探期间其余文档继续跳过
+  return now >= until
+      && g_worker_open_until_ns.compare_exchange_strong(
+          until, now + config.worker_breaker_sec_ * 1000000000LL, std::memory_order_relaxed);
+}
+
+void breaker_record(const ObThaiConfig &config, int ret)
+{
+  if (0 == ret) {
+    if (0 != g_worker_timeouts.load(std::memory_order_relaxed)) {
+      g_worker_timeouts.store(0, std::memory_order_relaxed);
+    }
+    if (0 != g_worker_open_until_ns.load(std::memory_order_relaxed)) {
+      g_worker_open_until_ns.store(0, std::memory_order_relaxed);
+    }
+  } else if (ETIMEDOUT == ret && config.worker_breaker_timeouts_ > 0
+             && g_worker_timeouts.fetch_add(1, std::memory_order_relaxed) + 1 >= config.worker_breaker_timeouts_) {
+    g_worker_open_until_ns.store(thai_monotonic_ns() + config.worker_breaker_sec_ * 1000000000LL,
+                                 std::memory_order_relaxed);
+  }
+}
+
+int connect_worker(const char *path, int &fd)
+{
+  int ret = 0;
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    ret = ENAMETOOLONG;
+  } else if ((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0)) < 0) {
+    ret = errno;
+  } else {
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    // Unix socket 的 connect 不会进行中，backlog 满时直接失败
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+      ret = errno;
+      close(fd);
+      fd = -1;
+    }
+  }
+  return ret;
+}
+
+int wait_io(int fd, short events, int64_t deadline_ns)
+{
+  const int64_t left_ns = deadline_ns - thai_monotonic_ns();
+  if (left_ns <= 0) {
+    return ETIMEDOUT;
+  }
+  struct pollfd pfd;
+  pfd.fd = fd;
+  pfd.events = events;
+  pfd.revents = 0;
+  const int n = poll(&pfd, 1, (int)((left_ns + 999999) / 1000000));
+  return n > 0 ? 0 : (0 == n ? ETIMEDOUT : (EINTR == errno ? 0 : errno));
+}
+
+int send_all(int fd, const char *p, int64_t len, int64_t deadline_ns)
+{
+  int ret = 0;
+  while (0 == ret && len > 0) {
+    const ssize_t n = send(fd, p, (size_t)len, MSG_NOSIGNAL);
+    if (n > 0) {
+      p += n;
+      len -= n;
+    } else if (n < 0 && (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno)) {
+      ret = wait_io(fd, POLLOUT, deadline_ns);
+    } else {
+      ret = n < 0 ? errno : EPIPE;
+    }
+  }
+  return ret;
+}
+
+int recv_all(int fd, char *p, int64_t len, int64_t deadline_ns)
+{
+  int ret = 0;
+  while (0 == ret && len > 0) {
+    const ssize_t n = recv(fd, p, (size_t)len, 0);
+    if (n > 0) {
+      p += n;
+      len -= n;
+    } else if (n < 0 && (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno)) {
+      ret = wait_io(fd, POLLIN, deadline_ns);
+    } else {
+      // 对端关闭
+      ret = n < 0 ? errno : ECONNRESET;
+    }
+  }
+  return ret;
+}
+
+void encode_u32(char *buf, uint32_t v)
+{
+  for (int i = 0; i < 4; i++) {
+    buf[i] = (char)((v >> (8 * i)) & 0xFF);
+  }
+}
+
+uint32_t decode_u32(const char *buf)
+{
+  uint32_t v = 0;
+  for (int i = 0; i < 4; i++) {
+    v |= (uint32_t)(unsigned char)buf[i] << (8 * i);
+  }
+  return v;
+}
+
+} // namespace
+
+int ObThaiWorkerSegmenter::exchange(int fd, const char *text, int64_t len, int64_t deadline_ns)
+{
+  char header[4];
+  encode_u32(header, (uint32_t)len);
+  int ret = send_all(fd, header, sizeof(header), deadline_ns);
+  if (0 == ret) {
+    ret = send_all(fd, text, len, deadline_ns);
+  }
+  if (0 == ret) {
+    ret = recv_all(fd, header, sizeof(header), deadline_ns);
+  }
+  if (0 == ret) {
+    const int64_t resp_len = decode_u32(header);
+    if (resp_len > len * WORKER_MAX_RESPONSE_FACTOR + WORKER_MAX_RESPONSE_SLACK) {
+      ret = EMSGSIZE;
+    } else if (resp_len > 0) {
+      buf_ = (char *)thai_malloc(resp_len, OB_THAI_MEM_TOKEN_ARENA);
+      if (nullptr == buf_) {
+        ret = ENOMEM;
+      } else {
+        buf_len_ = resp_len;
+        ret = recv_all(fd, buf_, resp_len, deadline_ns);
+      }
+    }
+  }
+  return ret;
+}
+
+bool ObThaiWorkerSegmenter::begin_document(const ObThaiSegmentParam &param)
+{
+  end_document();
+  const ObThaiConfig &config = ObThaiConfig::instance();
+  const int64_t len = param.end_ - param.begin_;
+  int ret = 0;
+  if (config.worker_socket_path_.empty() || len > (int64_t)UINT32_MAX) {
+    ret = EINVAL;
+  } else if (!breaker_allows(config)) {
+    ObThaiStats::instance().record_fallback(OB_THAI_FALLBACK_WORKER_BREAKER);
+    return false;
+  } else {
+    const int64_t deadline_ns = thai_monotonic_ns() + config.worker_timeout_ms_ * 1000000LL;
+    WorkerConnection &conn = t_connection;
+    for (int attempt = 0; attempt < 2; attempt++) {
+      const bool reused = conn.fd_ >= 0;
+      if (!reused && 0 != (ret = connect_worker(config.worker_socket_path_.c_str(), conn.fd_))) {
+        break;
+      }
+      if (0 == (ret = exchange(conn.fd_, param.begin_, len, deadline_ns))) {
+        break;
+      }
+      // 出错后连接上可能还有半个应答，不能再用
+      conn.reset();
+      end_document();
+      // 只有复用的空闲连接可能已被对端关闭，值得重连一次
+      if (!reused || ETIMEDOUT == ret) {
+        break;
+      }
+    }
+    breaker_record(config, ret);
+  }
+  if (0 != ret) {
+    ObThaiStats::instance().record_fallback(OB_THAI_FALLBACK_WORKER);
+    return false;
+  }
+  next_ = buf_;
+  end_ = buf_ + buf_len_;
+  return true;
+}
+
+bool ObThaiWorkerSegmenter::next(const char *&word, int64_t &word_len)
+{
+  while (next_ < end_) {
+    const char *eol = (const char *)memchr(next_, '\n', end_ - next_);
+    eol = nullptr != eol ? eol : end_;
+    word = next_;
+    word_len = eol - next_;
+    next_ = eol < end_ ? eol + 1 : end_;
+    if (word_len > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ObThaiWorkerSegmenter::end_document()
+{
+  if (nullptr != buf_) {
+    thai_free(buf_);
+  }
+  buf_ = nullptr;
+  buf_len_ = 0;
+  next_ = nullptr;
+  end_ = nullptr;
+}
+
+} // namespace thai
+} // namespace oceanbase
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_THAI_FTPARSER_WORKER_H_
+#define OB_THAI_FTPARSER_WORKER_H_
+
+#include <stdint.h>
+
+#include "thai_ftparser_segmenter.h"
+
+namespace oceanbase {
+namespace thai {
+
+/**
+ * @brief Hands each document to an external segmentation process.
+ * @details The process listens on OB_THAI_FTPARSER_WORKER_SOCKET (a Unix
+ * stream socket); tools/thai_segment_worker.py is a reference server.
+ * One request per document over a connection kept per thread:
+ *
+ *   request:  u32 little endian byte length, then the UTF-8 text
+ *   response: u32 little endian byte length, then the tokens joined by '\n'
+ *
+ * The whole exchange must finish within OB_THAI_FTPARSER_WORKER_TIMEOUT_MS
+ * and the response may be at most WORKER_MAX_RESPONSE_FACTOR times the
+ * request plus WORKER_MAX_RESPONSE_SLACK bytes. Otherwise the connection is
+ * dropped and the document falls back to space segmentation, so a hung or
+ * crashed worker costs at most one timeout per document and never blocks
+ * the observer. A connection the worker closed while idle is retried once.
+ *
+ * A worker that accepts but never answers would still cost every document
+ * on every thread a full timeout. After OB_THAI_FTPARSER_WORKER_BREAKER_TIMEOUTS
+ * consecutive timeouts, node wide, the worker is skipped for
+ * OB_THAI_FTPARSER_WORKER_BREAKER_SEC seconds (fallback reason
+ * worker_breaker); then a single document probes it, and the breaker
+ * closes on the first answer or opens again on the next timeout.
+ */
+class ObThaiWorkerSegmenter final : public ObThaiSegmenter
+{
+public:
+  static const int64_t WORKER_MAX_RESPONSE_FACTOR = 4;
+  static const int64_t WORKER_MAX_RESPONSE_SLACK = 4096;
+
+  ObThaiWorkerSegmenter() = default;
+  ~ObThaiWorkerSegmenter() override { end_document(); }
+  ObThaiWorkerSegmenter(const ObThaiWorkerSegmenter &) = delete;
+  ObThaiWorkerSegmenter &operator=(const ObThaiWorkerSegmenter &) = delete;
+
+  bool begin_document(const ObThaiSegmentParam &param) override;
+  bool next(const char *&word, int64_t &word_len) override;
+  void end_document() override;
+  int64_t allocated() const override { return nullptr != buf_ ? buf_len_ : 0; }
+  /// 应答缓冲区：token 加上分隔符，通常不超过原文的两倍
+  static int64_t projected_bytes(int64_t doc_bytes, bool windowed) { return doc_bytes * 2; }
+
+private:
+  /// 在已连接的 fd 上完成一次请求应答。@return 0 or errno
+  int exchange(int fd, const char *text, int64_t len, int64_t deadline_ns);
+
+  char *      buf_ = nullptr;      // 应答正文，token 指向这里
+  int64_t     buf_len_ = 0;
+  const char *next_ = nullptr;
+  const char *end_ = nullptr;
+};
+
+} // namespace thai
+} // namespace oceanbase
+
+#endif // OB_THAI_FTPARSER_WORKER_H_
@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ob_plugin_host.h"
+
+#include <atomic>
+#include <dlfcn.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace oceanbase::thai;
+
+namespace {
+
+std::atomic<int32_t> g_log_level(OBP_LOG_LEVEL_WARN);
+
+const char *LOG_LEVEL_NAMES[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR"};
+
+// 与 observer 的 utf8mb4 一致的部分：ASCII 分类；多字节字符除空白和标点块外都算字母
+struct ObHostCharset
+{
+  const char *name_;
+} g_utf8mb4 = {"utf8mb4"};
+
+int utf8_decode(const unsigned char *s, const unsigned char *e, uint32_t &wc)
+{
+  int len = 0;
+  const unsigned char c = s[0];
+  if (c < 0x80) {
+    wc = c;
+    len = 1;
+  } else if (c >= 0xC2 && c < 0xE0) {
+    len = 2;
+    wc = c & 0x1F;
+  } else if (c >= 0xE0 && c < 0xF0) {
+    len = 3;
+    wc = c & 0x0F;
+  } else if (c >= 0xF0 && c < 0xF5) {
+    len = 4;
+    wc = c & 0x07;
+  }
+  if (len > 1) {
+    if (e - s < len) {
+      len = 0;
+    } else {
+      for (int i = 1; i < len && len > 0; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+          len = 0;
+        } else {
+          wc = (wc << 6) | (s[i] & 0x3F);
+        }
+      }
+    }
+  }
+  return len;
+}
+
+bool is_unicode_space_or_punct(uint32_t wc)
+{
+  return wc == 0x00A0
+      || (wc >= 0x2000 && wc <= 0x206F)      // 通用标点
+      || (wc >= 0x3000 && wc <= 0x303F)      // CJK 标点
+      || (wc >= 0xFF00 && wc <= 0xFF0F)      // 全角标点
+      || wc == 0x0E2F || wc == 0x0E46 || wc == 0x0E4F || wc == 0x0E5A || wc == 0x0E5B;  // 泰文标点
+}
+
+} // namespace
+
+extern "C" {
+
+int obp_log_enabled(int32_t level)
+{
+  return level >= g_log_level.load(std::memory_order_relaxed) ? OBP_SUCCESS : OBP_PLUGIN_ERROR;
+}
+
+void obp_log_format(int32_t level, const char *filename, int32_t lineno, const char *location_string,
+                    int64_t location_string_size, const char *function, const char *format, ...)
+{
+  char buf[4096];
+  va_list ap;
+  va_start(ap, format);
+  vsnprintf(buf, sizeof(buf), format, ap);
+  va_end(ap);
+  const char *level_name = (level >= 0 && level <= OBP_LOG_LEVEL_ERROR) ? LOG_LEVEL_NAMES[level] : "?";
+  const char *base = strrchr(filename, '/');
+  fprintf(stderr, "[%s] %s:%d %s: %s\n", level_name, nullptr != base ? base + 1 : filename, lineno, function, buf);
+}
+
+const char *obp_ftparser_fulltext(ObPluginFTParserParamPtr param)
+{
+  return nullptr == param ? nullptr : ((ObHostFTParserParam *)param)->fulltext_;
+}
+
+int64_t obp_ftparser_fulltext_length(ObPluginFTParserParamPtr param)
+{
+  return nullptr == param ? 0 : ((ObHostFTParserParam *)param)->length_;
+}
+
+ObPluginCharsetInfoPtr obp_ftparser_charset_info(ObPluginFTParserParamPtr param)
+{
+  return nullptr == param ? nullptr : (ObPluginCharsetInfoPtr)((ObHostFTParserParam *)param)->charset_;
+}
+
+ObPluginDatum obp_ftparser_user_data(ObPluginFTParserParamPtr param)
+{
+  return nullptr == param ? nullptr : (ObPluginDatum)((ObHostFTParserParam *)param)->user_data_;
+}
+
+void obp_ftparser_set_user_data(ObPluginFTParserParamPtr param, ObPluginDatum user_data)
+{
+  if (nullptr != param) {
+    ((ObHostFTParserParam *)param)->user_data_ = (void *)user_data;
+  }
+}
+
+int obp_charset_ctype(ObPluginCharsetInfoPtr cs, int *ctype, const unsigned char *s, const unsigned char *e)
+{
+  int len = 0;
+  *ctype = 0;
+  if (nullptr != s && s < e) {
+    uint32_t wc = 0;
+    len = utf8_decode(s, e, wc);
+    if (1 == len) {
+      if (wc >= 'A' && wc <= 'Z') {
+        *ctype = OBP_CHAR_TYPE_UPPER;
+      } else if (wc >= 'a' && wc <= 'z') {
+        *ctype = OBP_CHAR_TYPE_LOWER;
+      } else if (wc >= '0' && wc <= '9') {
+        *ctype = OBP_CHAR_TYPE_NUMBER;
+      } else if (' ' == wc || (wc >= '\t' && wc <= '\r')) {
+        *ctype = OBP_CHAR_TYPE_SPACE;
+      }
+    } else if (len > 1) {
+      *ctype = is_unicode_space_or_punct(wc) ? 0 : OBP_CHAR_TYPE_LOWER;
+    }
+  }
+  return len;
+}
+
+int obp_register_plugin(ObPluginParamPtr param, ObPluginType type, const char *name, ObPluginVersion version,
+                        void *desc, int64_t desc_sizeof, const char *description)
+{
+  int ret = OBP_SUCCESS;
+  if (nullptr == param || nullptr == name || nullptr == desc) {
+    ret = OBP_INVALID_ARGUMENT;
+  } else if (OBP_PLUGIN_TYPE_FT_PARSER != type) {
+    fprintf(stderr, "plugin host: ignore plugin %s of unsupported type %d\n", name, (int)type);
+  } else {
+    ret = ((ObPluginHost *)param)->register_parser(name, desc, desc_sizeof, description);
+  }
+  return ret;
+}
+
+} // extern "C"
+
+namespace {
+
+bool recv_exact(int fd, char *p, size_t len)
+{
+  while (len > 0) {
+    const ssize_t n = recv(fd, p, len, 0);
+    if (n <= 0 && !(n < 0 && EINTR == errno)) {
+      return false;
+    }
+    if (n > 0) {
+      p += n;
+      len -= (size_t)n;
+    }
+  }
+  return true;
+}
+
+// 协议见 thai_ftparser_worker.h：读完请求，回一个长度为 0 的应答
+void serve_empty_connection(int fd)
+{
+  char header[4];
+  char buf[65536];
+  bool ok = true;
+  while (ok && recv_exact(fd, header, sizeof(header))) {
+    uint32_t len = (uint32_t)(unsigned char)header[0] | (uint32_t)(unsigned char)header[1] << 8
+                   | (uint32_t)(unsigned char)header[2] << 16 | (uint32_t)(unsigned char)header[3] << 24;
+    while (ok && len > 0) {
+      const size_t n = len < sizeof(buf) ? len : sizeof(buf);
+      ok = recv_exact(fd, buf, n);
+      len -= (uint32_t)n;
+    }
+    const char empty[4] = {0, 0, 0, 0};
+    ok = ok && sizeof(empty) == send(fd, empty, sizeof(empty), MSG_NOSIGNAL);
+  }
+  close(fd);
+}
+
+void serve_empty_worker(int listen_fd)
+{
+  while (true) {
+    const int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd >= 0) {
+      std::thread(serve_empty_connection, fd).detach();
+    } else if (EINTR != errno && ECONNABORTED != errno) {
+      break;
+    }
+  }
+}
+
+} // namespace
+
+namespace oceanbase {
+namespace thai {
+
+void *host_charset()
+{
+  return &g_utf8mb4;
+}
+
+ObHostEmptyWorker::~ObHostEmptyWorker()
+{
+  if (!path_.empty()) {
+    unlink(path_.c_str());
+  }
+}
+
+int ObHostEmptyWorker::start()
+{
+  int ret = 0;
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/ob_plugin_host.%d.sock", (int)getpid());
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  unlink(path);
+  if (fd < 0) {
+    ret = errno;
+  } else if (0 != bind(fd, (struct sockaddr *)&addr, sizeof(addr)) || 0 != listen(fd, 64)) {
+    ret = errno;
+    close(fd);
+  } else {
+    path_ = path;
+    setenv("OB_THAI_FTPARSER_ENGINE", "worker", 1);
+    setenv("OB_THAI_FTPARSER_WORKER_SOCKET", path, 1);
+    std::thread(serve_empty_worker, fd).detach();
+  }
+  return ret;
+}
+
+void ObPluginHost::set_log_level(int32_t level)
+{
+  g_log_level.store(level, std::memory_order_relaxed);
+}
+
+int32_t ObPluginHost::log_level()
+{
+  return g_log_level.load(std::memory_order_relaxed);
+}
+
+int ObPluginHost::load(const char *path)
+{
+  int ret = OBP_SUCCESS;
+  bool inited = false;
+  // RTLD_GLOBAL：插件内嵌的解释器加载 C 扩展模块时需要解析到 libpython 的符号
+  if (nullptr != handle_) {
+    ret = OBP_INIT_TWICE;
+  } else if (nullptr == (handle_ = dlopen(path, RTLD_NOW | RTLD_GLOBAL))) {
+    fprintf(stderr, "plugin host: dlopen %s failed: %s\n", path, dlerror());
+    ret = OBP_PLUGIN_ERROR;
+  } else {
+    const int64_t *api_version = (const int64_t *)dlsym(handle_, OBP_STRINGIZE(OBP_DYNAMIC_PLUGIN_API_VERSION_VAR));
+    const int64_t *plugin_size = (const int64_t *)dlsym(handle_, OBP_STRINGIZE(OBP_DYNAMIC_PLUGIN_SIZEOF_VAR));
+    plugin_ = (const ObPlugin *)dlsym(handle_, OBP_STRINGIZE(OBP_DYNAMIC_PLUGIN_PLUGIN_VAR));
+    if (nullptr == plugin_) {
+      fprintf(stderr, "plugin host: %s does not declare a plugin: %s\n", path, dlerror());
+      ret = OBP_PLUGIN_ERROR;
+    } else if (nullptr != api_version && *api_version > OBP_PLUGIN_API_VERSION_CURRENT) {
+      fprintf(stderr, "plugin host: %s needs plugin API %ld, host has %d\n",
+              path, *api_version, OBP_PLUGIN_API_VERSION_CURRENT);
+      ret = OBP_PLUGIN_ERROR;
+    } else if (nullptr != plugin_size && *plugin_size < (int64_t)sizeof(ObPlugin)) {
+      fprintf(stderr, "plugin host: %s declares a %ld byte plugin, expected %zu\n",
+              path, *plugin_size, sizeof(ObPlugin));
+      ret = OBP_PLUGIN_ERROR;
+    } else if (nullptr != plugin_->init && OBP_SUCCESS != (ret = plugin_->init(this))) {
+      fprintf(stderr, "plugin host: init of %s failed, ret=%d\n", path, ret);
+    } else {
+      inited = true;
+      if (parsers_.empty()) {
+        fprintf(stderr, "plugin host: %s registered no ftparser\n", path);
+        ret = OBP_PLUGIN_ERROR;
+      }
+    }
+    if (OBP_SUCCESS != ret) {
+      parsers_.clear();
+      if (inited && nullptr != plugin_->deinit) {
+        plugin_->deinit(this);
+      }
+      plugin_ = nullptr;
+      dlclose(handle_);
+      handle_ = nullptr;
+    }
+  }
+  return ret;
+}
+
+void ObPluginHost::unload()
+{
+  if (nullptr != handle_) {
+    if (nullptr != plugin_ && nullptr != plugin_->deinit) {
+      plugin_->deinit(this);
+    }
+    parsers_.clear();
+    plugin_ = nullptr;
+    dlclose(handle_);
+    handle_ = nullptr;
+  }
+}
+
+void *ObPluginHost::symbol(const char *name) const
+{
+  return nullptr != handle_ ? dlsym(handle_, name) : nullptr;
+}
+
+const ObPluginFTParser *ObPluginHost::parser(const char *name) const
+{
+  const ObPluginFTParser *found = nullptr;
+  for (size_t i = 0; i < parsers_.size() && nullptr == found; i++) {
+    if (nullptr == name || '\0' == *name || parsers_[i].name_ == name) {
+      found = &parsers_[i].desc_;
+    }
+  }
+  return found;
+}
+
+int ObPluginHost::register_parser(const char *name, const void *desc, int64_t desc_size, const char *description)
+{
+  int ret = OBP_SUCCESS;
+  Parser parser;
+  memset(&parser.desc_, 0, sizeof(parser.desc_));
+  // 插件可能按更旧的接口编译，只拷贝双方都认识的部分
+  memcpy(&parser.desc_, desc, desc_size < (int64_t)sizeof(parser.desc_) ? desc_size : sizeof(parser.desc_));
+  if (nullptr == parser.desc_.scan_begin || nullptr == parser.desc_.scan_end || nullptr == parser.desc_.next_token) {
+    fprintf(stderr, "plugin host: ftparser %s misses scan callbacks\n", name);
+    ret = OBP_INVALID_ARGUMENT;
+  } else if (nullptr != this->parser(name) && '\0' != *name) {
+    fprintf(stderr, "plugin host: ftparser %s registered twice\n", name);
+    ret = OBP_INIT_TWICE;
+  } else {
+    parser.name_ = name;
+    parser.description_ = nullptr != description ? description : "";
+    parsers_.push_back(parser);
+  }
+  return ret;
+}
+
+int ObHostScanner::count(const char *text, int64_t len, int64_t &tokens) const
+{
+  tokens = 0;
+  return scan(text, len, [&tokens](const char *, int64_t, int64_t, int64_t) { tokens++; });
+}
+
+bool host_read_file(const char *path, std::string &content)
+{
+  bool ok = false;
+  FILE *fp = (0 == strcmp(path, "-")) ? stdin : fopen(path, "rb");
+  if (nullptr != fp) {
+    char buf[65536];
+    size_t n = 0;
+    content.clear();
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+      content.append(buf, n);
+    }
+    ok = !ferror(fp);
+    if (stdin != fp) {
+      fclose(fp);
+    }
+  }
+  return ok;
+}
+
+void host_split_lines(const std::string &content, std::vector<std::pair<const char *, int64_t>> &docs)
+{
+  const char *p = content.data();
+  const char *end = p + content.size();
+  while (p < end) {
+    const char *nl = (const char *)memchr(p, '\n', end - p);
+    const char *line_end = nullptr != nl ? nl : end;
+    if (line_end > p) {
+      docs.push_back(std::make_pair(p, (int64_t)(line_end - p)));
+    }
+    p = nullptr != nl ? nl + 1 : end;
+  }
+}
+
+} // namespace thai
+} // namespace oceanbase
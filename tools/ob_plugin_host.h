@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef OB_PLUGIN_HOST_H_
+#define OB_PLUGIN_HOST_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "oceanbase/ob_plugin_ftparser.h"
+
+/**
+ * @defgroup ObPluginHost Standalone host of ftparser plugins
+ * @brief Implements the host side of the plugin API (obp_ftparser_*,
+ * obp_charset_ctype, obp_log_*) so a plugin .so can be loaded and driven
+ * outside the observer.
+ * @details The host executable must export its symbols (-rdynamic) because
+ * the plugin resolves the host API against the process that loads it.
+ * The charset is a utf8mb4 approximation: ASCII is classified exactly, any
+ * other well formed character counts as a letter except spaces and
+ * punctuation blocks.
+ * @{
+ */
+
+namespace oceanbase {
+namespace thai {
+
+/// 一次扫描的参数，ObPluginFTParserParamPtr 指向它
+struct ObHostFTParserParam
+{
+  const char * fulltext_ = nullptr;
+  int64_t      length_ = 0;
+  void *       charset_ = nullptr;
+  void *       user_data_ = nullptr;
+};
+
+/**
+ * @brief Loads one plugin library and keeps the ftparsers it registers.
+ * @details Not copyable. Parsers stay valid until unload().
+ */
+class ObPluginHost final
+{
+public:
+  ObPluginHost() = default;
+  ~ObPluginHost() { unload(); }
+  ObPluginHost(const ObPluginHost &) = delete;
+  ObPluginHost &operator=(const ObPluginHost &) = delete;
+
+  /// dlopen the library and run its plugin init. @return OBP_SUCCESS or an OBP_* error
+  int load(const char *path);
+  /// run the plugin deinit and dlclose
+  void unload();
+
+  int64_t parser_count() const { return (int64_t)parsers_.size(); }
+  const char *parser_name(int64_t idx) const { return parsers_[idx].name_.c_str(); }
+  /// @param name nullptr or empty selects the first registered parser
+  const ObPluginFTParser *parser(const char *name) const;
+
+  /// 插件导出的其他符号，例如 thai_ftparser_stats_snapshot
+  void *symbol(const char *name) const;
+
+  /// 由 obp_register_plugin 回调
+  int register_parser(const char *name, const void *desc, int64_t desc_size, const char *description);
+
+  /// 插件日志的最低输出级别 (OBP_LOG_LEVEL_*)
+  static void set_log_level(int32_t level);
+  static int32_t log_level();
+
+private:
+  struct Parser
+  {
+    std::string      name_;
+    std::string      description_;
+    ObPluginFTParser desc_;
+  };
+
+  void *              handle_ = nullptr;
+  const ObPlugin *    plugin_ = nullptr;
+  std::vector<Parser> parsers_;
+};
+
+/**
+ * @brief Runs documents through one ftparser.
+ * @details Stateless apart from the parser pointer, so one scanner per
+ * thread or a shared one both work as long as the plugin is thread safe.
+ */
+class ObHostScanner final
+{
+public:
+  explicit ObHostScanner(const ObPluginFTParser *parser) : parser_(parser) {}
+
+  /**
+   * scan_begin, next_token until OBP_ITER_END, scan_end.
+   * @param fn called as fn(word, word_len, char_len, word_freq) per token
+   * @return OBP_SUCCESS or the first error returned by the plugin
+   */
+  template <typename Fn>
+  int scan(const char *text, int64_t len, Fn fn) const;
+
+  /// 只统计 token 数
+  int count(const char *text, int64_t len, int64_t &tokens) const;
+
+private:
+  const ObPluginFTParser *parser_;
+};
+
+/// host 使用的字符集句柄
+void *host_charset();
+
+/**
+ * @brief In-process worker that answers every document with no tokens.
+ * @details start() listens on a private socket and points
+ * OB_THAI_FTPARSER_ENGINE=worker at it, so it must run before the plugin
+ * is loaded. The parser then takes its charset fallback on every document,
+ * the path an engine that succeeds without tokens leads to. Each connection
+ * is served by its own detached thread until the process exits; the
+ * destructor only removes the socket file.
+ */
+class ObHostEmptyWorker final
+{
+public:
+  ObHostEmptyWorker() = default;
+  ~ObHostEmptyWorker();
+  ObHostEmptyWorker(const ObHostEmptyWorker &) = delete;
+  ObHostEmptyWorker &operator=(const ObHostEmptyWorker &) = delete;
+
+  /// @return 0 on success, otherwise an errno value
+  int start();
+
+private:
+  std::string path_;
+};
+
+template <typename Fn>
+int ObHostScanner::scan(const char *text, int64_t len, Fn fn) const
+{
+  ObHostFTParserParam param;
+  param.fulltext_ = text;
+  param.length_ = len;
+  param.charset_ = host_charset();
+  int ret = parser_->scan_begin(&param);
+  if (OBP_SUCCESS == ret) {
+    char *word = nullptr;
+    int64_t word_len = 0;
+    int64_t char_len = 0;
+    int64_t word_freq = 0;
+    while (OBP_SUCCESS == (ret = parser_->next_token(&param, &word, &word_len, &char_len, &word_freq))) {
+      fn(word, word_len, char_len, word_freq);
+    }
+    if (OBP_ITER_END == ret) {
+      ret = OBP_SUCCESS;
+    }
+    const int end_ret = parser_->scan_end(&param);
+    if (OBP_SUCCESS == ret) {
+      ret = end_ret;
+    }
+  }
+  return ret;
+}
+
+/// 读取整个文件，失败返回 false
+bool host_read_file(const char *path, std::string &content);
+
+/// 按行切分文档，跳过空行
+void host_split_lines(const std::string &content, std::vector<std::pair<const char *, int64_t>> &docs);
+
+} // namespace thai
+} // namespace oceanbase
+
+/** @} */
+
+#endif // OB_PLUGIN_HOST_H_
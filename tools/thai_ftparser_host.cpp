@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2025 OceanBase.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Drives an ftparser plugin over files without an observer.
+ *
+ *   thai_ftparser_host [-p parser] [-l level] [-L] [-c] [-r N] [-e] plugin.so [file ...]
+ *
+ * Each file (or each line with -L) is one document; "-" or no file reads
+ * stdin. Tokens of a document are printed on one line separated by tabs,
+ * -c prints the token count instead. -e routes every document to a worker
+ * that answers no tokens, so the parser's charset fallback scans them all.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ob_plugin_host.h"
+
+using namespace oceanbase::thai;
+
+static void usage(const char *prog)
+{
+  fprintf(stderr,
+          "usage: %s [options] plugin.so [file ...]\n"
+          "  -p name   ftparser to use, default the first one registered\n"
+          "  -l level  plugin log level: trace, debug, info, warn (default), error\n"
+          "  -L        every line is a document instead of every file\n"
+          "  -c        print the token count of each document instead of the tokens\n"
+          "  -r N      scan the input N times, output is printed for the first pass only\n"
+          "  -e        answer every document from a worker with no tokens, forcing the\n"
+          "            parser's charset fallback\n",
+          prog);
+}
+
+static int parse_log_level(const char *str)
+{
+  static const char *names[] = {"trace", "debug", "info", "warn", "error"};
+  int level = -1;
+  for (int i = 0; i < 5 && level < 0; i++) {
+    if (0 == strcmp(str, names[i])) {
+      level = i;
+    }
+  }
+  return level;
+}
+
+int main(int argc, char **argv)
+{
+  const char *parser_name = nullptr;
+  bool by_line = false;
+  bool count_only = false;
+  int64_t repeat = 1;
+  bool empty_worker = false;
+  int opt = 0;
+  while (-1 != (opt = getopt(argc, argv, "p:l:Lcr:eh"))) {
+    switch (opt) {
+      case 'p': parser_name = optarg; break;
+      case 'l': {
+        int level = parse_log_level(optarg);
+        if (level < 0) {
+          usage(argv[0]);
+          return 2;
+        }
+        ObPluginHost::set_log_level(level);
+        break;
+      }
+      case 'L': by_line = true; break;
+      case 'c': count_only = true; break;
+      case 'r': repeat = atoll(optarg) > 0 ? atoll(optarg) : 1; break;
+      case 'e': empty_worker = true; break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  if (optind >= argc) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  // 插件加载时读取配置，worker 必须先启动
+  ObHostEmptyWorker worker;
+  int err = empty_worker ? worker.start() : 0;
+  if (0 != err) {
+    fprintf(stderr, "failed to start the empty worker, errno=%d\n", err);
+    return 1;
+  }
+  ObPluginHost host;
+  if (OBP_SUCCESS != host.load(argv[optind])) {
+    return 1;
+  }
+  const ObPluginFTParser *parser = host.parser(parser_name);
+  if (nullptr == parser) {
+    fprintf(stderr, "no ftparser named %s, registered:", parser_name);
+    for (int64_t i = 0; i < host.parser_count(); i++) {
+      fprintf(stderr, " %s", host.parser_name(i));
+    }
+    fprintf(stderr, "\n");
+    return 1;
+  }
+
+  // 先读入全部输入，计时只覆盖扫描本身
+  std::vector<std::string> contents;
+  std::vector<std::pair<const char *, int64_t>> docs;
+  const int first_file = optind + 1;
+  const int file_count = argc > first_file ? argc - first_file : 1;
+  contents.resize(file_count);
+  for (int i = 0; i < file_count; i++) {
+    const char *path = argc > first_file ? argv[first_file + i] : "-";
+    if (!host_read_file(path, contents[i])) {
+      fprintf(stderr, "failed to read %s\n", path);
+      return 1;
+    }
+  }
+  for (int i = 0; i < file_count; i++) {
+    if (by_line) {
+      host_split_lines(contents[i], docs);
+    } else if (!contents[i].empty()) {
+      docs.push_back(std::make_pair(contents[i].data(), (int64_t)contents[i].size()));
+    }
+  }
+
+  ObHostScanner scanner(parser);
+  int64_t total_tokens = 0;
+  int64_t total_bytes = 0;
+  int64_t failed = 0;
+  timespec begin_ts;
+  clock_gettime(CLOCK_MONOTONIC, &begin_ts);
+  for (int64_t pass = 0; pass < repeat; pass++) {
+    const bool print = 0 == pass;
+    for (size_t d = 0; d < docs.size(); d++) {
+      int64_t tokens = 0;
+      int ret = scanner.scan(docs[d].first, docs[d].second,
+                             [&](const char *word, int64_t word_len, int64_t, int64_t) {
+                               if (print && !count_only) {
+                                 printf("%s%.*s", tokens > 0 ? "\t" : "", (int)word_len, word);
+                               }
+                               tokens++;
+                             });
+      if (print) {
+        if (count_only) {
+          printf("%ld", tokens);
+        }
+        printf("\n");
+      }
+      if (OBP_SUCCESS != ret) {
+        failed++;
+        if (print) {
+          fprintf(stderr, "document %zu: scan failed, ret=%d\n", d, ret);
+        }
+      }
+      total_tokens += tokens;
+      total_bytes += docs[d].second;
+    }
+  }
+  timespec end_ts;
+  clock_gettime(CLOCK_MONOTONIC, &end_ts);
+  const double elapsed = (double)(end_ts.tv_sec - begin_ts.tv_sec) + (double)(end_ts.tv_nsec - begin_ts.tv_nsec) / 1e9;
+  fprintf(stderr, "docs=%ld, bytes=%ld, tokens=%ld, failed=%ld, elapsed=%.3fs, %.2f MB/s\n",
+          (int64_t)docs.size() * repeat, total_bytes, total_tokens, failed, elapsed,
+          elapsed > 0 ? (double)total_bytes / elapsed / 1e6 : 0.0);
+  return 0 == failed ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright (c) 2025 OceanBase.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Reference server for the worker engine (OB_THAI_FTPARSER_ENGINE=worker).
+
+    thai_segment_worker.py /path/to/worker.sock
+
+Runs thai_tokenizer outside the observer, so a slow or crashing tokenizer
+cannot take the observer down with it. Protocol, see thai_ftparser_worker.h:
+request u32 LE length + UTF-8 text, response u32 LE length + tokens joined
+by '\\n'. One thread per connection; the plugin keeps one connection per
+observer thread.
+"""
+
+import os
+import socketserver
+import struct
+import sys
+
+import thai_tokenizer
+
+
+def recv_exact(sock, n):
+    buf = b""
+    while len(buf) < n:
+        chunk = sock.recv(n - len(buf))
+        if not chunk:
+            return None
+        buf += chunk
+    return buf
+
+
+class SegmentHandler(socketserver.BaseRequestHandler):
+    def handle(self):
+        # 每个连接一个分词器实例，不跨线程共享
+        tokenizer = thai_tokenizer.Tokenizer()
+        while True:
+            header = recv_exact(self.request, 4)
+            if header is None:
+                return
+            (length,) = struct.unpack("<I", header)
+            text = recv_exact(self.request, length)
+            if text is None:
+                return
+            tokens = tokenizer.split(text.decode("utf-8", errors="replace"))
+            body = "\n".join(t for t in tokens if t and "\n" not in t).encode("utf-8")
+            self.request.sendall(struct.pack("<I", len(body)) + body)
+
+
+class WorkerServer(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+    daemon_threads = True
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.stderr.write("usage: %s socket_path\n" % sys.argv[0])
+        return 2
+    path = sys.argv[1]
+    # 清理上次进程遗留的 socket 文件
+    if os.path.exists(path):
+        os.unlink(path)
+    with WorkerServer(path, SegmentHandler) as server:
+        server.serve_forever()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())